@@ -0,0 +1,428 @@
+// ///////////////////////////////////////////////////////////////////////////
+// bm_atlasbenchmark.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "bm_microbenchmark.hpp"
+
+#include <stdlib.h> // for rand() and srand()
+#include <string.h>
+#include <vector>
+
+#include "xrb_gltextureatlas.hpp"
+#include "xrb_gltextureatlasallocator.hpp"
+#include "xrb_math.hpp"
+#include "xrb_texture.hpp"
+
+using namespace std;
+using namespace Xrb;
+
+namespace Bm
+{
+
+namespace {
+
+// disasteroids' default gltexture atlas size
+ScreenCoordVector2 const gs_atlas_size(1024, 1024);
+// the asset set is packed this many times over (as if a game had this many
+// times as many textures), so that there are several full atlases to search.
+Uint32 const gs_asset_set_copy_count = 16;
+Uint32 const gs_pack_count = 5;
+// used when the disasteroids resources can't be found
+Uint32 const gs_synthetic_texture_count = 80;
+
+// the images disasteroids loads (see app/example/disasteroids).
+char const *const gs_asset_path[] =
+{
+    "fs://asteroid_small.png", "fs://button_center.png", "fs://button_left_black.png", "fs://button_left_blue.png",
+    "fs://button_left_green.png", "fs://button_right.png", "fs://demi_0.png", "fs://demi_1.png", "fs://demi_2.png",
+    "fs://demi_3.png", "fs://devourment_0.png", "fs://devourment_1.png", "fs://devourment_2.png", "fs://devourment_3.png",
+    "fs://explosion1a_small.png", "fs://explosion_dense_00.png", "fs://explosion_rock_00.png", "fs://fireball.png",
+    "fs://gauss_gun_trail.png", "fs://grenade.png", "fs://icon_armor.png", "fs://icon_engine.png",
+    "fs://icon_flame_thrower.png", "fs://icon_gauss_gun.png", "fs://icon_grenade_launcher.png", "fs://icon_laser.png",
+    "fs://icon_missile_launcher.png", "fs://icon_pea_shooter.png", "fs://icon_power_generator.png", "fs://icon_shield.png",
+    "fs://icon_tractor.png", "fs://interloper_0.png", "fs://interloper_1.png", "fs://interloper_2.png",
+    "fs://interloper_3.png", "fs://laser_beam.png", "fs://mineral_0.png", "fs://mineral_1.png", "fs://mineral_2.png",
+    "fs://mineral_3.png", "fs://missile.png", "fs://nebula00.png", "fs://nebulas/eta_carinae.png",
+    "fs://nebulas/planetary_nebula_NGC6751.png", "fs://nebulas/reflection_nebula.png",
+    "fs://nebulas/small_magellanic_cloud.png", "fs://planet_0.png", "fs://plasma_ball_green.png",
+    "fs://plasma_ball_yellow.png", "fs://powerup.png", "fs://radiobutton_black.png", "fs://radiobutton_blue.png",
+    "fs://radiobutton_green.png", "fs://radiobutton_yellow.png", "fs://reticle1.png", "fs://revulsion_0.png",
+    "fs://revulsion_1.png", "fs://revulsion_2.png", "fs://revulsion_3.png", "fs://shade_0.png", "fs://shade_1.png",
+    "fs://shade_2.png", "fs://shade_3.png", "fs://shockwave.png", "fs://solitary.png", "fs://solitary_small.png",
+    "fs://star0.png", "fs://star1.png", "fs://star2.png", "fs://star3.png", "fs://starfield/galaxy_small01.png",
+    "fs://starfield/galaxy_small02.png", "fs://starfield/galaxy_small03.png", "fs://starfield/galaxy_small04.png",
+    "fs://starfield/galaxy_small05.png", "fs://starfield/galaxy_small06.png", "fs://starfield/galaxy_small07.png",
+    "fs://starfield/galaxy_small08.png", "fs://starfield/galaxy_small09.png", "fs://starfield/galaxy_small10.png",
+    "fs://starfield00.png", "fs://tractor_beam.png"
+};
+Uint32 const gs_asset_path_count = LENGTHOF(gs_asset_path);
+
+// the search GlTextureAtlas::AttemptToPlaceTexture used to do -- test every
+// center against every placed texture, starting from the beginning each time.
+class ExhaustiveAtlasAllocator
+{
+public:
+
+    ExhaustiveAtlasAllocator (ScreenCoordVector2 const &atlas_size)
+        :
+        m_bounds(atlas_size),
+        m_candidate_test_count(0)
+    { }
+
+    Uint32 CandidateTestCount () const { return m_candidate_test_count; }
+
+    bool Allocate (ScreenCoord texture_size, ScreenCoordVector2 &center)
+    {
+        if (texture_size > m_bounds.AtlasSize()[Dim::X] || texture_size > m_bounds.AtlasSize()[Dim::Y])
+            return false;
+
+        ScreenCoordVector2 center_begin(m_bounds.CenterBegin(texture_size));
+        ScreenCoordVector2 center_end(m_bounds.CenterEnd(texture_size));
+        ScreenCoordVector2 candidate;
+        for (candidate[Dim::Y] = center_begin[Dim::Y]; candidate[Dim::Y] <= center_end[Dim::Y]; candidate[Dim::Y] += 2*texture_size)
+        {
+            for (candidate[Dim::X] = center_begin[Dim::X]; candidate[Dim::X] <= center_end[Dim::X]; candidate[Dim::X] += 2*texture_size)
+            {
+                ++m_candidate_test_count;
+                if (ThereIsEnoughSpaceFor(texture_size, candidate))
+                {
+                    m_center_vector.push_back(candidate);
+                    m_size_vector.push_back(texture_size);
+                    center = candidate;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+
+    bool ThereIsEnoughSpaceFor (ScreenCoord texture_size, ScreenCoordVector2 const &center) const
+    {
+        for (Uint32 i = 0; i < m_center_vector.size(); ++i)
+        {
+            ScreenCoord minimum_space_between = GlTextureAtlasAllocator::MinimumSpaceBetween(m_size_vector[i], texture_size);
+            if (Abs(m_center_vector[i][Dim::X] - center[Dim::X]) < minimum_space_between &&
+                Abs(m_center_vector[i][Dim::Y] - center[Dim::Y]) < minimum_space_between)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // only used for CenterBegin and CenterEnd
+    GlTextureAtlasAllocator m_bounds;
+    std::vector<ScreenCoordVector2> m_center_vector;
+    std::vector<ScreenCoord> m_size_vector;
+    Uint32 m_candidate_test_count;
+}; // end of class ExhaustiveAtlasAllocator
+
+struct PackResult
+{
+    // the atlas index and center of each texture, in order
+    std::vector<Uint32> m_atlas_index;
+    std::vector<ScreenCoordVector2> m_center;
+    Uint32 m_atlas_count;
+    Uint32 m_candidate_test_count;
+    double m_seconds;
+}; // end of struct PackResult
+
+// packs the textures the way Gl::CreateGlTexture does -- into the first
+// atlas with room, adding a new atlas when none has room.
+template <typename Allocator>
+void Pack (std::vector<ScreenCoord> const &texture_size, PackResult &result)
+{
+    result.m_seconds = 0.0;
+    for (Uint32 p = 0; p < gs_pack_count; ++p)
+    {
+        std::vector<Allocator *> atlas;
+        result.m_atlas_index.clear();
+        result.m_center.clear();
+
+        Stopwatch stopwatch;
+        for (Uint32 t = 0; t < texture_size.size(); ++t)
+        {
+            ScreenCoordVector2 center;
+            Uint32 a;
+            for (a = 0; a < atlas.size(); ++a)
+                if (atlas[a]->Allocate(texture_size[t], center))
+                    break;
+            if (a == atlas.size())
+            {
+                atlas.push_back(new Allocator(gs_atlas_size));
+                DEBUG1_CODE(bool allocated =)
+                atlas.back()->Allocate(texture_size[t], center);
+                ASSERT1(allocated);
+            }
+            result.m_atlas_index.push_back(a);
+            result.m_center.push_back(center);
+        }
+        result.m_seconds += stopwatch.ElapsedSeconds();
+
+        result.m_atlas_count = atlas.size();
+        result.m_candidate_test_count = 0;
+        for (Uint32 a = 0; a < atlas.size(); ++a)
+        {
+            result.m_candidate_test_count += atlas[a]->CandidateTestCount();
+            Delete(atlas[a]);
+        }
+    }
+}
+
+// the box filter Texture::CreateMipmap used to do, one component at a time.
+Texture *CreateMipmapScalar (Texture const &texture)
+{
+    ScreenCoordVector2 size(texture.Size()/2);
+    Texture *retval = Texture::Create(size, Texture::UNINITIALIZED);
+    for (ScreenCoord y = 0; y < size[Dim::Y]; ++y)
+    {
+        for (ScreenCoord x = 0; x < size[Dim::X]; ++x)
+        {
+            Uint32 v[4] = { 0, 0, 0, 0 };
+            for (ScreenCoord yoff = 0; yoff < 2; ++yoff)
+                for (ScreenCoord xoff = 0; xoff < 2; ++xoff)
+                    for (Uint32 color = 0; color < 4; ++color)
+                        v[color] += texture.Pixel(2*x+xoff, 2*y+yoff)[color];
+            for (Uint32 color = 0; color < 4; ++color)
+                retval->Pixel(x, y)[color] = v[color] / 4;
+        }
+    }
+    return retval;
+}
+
+Uint32 MismatchedByteCount (Texture const &texture0, Texture const &texture1)
+{
+    if (texture0.Size() != texture1.Size())
+        return Max(texture0.DataLength(), texture1.DataLength());
+    Uint32 retval = 0;
+    for (Uint32 i = 0; i < texture0.DataLength(); ++i)
+        if (texture0.Data()[i] != texture1.Data()[i])
+            ++retval;
+    return retval;
+}
+
+// keeps the pixels written into each mipmap level of an atlas
+class AtlasLevels : public GlTextureAtlas::PixelDestination
+{
+public:
+
+    AtlasLevels (ScreenCoordVector2 const &atlas_size)
+    {
+        for (Uint32 level = 0; level < GlTextureAtlas::MipmapLevelCount(atlas_size); ++level)
+            m_level.push_back(Texture::Create(GlTextureAtlas::MipmapLevelSize(atlas_size, level), Texture::CLEAR));
+    }
+    ~AtlasLevels ()
+    {
+        for (Uint32 level = 0; level < m_level.size(); ++level)
+            Delete(m_level[level]);
+    }
+
+    Texture const &Level (Uint32 mipmap_level) const { return *m_level[mipmap_level]; }
+
+    virtual void Write (Uint32 mipmap_level, ScreenCoordVector2 const &location, Texture const &pixels)
+    {
+        for (ScreenCoord y = 0; y < pixels.Height(); ++y)
+            memcpy(m_level[mipmap_level]->Pixel(location[Dim::X], location[Dim::Y] + y), pixels.Pixel(0, y), 4*pixels.Width());
+    }
+
+private:
+
+    std::vector<Texture *> m_level;
+}; // end of class AtlasLevels
+
+// counts the bytes around the given mipmap (centered at center) in the given
+// atlas level which differ from the mipmap with its edges extruded by 1 pixel.
+Uint32 MismatchedBorderedByteCount (Texture const &atlas_level, Texture const &mipmap, ScreenCoordVector2 const &center)
+{
+    Uint32 retval = 0;
+    ScreenCoordVector2 bottom_left(center - mipmap.Size()/2);
+    for (ScreenCoord y = -1; y <= mipmap.Height(); ++y)
+    {
+        for (ScreenCoord x = -1; x <= mipmap.Width(); ++x)
+        {
+            Uint8 const *expected = mipmap.Pixel(Min(Max(x, 0), mipmap.Width()-1), Min(Max(y, 0), mipmap.Height()-1));
+            Uint8 const *actual = atlas_level.Pixel(bottom_left[Dim::X] + x, bottom_left[Dim::Y] + y);
+            for (Uint32 color = 0; color < 4; ++color)
+                if (expected[color] != actual[color])
+                    ++retval;
+        }
+    }
+    return retval;
+}
+
+} // end of anonymous namespace
+
+void BenchmarkMipmapGeneration (std::ostream &out)
+{
+#if defined(__AVX2__)
+    out << "    Texture::CreateMipmap is using AVX2" << endl;
+#elif defined(__SSE2__)
+    out << "    Texture::CreateMipmap is using SSE2" << endl;
+#else
+    out << "    Texture::CreateMipmap is using the scalar fallback" << endl;
+#endif
+
+    // random pixels, so that every rounding case comes up
+    srand(1);
+    static ScreenCoord const s_texture_size[] = { 1024, 512, 256, 256, 128, 128, 64, 64, 64, 32, 32, 16, 8, 4, 2, 1 };
+    std::vector<Texture *> texture;
+    for (Uint32 i = 0; i < LENGTHOF(s_texture_size); ++i)
+    {
+        texture.push_back(Texture::Create(ScreenCoordVector2(s_texture_size[i], s_texture_size[i]), Texture::UNINITIALIZED));
+        for (Uint32 j = 0; j < texture.back()->DataLength(); ++j)
+            texture.back()->Data()[j] = rand();
+    }
+    // a non-square one too
+    texture.push_back(Texture::Create(ScreenCoordVector2(256, 32), Texture::UNINITIALIZED));
+    for (Uint32 j = 0; j < texture.back()->DataLength(); ++j)
+        texture.back()->Data()[j] = rand();
+
+    // generate the whole mipmap chain of each texture, both ways
+    Uint32 const chain_count = 10;
+    double scalar_seconds = 0.0;
+    double current_seconds = 0.0;
+    Uint32 level_count = 0;
+    Uint32 mismatch_count = 0;
+    for (Uint32 c = 0; c < chain_count; ++c)
+    {
+        for (Uint32 i = 0; i < texture.size(); ++i)
+        {
+            std::vector<Texture *> scalar_chain;
+            std::vector<Texture *> current_chain;
+            Stopwatch stopwatch;
+            for (Texture const *t = texture[i]; t->Width() > 1 && t->Height() > 1; t = scalar_chain.back())
+                scalar_chain.push_back(CreateMipmapScalar(*t));
+            scalar_seconds += stopwatch.ElapsedSeconds();
+            stopwatch.Start();
+            for (Texture const *t = texture[i]; t->Width() > 1 && t->Height() > 1; t = current_chain.back())
+                current_chain.push_back(t->CreateMipmap());
+            current_seconds += stopwatch.ElapsedSeconds();
+
+            ASSERT1(scalar_chain.size() == current_chain.size());
+            for (Uint32 level = 0; level < scalar_chain.size(); ++level)
+            {
+                mismatch_count += MismatchedByteCount(*scalar_chain[level], *current_chain[level]);
+                Delete(scalar_chain[level]);
+                Delete(current_chain[level]);
+            }
+            level_count += scalar_chain.size();
+        }
+    }
+    double const ms_per_set = 1.0e3 / chain_count;
+    out << "    " << texture.size() << " textures (" << level_count / chain_count << " mipmap levels), " << chain_count << " times" << endl;
+    out << "    scalar box filter: " << scalar_seconds * ms_per_set << " ms per set" << endl;
+    out << "    Texture::CreateMipmap: " << current_seconds * ms_per_set << " ms per set" << endl;
+    out << "    " << mismatch_count << " mismatched bytes (should be 0)" << endl;
+
+    // place the square textures in an atlas twice their size, centered where
+    // all their borders fit, and check every mipmap level and border.
+    double place_seconds = 0.0;
+    Uint32 border_mismatch_count = 0;
+    for (Uint32 i = 0; i < texture.size(); ++i)
+    {
+        if (texture[i]->Width() != texture[i]->Height() || texture[i]->Width() < 2)
+            continue;
+
+        ScreenCoordVector2 atlas_size(2*texture[i]->Size());
+        AtlasLevels atlas_levels(atlas_size);
+        Stopwatch stopwatch;
+        GlTextureAtlas::WriteMipmapsAndBorders(
+            atlas_size,
+            *texture[i],
+            texture[i]->Size(),
+            GlTextureAtlas::MipmapLevelCount(atlas_size),
+            atlas_levels);
+        place_seconds += stopwatch.ElapsedSeconds();
+
+        Texture *mipmap = CreateMipmapScalar(*texture[i]);
+        border_mismatch_count += MismatchedBorderedByteCount(atlas_levels.Level(0), *texture[i], texture[i]->Size());
+        for (Uint32 level = 1; mipmap->Width() > 1; ++level)
+        {
+            border_mismatch_count += MismatchedBorderedByteCount(atlas_levels.Level(level), *mipmap, texture[i]->Size() / (1 << level));
+            Texture *next_mipmap = CreateMipmapScalar(*mipmap);
+            Delete(mipmap);
+            mipmap = next_mipmap;
+        }
+        Delete(mipmap);
+    }
+    out << "    GlTextureAtlas::WriteMipmapsAndBorders (square textures): " << place_seconds * 1.0e3 << " ms, "
+        << border_mismatch_count << " mismatched mipmap/border bytes (should be 0)" << endl;
+
+    for (Uint32 i = 0; i < texture.size(); ++i)
+        Delete(texture[i]);
+}
+
+void BenchmarkAtlasPacking (std::ostream &out)
+{
+    // load the disasteroids images, keeping the sizes of the ones which go
+    // into shared atlases (the others get their own, so there's no packing).
+    std::vector<ScreenCoord> asset_size;
+    Uint32 loaded_count = 0;
+    Stopwatch stopwatch;
+    for (Uint32 i = 0; i < gs_asset_path_count; ++i)
+    {
+        Texture *texture = Texture::Create(gs_asset_path[i]);
+        if (texture == NULL)
+            continue;
+        ++loaded_count;
+        if (Math::IsAPowerOf2(texture->Width()) && texture->Width() == texture->Height() && texture->Width() <= gs_atlas_size[Dim::X])
+            asset_size.push_back(texture->Width());
+        Delete(texture);
+    }
+    double load_seconds = stopwatch.ElapsedSeconds();
+
+    if (asset_size.empty())
+    {
+        // sprites, icons and particles -- mostly small, a few big ones.
+        srand(1);
+        static ScreenCoord const s_synthetic_size[] = { 16, 32, 32, 64, 64, 64, 128, 128, 256 };
+        for (Uint32 i = 0; i < gs_synthetic_texture_count; ++i)
+            asset_size.push_back(s_synthetic_size[rand() % LENGTHOF(s_synthetic_size)]);
+        out << "    disasteroids resources not found (run from the directory containing its resources/ directory)," << endl;
+        out << "    so " << gs_synthetic_texture_count << " synthetic texture sizes are used instead" << endl;
+    }
+    else
+    {
+        out << "    loaded " << loaded_count << " of " << gs_asset_path_count << " disasteroids images in "
+            << load_seconds * 1.0e3 << " ms (" << asset_size.size() << " of them go into shared atlases)" << endl;
+    }
+
+    std::vector<ScreenCoord> texture_size;
+    for (Uint32 c = 0; c < gs_asset_set_copy_count; ++c)
+        texture_size.insert(texture_size.end(), asset_size.begin(), asset_size.end());
+
+    PackResult exhaustive;
+    PackResult allocator;
+    Pack<ExhaustiveAtlasAllocator>(texture_size, exhaustive);
+    Pack<GlTextureAtlasAllocator>(texture_size, allocator);
+
+    Uint32 mismatch_count = 0;
+    for (Uint32 t = 0; t < texture_size.size(); ++t)
+        if (exhaustive.m_atlas_index[t] != allocator.m_atlas_index[t] || exhaustive.m_center[t] != allocator.m_center[t])
+            ++mismatch_count;
+
+    Uint64 used_pixel_count = 0;
+    for (Uint32 t = 0; t < texture_size.size(); ++t)
+        used_pixel_count += Uint64(texture_size[t]) * texture_size[t];
+    Uint64 atlas_pixel_count = Uint64(allocator.m_atlas_count) * gs_atlas_size[Dim::X] * gs_atlas_size[Dim::Y];
+
+    double const ms_per_pack = 1.0e3 / gs_pack_count;
+    out << "    " << texture_size.size() << " textures (" << gs_asset_set_copy_count << " copies of the set) in "
+        << allocator.m_atlas_count << ' ' << gs_atlas_size[Dim::X] << 'x' << gs_atlas_size[Dim::Y] << " atlases, "
+        << 100 * used_pixel_count / Max(atlas_pixel_count, Uint64(1)) << "% packing efficiency (level 0)" << endl;
+    out << "    exhaustive search: " << exhaustive.m_seconds * ms_per_pack << " ms per pack, "
+        << exhaustive.m_candidate_test_count << " centers tested" << endl;
+    out << "    GlTextureAtlasAllocator: " << allocator.m_seconds * ms_per_pack << " ms per pack, "
+        << allocator.m_candidate_test_count << " centers tested" << endl;
+    out << "    " << mismatch_count << " textures placed differently (should be 0)" << endl;
+}
+
+} // end of namespace Bm
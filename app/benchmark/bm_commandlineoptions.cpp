@@ -35,6 +35,13 @@ CommandLineOption const CommandLineOptions::ms_option[] =
         "    Set the screen resolution.  The argument must be of the form 123x456,\n"
         "    where the first value is width, and the second is height.  The default\n"
         "    value is 1024x768.  See also option -f."),
+    CommandLineOption(
+        'v',
+        "vertex-buffer",
+        &CommandLineOptions::SetVertexBuffer,
+        "    Indicates if vertex data will be streamed to openGL through a vertex\n"
+        "    buffer object (if supported) instead of being read out of client memory.\n"
+        "    The argument must be either 1 or 0.  The default value is 0."),
     CommandLineOption("Keyboard options"),
     CommandLineOption(
         'k',
@@ -44,6 +51,15 @@ CommandLineOption const CommandLineOptions::ms_option[] =
         "    support alternate keyboard layouts (this option is unnecessary in other\n"
         "    operating systems).  Valid values are: \"dvorak\" (quotes for clarity).\n"
         "    Anything else will disable altered key mapping (this is the default)."),
+    CommandLineOption("Microbenchmark options"),
+    CommandLineOption(
+        'm',
+        "microbenchmark",
+        &CommandLineOptions::SetMicrobenchmarkName,
+        "    Runs the named headless microbenchmark (no video mode is set), prints\n"
+        "    its results, and exits.  The argument \"all\" (quotes for clarity)\n"
+        "    runs every microbenchmark.  Specifying an invalid name will print\n"
+        "    the list of valid names."),
     CommandLineOption(""),
     CommandLineOption(
         'h',
@@ -64,7 +80,9 @@ CommandLineOptions::CommandLineOptions (std::string const &executable_path)
         "[options]"),
     m_fullscreen(true),
     m_resolution(ScreenCoordVector2::ms_zero),
+    m_vertex_buffer(false),
     m_key_map_name("none"),
+    m_microbenchmark_name(),
     m_is_help_requested(false)
 { }
 
@@ -102,6 +120,14 @@ void CommandLineOptions::SetResolution (string const &arg)
     m_resolution = resolution;
 }
 
+void CommandLineOptions::SetVertexBuffer (string const &arg)
+{
+    if (arg.length() != 1 || (arg[0] != '0' && arg[0] != '1'))
+        throw string("error: invalid argument to --vertex-buffer - \"") + arg + "\"";
+    else
+        m_vertex_buffer = arg[0] == '1';
+}
+
 void CommandLineOptions::SetKeyMapName (std::string const &arg)
 {
     if (arg.empty())
@@ -110,6 +136,14 @@ void CommandLineOptions::SetKeyMapName (std::string const &arg)
     m_key_map_name = arg;
 }
 
+void CommandLineOptions::SetMicrobenchmarkName (std::string const &arg)
+{
+    if (arg.empty())
+        throw string("error: invalid argument to --microbenchmark - \"") + arg + "\"";
+
+    m_microbenchmark_name = arg;
+}
+
 void CommandLineOptions::NonOptionArgumentHandler (std::string const &arg)
 {
     throw string("error: invalid non-option argument - \"") + arg + "\"";
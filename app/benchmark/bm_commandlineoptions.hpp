@@ -32,14 +32,19 @@ public:
 
     inline bool Fullscreen () const { return m_fullscreen; }
     inline ScreenCoordVector2 const &Resolution () const { return m_resolution; }
+    inline bool VertexBuffer () const { return m_vertex_buffer; }
     inline std::string const &KeyMapName () const { return m_key_map_name; }
+    inline bool IsMicrobenchmarkRequested () const { return !m_microbenchmark_name.empty(); }
+    inline std::string const &MicrobenchmarkName () const { return m_microbenchmark_name; }
     inline bool IsHelpRequested () const { return m_is_help_requested; }
 
 private:
 
     void SetFullscreen (std::string const &arg);
     void SetResolution (std::string const &arg);
+    void SetVertexBuffer (std::string const &arg);
     void SetKeyMapName (std::string const &arg);
+    void SetMicrobenchmarkName (std::string const &arg);
 
     void NonOptionArgumentHandler (std::string const &arg);
     void RequestHelp ();
@@ -49,7 +54,9 @@ private:
 
     bool m_fullscreen;
     ScreenCoordVector2 m_resolution;
+    bool m_vertex_buffer;
     std::string m_key_map_name;
+    std::string m_microbenchmark_name;
 
     bool m_is_help_requested;
 }; // end of class CommandLineOptions
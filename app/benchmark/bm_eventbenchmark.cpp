@@ -0,0 +1,438 @@
+// ///////////////////////////////////////////////////////////////////////////
+// bm_eventbenchmark.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "bm_microbenchmark.hpp"
+
+#include <set>
+#include <vector>
+
+#include "xrb_event.hpp"
+#include "xrb_eventhandler.hpp"
+#include "xrb_eventqueue.hpp"
+#include "xrb_input_events.hpp"
+
+using namespace std;
+using namespace Xrb;
+
+namespace Bm
+{
+
+namespace {
+
+Uint32 const gs_pending_event_count = 100000;
+// the initial events are spread over this many seconds (some of them past
+// the end of the run, so they're still pending at the end).
+Float const gs_event_time_span = 20.0f;
+Float const gs_frame_duration = 1.0f / 60.0f;
+Uint32 const gs_frame_count = 600;
+// every this many frames, the events of one custom type are cancelled
+// (like World::CancelScheduledStateMachineInput does).
+Uint32 const gs_cancel_period = 60;
+Uint32 const gs_custom_type_count = 16;
+
+class BenchmarkEvent : public EventCustom
+{
+public:
+
+    BenchmarkEvent (Uint32 serial, Time time) : EventCustom(serial % gs_custom_type_count, time), m_serial(serial) { }
+    virtual ~BenchmarkEvent () { }
+
+    Uint32 Serial () const { return m_serial; }
+
+private:
+
+    Uint32 const m_serial;
+}; // end of class BenchmarkEvent
+
+class MultisetEventQueue;
+
+// records the order the events are processed in, and enqueues a new event
+// for each one processed (so the number of pending events stays steady).
+class BenchmarkEventHandler : public EventHandler
+{
+public:
+
+    BenchmarkEventHandler (EventQueue *owner_event_queue, MultisetEventQueue *multiset_event_queue)
+        :
+        EventHandler(owner_event_queue),
+        m_multiset_event_queue(multiset_event_queue),
+        m_random_state(1),
+        m_next_serial(0),
+        m_processed_serial_hash(5381),
+        m_processed_count(0)
+    { }
+
+    Uint32 ProcessedSerialHash () const { return m_processed_serial_hash; }
+    Uint32 ProcessedCount () const { return m_processed_count; }
+
+    // enqueues an event at the given time plus a random delay
+    void EnqueueRandomEvent (Time time);
+
+protected:
+
+    virtual bool HandleEvent (Event const &e)
+    {
+        Uint32 serial = static_cast<BenchmarkEvent const &>(e).Serial();
+        m_processed_serial_hash = m_processed_serial_hash*33 + serial;
+        ++m_processed_count;
+        EnqueueRandomEvent(e.GetTime());
+        return true;
+    }
+
+private:
+
+    // deterministic, so that both queues get the same events
+    Float RandomDelay ()
+    {
+        m_random_state = m_random_state*1664525 + 1013904223;
+        return gs_event_time_span * Float(m_random_state >> 8) / Float(1 << 24);
+    }
+
+    MultisetEventQueue *m_multiset_event_queue;
+    Uint32 m_random_state;
+    Uint32 m_next_serial;
+    Uint32 m_processed_serial_hash;
+    Uint32 m_processed_count;
+}; // end of class BenchmarkEventHandler
+
+// the std::multiset-based queue EventQueue used to be -- one tree insert per
+// buffered event per frame.  it has its own IDs and deletion flags (those in
+// Event are private to EventQueue).
+class MultisetEventQueue
+{
+public:
+
+    MultisetEventQueue () : m_current_event_id(0) { }
+    ~MultisetEventQueue ()
+    {
+        EnqueueBufferedEvents();
+        for (BindingSet::iterator it = m_queue.begin(), it_end = m_queue.end(); it != it_end; ++it)
+            delete it->m_event;
+    }
+
+    void EnqueueEvent (EventHandler &event_handler, Event const *event)
+    {
+        m_buffered_queue.insert(Binding(&event_handler, event, m_current_event_id++));
+    }
+    void ScheduleMatchingEventsForDeletion (bool (*EventMatchingFunction)(Event const &, EventCustom::CustomType), EventCustom::CustomType custom_type)
+    {
+        ScheduleMatchingEventsForDeletion(m_queue, EventMatchingFunction, custom_type);
+        ScheduleMatchingEventsForDeletion(m_buffered_queue, EventMatchingFunction, custom_type);
+    }
+    // the original full-queue scan
+    void DeleteEventsBelongingToHandler (EventHandler &event_handler)
+    {
+        DeleteEventsBelongingToHandler(m_queue, event_handler);
+        DeleteEventsBelongingToHandler(m_buffered_queue, event_handler);
+    }
+    void ProcessFrame (Time frame_time)
+    {
+        EnqueueBufferedEvents();
+        BindingSet::iterator it_end = m_queue.upper_bound(Binding(frame_time));
+        for (BindingSet::iterator it = m_queue.begin(); it != it_end; ++it)
+        {
+            if (!it->m_is_scheduled_for_deletion)
+            {
+                it->m_event_handler->ProcessEvent(*it->m_event);
+                it->m_is_scheduled_for_deletion = true;
+            }
+        }
+        for (BindingSet::iterator it = m_queue.begin(); it != it_end; ++it)
+            delete it->m_event;
+        m_queue.erase(m_queue.begin(), it_end);
+    }
+
+private:
+
+    struct Binding
+    {
+        EventHandler *m_event_handler;
+        Event const *m_event;
+        Time m_time;
+        Uint32 m_id;
+        mutable bool m_is_scheduled_for_deletion;
+
+        Binding (EventHandler *event_handler, Event const *event, Uint32 id)
+            :
+            m_event_handler(event_handler),
+            m_event(event),
+            m_time(event->GetTime()),
+            m_id(id),
+            m_is_scheduled_for_deletion(false)
+        { }
+        // the last possible binding at the given time
+        Binding (Time time)
+            :
+            m_event_handler(NULL),
+            m_event(NULL),
+            m_time(time),
+            m_id(UINT32_UPPER_BOUND),
+            m_is_scheduled_for_deletion(false)
+        { }
+
+        bool operator < (Binding const &binding) const
+        {
+            return m_time < binding.m_time || (m_time == binding.m_time && m_id < binding.m_id);
+        }
+    }; // end of struct MultisetEventQueue::Binding
+
+    typedef std::multiset<Binding> BindingSet;
+
+    void EnqueueBufferedEvents ()
+    {
+        m_queue.insert(m_buffered_queue.begin(), m_buffered_queue.end());
+        m_buffered_queue.clear();
+    }
+    static void ScheduleMatchingEventsForDeletion (
+        BindingSet &binding_set,
+        bool (*EventMatchingFunction)(Event const &, EventCustom::CustomType),
+        EventCustom::CustomType custom_type)
+    {
+        for (BindingSet::iterator it = binding_set.begin(), it_end = binding_set.end(); it != it_end; ++it)
+            if (!it->m_is_scheduled_for_deletion && EventMatchingFunction(*it->m_event, custom_type))
+                it->m_is_scheduled_for_deletion = true;
+    }
+
+    static void DeleteEventsBelongingToHandler (BindingSet &binding_set, EventHandler &event_handler)
+    {
+        for (BindingSet::iterator it = binding_set.begin(), it_end = binding_set.end(); it != it_end; ++it)
+            if (it->m_event_handler == &event_handler)
+                it->m_is_scheduled_for_deletion = true;
+    }
+
+    BindingSet m_queue;
+    BindingSet m_buffered_queue;
+    Uint32 m_current_event_id;
+}; // end of class MultisetEventQueue
+
+void BenchmarkEventHandler::EnqueueRandomEvent (Time time)
+{
+    Event const *event = new BenchmarkEvent(m_next_serial++, time + RandomDelay());
+    if (m_multiset_event_queue != NULL)
+        m_multiset_event_queue->EnqueueEvent(*this, event);
+    else
+        EnqueueEvent(event);
+}
+
+struct EventQueueResult
+{
+    double m_enqueue_seconds;
+    double m_frame_seconds;
+    double m_cancel_seconds;
+    Uint32 m_processed_count;
+    Uint32 m_processed_serial_hash;
+}; // end of struct EventQueueResult
+
+// fills the queue with gs_pending_event_count events, then runs
+// gs_frame_count frames, cancelling a custom type every gs_cancel_period frames.
+template <typename Queue>
+void RunEventQueue (Queue &queue, BenchmarkEventHandler &event_handler, EventQueueResult &result)
+{
+    Stopwatch stopwatch;
+    for (Uint32 i = 0; i < gs_pending_event_count; ++i)
+        event_handler.EnqueueRandomEvent(Time::ms_beginning_of);
+    result.m_enqueue_seconds = stopwatch.ElapsedSeconds();
+
+    result.m_frame_seconds = 0.0;
+    result.m_cancel_seconds = 0.0;
+    for (Uint32 frame = 1; frame <= gs_frame_count; ++frame)
+    {
+        if (frame % gs_cancel_period == 0)
+        {
+            stopwatch.Start();
+            queue.ScheduleMatchingEventsForDeletion(MatchCustomType, EventCustom::CustomType(frame / gs_cancel_period % gs_custom_type_count));
+            result.m_cancel_seconds += stopwatch.ElapsedSeconds();
+        }
+        stopwatch.Start();
+        queue.ProcessFrame(Time::ms_beginning_of + frame * gs_frame_duration);
+        result.m_frame_seconds += stopwatch.ElapsedSeconds();
+    }
+    result.m_processed_count = event_handler.ProcessedCount();
+    result.m_processed_serial_hash = event_handler.ProcessedSerialHash();
+}
+
+// for the event cancellation benchmark -- every other handler is deleted
+// (like the entities in a wave clear), and then the rest run for a while.
+Uint32 const gs_cancellation_handler_count = 2000;
+Uint32 const gs_cancellation_events_per_handler = 50;
+
+struct EventCancellationResult
+{
+    double m_deletion_seconds;
+    Uint32 m_processed_count;
+    Uint32 m_processed_serial_hash;
+}; // end of struct EventCancellationResult
+
+// if multiset_event_queue is NULL, the handlers use event_queue (and their
+// destructors delete their events from it).
+void RunEventCancellation (EventQueue &event_queue, MultisetEventQueue *multiset_event_queue, EventCancellationResult &result)
+{
+    std::vector<BenchmarkEventHandler *> event_handler_vector(gs_cancellation_handler_count);
+    for (Uint32 h = 0; h < gs_cancellation_handler_count; ++h)
+    {
+        event_handler_vector[h] = new BenchmarkEventHandler(multiset_event_queue != NULL ? NULL : &event_queue, multiset_event_queue);
+        for (Uint32 i = 0; i < gs_cancellation_events_per_handler; ++i)
+            event_handler_vector[h]->EnqueueRandomEvent(Time::ms_beginning_of);
+    }
+
+    Stopwatch stopwatch;
+    for (Uint32 h = 0; h < gs_cancellation_handler_count; h += 2)
+    {
+        if (multiset_event_queue != NULL)
+            multiset_event_queue->DeleteEventsBelongingToHandler(*event_handler_vector[h]);
+        DeleteAndNullify(event_handler_vector[h]);
+    }
+    result.m_deletion_seconds = stopwatch.ElapsedSeconds();
+
+    for (Uint32 frame = 1; frame <= gs_frame_count; ++frame)
+    {
+        Time frame_time(Time::ms_beginning_of + frame * gs_frame_duration);
+        if (multiset_event_queue != NULL)
+            multiset_event_queue->ProcessFrame(frame_time);
+        else
+            event_queue.ProcessFrame(frame_time);
+    }
+
+    result.m_processed_count = 0;
+    result.m_processed_serial_hash = 0;
+    for (Uint32 h = 0; h < gs_cancellation_handler_count; ++h)
+    {
+        if (event_handler_vector[h] == NULL)
+            continue;
+        result.m_processed_count += event_handler_vector[h]->ProcessedCount();
+        result.m_processed_serial_hash = result.m_processed_serial_hash*31 + event_handler_vector[h]->ProcessedSerialHash();
+        if (multiset_event_queue != NULL)
+            multiset_event_queue->DeleteEventsBelongingToHandler(*event_handler_vector[h]);
+        DeleteAndNullify(event_handler_vector[h]);
+    }
+}
+
+// for the event allocation benchmark -- a mouse motion flood, with the
+// occasional key event, all deleted at the end of each frame.
+Uint32 const gs_allocation_frame_count = 1000;
+Uint32 const gs_allocation_events_per_frame = 1000;
+
+// creates a frame's worth of events with the class operator new (i.e. from
+// EventPool) or the global one, and deletes them the same way.
+template <bool use_event_pool>
+double RunEventAllocation ()
+{
+    std::vector<Event const *> event_vector;
+    event_vector.reserve(gs_allocation_events_per_frame);
+    Stopwatch stopwatch;
+    for (Uint32 frame = 0; frame < gs_allocation_frame_count; ++frame)
+    {
+        Time time(frame * gs_frame_duration);
+        for (Uint32 i = 0; i < gs_allocation_events_per_frame; ++i)
+        {
+            ScreenCoordVector2 position(i, frame);
+            if (i % 16 == 0)
+                event_vector.push_back(
+                    use_event_pool ?
+                    new EventKeyDown(Key::LEFTMOUSE, Key::MOD_NONE, time) :
+                    ::new EventKeyDown(Key::LEFTMOUSE, Key::MOD_NONE, time));
+            else
+                event_vector.push_back(
+                    use_event_pool ?
+                    new EventMouseMotion(false, false, false, position, ScreenCoordVector2(1, 0), Key::MOD_NONE, time) :
+                    ::new EventMouseMotion(false, false, false, position, ScreenCoordVector2(1, 0), Key::MOD_NONE, time));
+        }
+        for (std::vector<Event const *>::iterator it = event_vector.begin(), it_end = event_vector.end(); it != it_end; ++it)
+        {
+            if (use_event_pool)
+                delete *it;
+            else
+                ::delete *it;
+        }
+        event_vector.clear();
+    }
+    return stopwatch.ElapsedSeconds();
+}
+
+} // end of anonymous namespace
+
+void BenchmarkEventQueue (std::ostream &out)
+{
+    EventQueueResult multiset_result;
+    {
+        MultisetEventQueue queue;
+        BenchmarkEventHandler event_handler(NULL, &queue);
+        RunEventQueue(queue, event_handler, multiset_result);
+    }
+    EventQueueResult wheel_result;
+    {
+        EventQueue queue;
+        BenchmarkEventHandler event_handler(&queue, NULL);
+        RunEventQueue(queue, event_handler, wheel_result);
+    }
+
+    double const ms_per_frame = 1.0e3 / gs_frame_count;
+    double const ms_per_cancel = 1.0e3 * gs_cancel_period / gs_frame_count;
+    out << "    " << gs_pending_event_count << " pending events, " << gs_frame_count << " frames, "
+        << wheel_result.m_processed_count << " events processed" << endl;
+    out << "    std::multiset: " << multiset_result.m_enqueue_seconds * 1.0e3 << " ms to enqueue, "
+        << multiset_result.m_frame_seconds * ms_per_frame << " ms per frame, "
+        << multiset_result.m_cancel_seconds * ms_per_cancel << " ms per cancellation" << endl;
+    out << "    EventQueue (timing wheel): " << wheel_result.m_enqueue_seconds * 1.0e3 << " ms to enqueue, "
+        << wheel_result.m_frame_seconds * ms_per_frame << " ms per frame, "
+        << wheel_result.m_cancel_seconds * ms_per_cancel << " ms per cancellation" << endl;
+    out << "    processing order "
+        << (multiset_result.m_processed_count == wheel_result.m_processed_count &&
+            multiset_result.m_processed_serial_hash == wheel_result.m_processed_serial_hash ?
+            "matches" : "DOES NOT MATCH")
+        << endl;
+}
+
+void BenchmarkEventCancellation (std::ostream &out)
+{
+    EventCancellationResult multiset_result;
+    {
+        EventQueue unused_event_queue;
+        MultisetEventQueue queue;
+        RunEventCancellation(unused_event_queue, &queue, multiset_result);
+    }
+    EventCancellationResult indexed_result;
+    {
+        EventQueue queue;
+        RunEventCancellation(queue, NULL, indexed_result);
+    }
+
+    double const us_per_handler = 1.0e6 / (gs_cancellation_handler_count / 2);
+    out << "    " << gs_cancellation_handler_count << " handlers with " << gs_cancellation_events_per_handler
+        << " pending events each, deleting every other handler" << endl;
+    out << "    full-queue scan: " << multiset_result.m_deletion_seconds * us_per_handler << " us per handler" << endl;
+    out << "    per-handler list: " << indexed_result.m_deletion_seconds * us_per_handler << " us per handler" << endl;
+    out << "    " << indexed_result.m_processed_count << " events processed afterward, "
+        << (multiset_result.m_processed_count == indexed_result.m_processed_count &&
+            multiset_result.m_processed_serial_hash == indexed_result.m_processed_serial_hash ?
+            "matches" : "DOES NOT MATCH")
+        << endl;
+}
+
+void BenchmarkEventAllocation (std::ostream &out)
+{
+    EventPool::Statistics before(EventPool::GetStatistics());
+    double pool_seconds = RunEventAllocation<true>();
+    EventPool::Statistics after(EventPool::GetStatistics());
+    double heap_seconds = RunEventAllocation<false>();
+
+    double const ns_per_event = 1.0e9 / (gs_allocation_frame_count * gs_allocation_events_per_frame);
+    out << "    " << gs_allocation_frame_count << " frames of " << gs_allocation_events_per_frame
+        << " events (EventMouseMotion is " << sizeof(EventMouseMotion) << " bytes)" << endl;
+    out << "    global heap: " << heap_seconds * ns_per_event << " ns per event" << endl;
+    out << "    EventPool: " << pool_seconds * ns_per_event << " ns per event, "
+        << after.m_pooled_allocation_count - before.m_pooled_allocation_count << " pooled allocations, "
+        << after.m_chunk_allocation_count - before.m_chunk_allocation_count << " chunk allocations, "
+        << after.m_oversize_allocation_count - before.m_oversize_allocation_count << " oversize allocations, "
+        << after.m_peak_blocks_in_use << " peak blocks in use, "
+        << after.m_blocks_in_use << " still in use" << endl;
+}
+
+} // end of namespace Bm
@@ -13,6 +13,8 @@
 #include "bm_commandlineoptions.hpp"
 #include "bm_config.hpp"
 #include "bm_master.hpp"
+#include "bm_microbenchmark.hpp"
+#include "xrb_gl.hpp"
 #include "xrb_screen.hpp"
 #include "xrb_sdlpal.hpp"
 
@@ -64,8 +66,23 @@ int main (int argc, char **argv)
         if (Singleton::Pal().Initialize() != Pal::SUCCESS)
             return 1;
 
+        // microbenchmarks are headless, so run them before creating the screen.
+        if (options.IsMicrobenchmarkRequested())
+        {
+            if (!Bm::RunMicrobenchmark(options.MicrobenchmarkName(), cout))
+            {
+                cerr << "error: invalid microbenchmark name \"" << options.MicrobenchmarkName() << "\"" << endl;
+                Bm::PrintMicrobenchmarkNames(cerr);
+                return 1;
+            }
+            return 0;
+        }
+
         Singleton::Pal().SetWindowCaption("XRB Benchmark");
 
+        // this has to be decided before the Gl singleton is initialized
+        Gl::RequestVertexArrayMode(options.VertexBuffer() ? Gl::VAM_STREAMING_BUFFER : Gl::VAM_CLIENT_ARRAYS);
+
         // init the screen
         Screen *screen = Screen::Create(
             options.Resolution()[Dim::X],
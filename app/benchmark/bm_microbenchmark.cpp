@@ -0,0 +1,148 @@
+// ///////////////////////////////////////////////////////////////////////////
+// bm_microbenchmark.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "bm_microbenchmark.hpp"
+
+#include "xrb_pal.hpp"
+#include "xrb_singleton.hpp"
+
+using namespace std;
+using namespace Xrb;
+
+namespace Bm
+{
+
+namespace {
+
+struct Microbenchmark
+{
+    char const *m_name;
+    MicrobenchmarkFunction m_function;
+    char const *m_description;
+}; // end of struct Microbenchmark
+
+Microbenchmark const gs_microbenchmark[] =
+{
+    {
+        "physics-broadphase",
+        BenchmarkPhysicsBroadPhase,
+        "Circle::PhysicsHandler quadtree vs sort-and-sweep broad phase"
+    },
+    {
+        "physics-integration",
+        BenchmarkPhysicsIntegration,
+        "Circle::PhysicsHandler per-entity vs packed velocity/position integration"
+    },
+    {
+        "physics-ccd",
+        BenchmarkPhysicsContinuousCollision,
+        "Circle::PhysicsHandler hits on small targets by fast entities, with and without continuous collision"
+    },
+    {
+        "physics-traces",
+        BenchmarkPhysicsTraces,
+        "Circle::PhysicsHandler AreaTrace/LineTrace into std::list/std::set vs reused std::vector"
+    },
+    {
+        "quadtree",
+        BenchmarkQuadTree,
+        "QuadTree add/remove/re-add throughput"
+    },
+    {
+        "quadtree-bound-factor",
+        BenchmarkQuadTreeBoundFactor,
+        "objects tested per QuadTree area query, at several bound factors (loose quadtrees)"
+    },
+    {
+        "quadtree-adaptive",
+        BenchmarkQuadTreeAdaptive,
+        "fixed-depth vs adaptive QuadTree node counts and objects tested per area query"
+    },
+    {
+        "draw-sort",
+        BenchmarkDrawObjectSort,
+        "sorting 20000 draw objects with qsort and DrawObject::Compare vs DrawObjectCollector's radix sort"
+    },
+    {
+        "atlas-packing",
+        BenchmarkAtlasPacking,
+        "packing the disasteroids images into gltexture atlases, exhaustive search vs GlTextureAtlasAllocator"
+    },
+    {
+        "mipmaps",
+        BenchmarkMipmapGeneration,
+        "Texture::CreateMipmap vs the original scalar box filter, and GlTextureAtlas mipmap/border correctness"
+    },
+    {
+        "event-queue",
+        BenchmarkEventQueue,
+        "100k pending events, std::multiset vs EventQueue's timing wheel (with a processing order check)"
+    },
+    {
+        "event-cancellation",
+        BenchmarkEventCancellation,
+        "deleting EventHandlers with pending events, full-queue scan vs per-handler lists (with a check)"
+    },
+    {
+        "event-allocation",
+        BenchmarkEventAllocation,
+        "creating and deleting a mouse motion flood of events, global heap vs EventPool"
+    },
+    {
+        "serializer",
+        BenchmarkSerializer,
+        "writing and loading 200k objects, BinaryFileSerializer vs BufferedFileSerializer/MemoryMappedSerializer"
+    },
+    {
+        "serializer-arrays",
+        BenchmarkSerializerArrays,
+        "byte-order switching and reading 1M Compound vertices, per word/vertex vs bulk (with a check)"
+    }
+};
+Uint32 const gs_microbenchmark_count = LENGTHOF(gs_microbenchmark);
+
+} // end of anonymous namespace
+
+bool RunMicrobenchmark (std::string const &name, std::ostream &out)
+{
+    bool found = false;
+    for (Uint32 i = 0; i < gs_microbenchmark_count; ++i)
+    {
+        if (name != "all" && name != gs_microbenchmark[i].m_name)
+            continue;
+
+        out << "microbenchmark \"" << gs_microbenchmark[i].m_name << "\" - " << gs_microbenchmark[i].m_description << endl;
+        gs_microbenchmark[i].m_function(out);
+        out << endl;
+        found = true;
+    }
+    return found;
+}
+
+void PrintMicrobenchmarkNames (std::ostream &out)
+{
+    out << "valid microbenchmark names are:" << endl;
+    out << "    all - runs all of the following" << endl;
+    for (Uint32 i = 0; i < gs_microbenchmark_count; ++i)
+        out << "    " << gs_microbenchmark[i].m_name << " - " << gs_microbenchmark[i].m_description << endl;
+}
+
+void Stopwatch::Start ()
+{
+    m_start_time = Singleton::Pal().CurrentTime();
+}
+
+double Stopwatch::ElapsedSeconds () const
+{
+    return Singleton::Pal().CurrentTime().AsDouble() - m_start_time.AsDouble();
+}
+
+} // end of namespace Bm
+
@@ -0,0 +1,93 @@
+// ///////////////////////////////////////////////////////////////////////////
+// bm_microbenchmark.hpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#if !defined(_BM_MICROBENCHMARK_HPP_)
+#define _BM_MICROBENCHMARK_HPP_
+
+#include "xrb.hpp"
+
+#include <ostream>
+#include <string>
+
+#include "xrb_time.hpp"
+
+using namespace Xrb;
+
+namespace Bm
+{
+
+// microbenchmarks are headless (no Screen is created) timing tests of
+// individual engine subsystems.  each one writes a human-readable report
+// of its results to the given stream.
+typedef void (*MicrobenchmarkFunction) (std::ostream &out);
+
+// runs the microbenchmark with the given name, or all of them if name is
+// "all".  returns false if there is no such microbenchmark.
+bool RunMicrobenchmark (std::string const &name, std::ostream &out);
+// prints the names (and descriptions) of all microbenchmarks
+void PrintMicrobenchmarkNames (std::ostream &out);
+
+// measures wall-clock time using Singleton::Pal().CurrentTime().
+class Stopwatch
+{
+public:
+
+    Stopwatch () { Start(); }
+
+    // restarts the stopwatch at zero
+    void Start ();
+    // returns the number of seconds since Start was last called
+    double ElapsedSeconds () const;
+
+private:
+
+    Time m_start_time;
+}; // end of class Stopwatch
+
+// ///////////////////////////////////////////////////////////////////////////
+// the microbenchmarks themselves (each is defined in the bm_*benchmark.cpp
+// file for its subsystem).
+// ///////////////////////////////////////////////////////////////////////////
+
+// compares the Circle::PhysicsHandler broad-phase algorithms (see BroadPhase)
+void BenchmarkPhysicsBroadPhase (std::ostream &out);
+// compares Circle::PhysicsHandler per-entity and packed integration
+void BenchmarkPhysicsIntegration (std::ostream &out);
+// compares fast entities with and without continuous collision
+void BenchmarkPhysicsContinuousCollision (std::ostream &out);
+// compares the allocating and reusable-buffer AreaTrace/LineTrace overloads
+void BenchmarkPhysicsTraces (std::ostream &out);
+// measures QuadTree add/remove/re-add throughput
+void BenchmarkQuadTree (std::ostream &out);
+// measures the objects tested per area query at several QuadTree bound factors
+void BenchmarkQuadTreeBoundFactor (std::ostream &out);
+// compares fixed-depth and adaptive QuadTrees on uniform and clustered objects
+void BenchmarkQuadTreeAdaptive (std::ostream &out);
+// compares qsort with DrawObject::Compare to DrawObjectCollector's radix sort
+void BenchmarkDrawObjectSort (std::ostream &out);
+// compares GlTextureAtlasAllocator with the original exhaustive atlas search on the disasteroids images
+void BenchmarkAtlasPacking (std::ostream &out);
+// compares Texture::CreateMipmap with the original scalar box filter, and checks the mipmaps and borders GlTextureAtlas writes
+void BenchmarkMipmapGeneration (std::ostream &out);
+// compares the original std::multiset event queue to EventQueue's timing wheel with 100k pending events
+void BenchmarkEventQueue (std::ostream &out);
+// compares deleting EventHandlers' events with a full-queue scan to EventQueue's per-handler lists
+void BenchmarkEventCancellation (std::ostream &out);
+// compares allocating events from EventPool to allocating them from the global heap
+void BenchmarkEventAllocation (std::ostream &out);
+// compares BinaryFileSerializer to BufferedFileSerializer and MemoryMappedSerializer on a world-sized stream of objects
+void BenchmarkSerializer (std::ostream &out);
+// compares per-word byte-order switching and per-vertex reads to the bulk array paths of SwitchByteOrder and Serializer::ReadArray
+void BenchmarkSerializerArrays (std::ostream &out);
+
+} // end of namespace Bm
+
+#endif // !defined(_BM_MICROBENCHMARK_HPP_)
+
@@ -0,0 +1,346 @@
+// ///////////////////////////////////////////////////////////////////////////
+// bm_physicsbenchmark.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "bm_microbenchmark.hpp"
+
+#include <stdlib.h> // for srand()
+
+#include "xrb_engine2_circle_entity.hpp"
+#include "xrb_engine2_circle_physicshandler.hpp"
+#include "xrb_engine2_object.hpp"
+#include "xrb_engine2_objectlayer.hpp"
+#include "xrb_engine2_world.hpp"
+#include "xrb_math.hpp"
+
+using namespace std;
+using namespace Xrb;
+
+namespace Bm
+{
+
+namespace {
+
+// counts the collisions it is involved in
+class BenchmarkEntity : public Engine2::Circle::Entity
+{
+public:
+
+    BenchmarkEntity (Engine2::Circle::CollisionType collision_type) : Engine2::Circle::Entity(collision_type) { }
+
+    static Uint32 CollisionCount () { return ms_collision_count; }
+    static void ResetCollisionCount () { ms_collision_count = 0; }
+
+    virtual void Collide_ (
+        Engine2::Circle::Entity &collider,
+        FloatVector2 const &collision_location,
+        FloatVector2 const &collision_normal,
+        Float collision_force,
+        Time time,
+        Time::Delta frame_dt)
+    {
+        ++ms_collision_count;
+    }
+
+private:
+
+    static Uint32 ms_collision_count;
+}; // end of class BenchmarkEntity
+
+Uint32 BenchmarkEntity::ms_collision_count = 0;
+
+Float const gs_object_layer_side_length = 1000.0f;
+Uint32 const gs_frame_count = 50;
+
+// creates a wrapped world containing entity_count BenchmarkEntitys with
+// randomized (but reproducible) positions, sizes and velocities.
+Engine2::World *CreateBenchmarkWorld (
+    Engine2::Circle::PhysicsHandler *physics_handler,
+    Uint32 entity_count,
+    Float entity_radius,
+    Engine2::Circle::CollisionType collision_type,
+    Float max_entity_speed)
+{
+    Engine2::World *world = Engine2::World::CreateEmpty(physics_handler, entity_count);
+    Engine2::ObjectLayer *object_layer =
+        Engine2::ObjectLayer::Create(
+            world,
+            true,   // is_wrapped
+            gs_object_layer_side_length,
+            6,      // tree_depth
+            0.0f);  // z_depth
+    world->AddObjectLayer(object_layer);
+    world->SetMainObjectLayer(object_layer);
+
+    // use a fixed seed so every run places the entities identically.
+    srand(1);
+    Float half_side_length = 0.5f * gs_object_layer_side_length;
+    for (Uint32 i = 0; i < entity_count; ++i)
+    {
+        Engine2::Object *object = Engine2::Object::Create();
+        object->SetTranslation(
+            FloatVector2(
+                Math::RandomFloat(-half_side_length, half_side_length),
+                Math::RandomFloat(-half_side_length, half_side_length)));
+        object->SetScaleFactor(entity_radius * Math::RandomFloat(0.5f, 1.5f));
+        BenchmarkEntity *entity = new BenchmarkEntity(collision_type);
+        entity->SetVelocity(
+            FloatVector2(
+                Math::RandomFloat(-max_entity_speed, max_entity_speed),
+                Math::RandomFloat(-max_entity_speed, max_entity_speed)));
+        entity->SetAngularVelocity(Math::RandomFloat(-max_entity_speed, max_entity_speed));
+        object->SetEntity(entity);
+        world->AddDynamicObject(object, object_layer);
+    }
+
+    return world;
+}
+
+// runs gs_frame_count frames of the given world, returning the average
+// number of seconds per frame.
+double RunFrames (Engine2::World &world)
+{
+    // the first frame isn't timed (it allocates the long-lived buffers)
+    Time time(0.0);
+    world.ProcessFrame(time);
+    time += 1.0f / 60.0f;
+
+    BenchmarkEntity::ResetCollisionCount();
+    Stopwatch stopwatch;
+    for (Uint32 frame = 0; frame < gs_frame_count; ++frame)
+    {
+        world.ProcessFrame(time);
+        time += 1.0f / 60.0f;
+    }
+    return stopwatch.ElapsedSeconds() / gs_frame_count;
+}
+
+// runs gs_frame_count frames of a static (zero velocity) scene of
+// entity_count entities, so that the set of colliding pairs is the same
+// every frame and for every broad phase.  returns the average number of
+// seconds per frame, and stores the total number of collision pairs in
+// collision_pair_count.
+double RunBroadPhase (
+    Engine2::Circle::BroadPhase broad_phase,
+    Uint32 entity_count,
+    Float entity_radius,
+    Uint32 *collision_pair_count)
+{
+    ASSERT1(collision_pair_count != NULL);
+
+    Engine2::Circle::PhysicsHandler *physics_handler = new Engine2::Circle::PhysicsHandler();
+    physics_handler->SetBroadPhase(broad_phase);
+    Engine2::World *world = CreateBenchmarkWorld(physics_handler, entity_count, entity_radius, Engine2::Circle::CT_SOLID_COLLISION, 0.0f);
+    double seconds_per_frame = RunFrames(*world);
+    // each collision pair calls Collide_ on both of its entities
+    *collision_pair_count = BenchmarkEntity::CollisionCount() / 2;
+    Delete(world);
+    return seconds_per_frame;
+}
+
+// runs gs_frame_count frames of a scene of moving, non-colliding entities.
+// returns the average number of seconds per frame, and stores the sum of
+// the entities' final coordinates in position_checksum.
+double RunIntegration (
+    bool is_using_packed_integration,
+    Uint32 entity_count,
+    double *position_checksum)
+{
+    ASSERT1(position_checksum != NULL);
+
+    Engine2::Circle::PhysicsHandler *physics_handler = new Engine2::Circle::PhysicsHandler();
+    physics_handler->SetIsUsingPackedIntegration(is_using_packed_integration);
+    Engine2::World *world = CreateBenchmarkWorld(physics_handler, entity_count, 2.0f, Engine2::Circle::CT_NO_COLLISION, 50.0f);
+    double seconds_per_frame = RunFrames(*world);
+    *position_checksum = 0.0;
+    for (Uint32 i = 0; i < world->EntityCapacity(); ++i)
+        if (world->GetEntity(i) != NULL)
+            *position_checksum += world->GetEntity(i)->Translation()[Dim::X] + world->GetEntity(i)->Translation()[Dim::Y];
+    Delete(world);
+    return seconds_per_frame;
+}
+
+// runs gs_frame_count frames of a scene of static targets and small,
+// fast "bullets" which travel several target diameters per frame.  returns
+// the average number of seconds per frame, and stores the total number of
+// collision pairs in collision_pair_count.
+double RunContinuousCollision (
+    bool is_using_continuous_collision,
+    Uint32 target_count,
+    Uint32 bullet_count,
+    Float bullet_speed,
+    Uint32 *collision_pair_count)
+{
+    ASSERT1(collision_pair_count != NULL);
+
+    Engine2::Circle::PhysicsHandler *physics_handler = new Engine2::Circle::PhysicsHandler();
+    physics_handler->SetBroadPhase(Engine2::Circle::BP_SORT_AND_SWEEP);
+    Engine2::World *world = CreateBenchmarkWorld(physics_handler, target_count + bullet_count, 2.0f, Engine2::Circle::CT_SOLID_COLLISION, 0.0f);
+
+    // turn the first bullet_count entities into bullets
+    Uint32 bullets_created = 0;
+    for (Uint32 i = 0; i < world->EntityCapacity() && bullets_created < bullet_count; ++i)
+    {
+        if (world->GetEntity(i) == NULL)
+            continue;
+
+        Engine2::Circle::Entity *entity = DStaticCast<Engine2::Circle::Entity *>(world->GetEntity(i));
+        entity->SetScaleFactor(0.25f);
+        entity->SetVelocity(bullet_speed * Math::UnitVector(Math::RandomFloat(0.0f, 360.0f)));
+        entity->SetIsUsingContinuousCollision(is_using_continuous_collision);
+        ++bullets_created;
+    }
+
+    double seconds_per_frame = RunFrames(*world);
+    // each collision pair calls Collide_ on both of its entities
+    *collision_pair_count = BenchmarkEntity::CollisionCount() / 2;
+    Delete(world);
+    return seconds_per_frame;
+}
+
+// does trace_count AreaTraces and LineTraces at reproducibly random places
+// in world, using either the allocating (list/set) or the reusable-buffer
+// (vector) overloads.  returns the average number of seconds per trace
+// (one AreaTrace plus one LineTrace), and stores the total number of hits
+// in hit_count.
+double RunTraces (
+    Engine2::World &world,
+    bool is_using_vector_overloads,
+    Uint32 trace_count,
+    Uint32 *hit_count)
+{
+    ASSERT1(hit_count != NULL);
+
+    Engine2::Circle::PhysicsHandler const &physics_handler = *DStaticCast<Engine2::Circle::PhysicsHandler *>(world.GetPhysicsHandler());
+    Engine2::ObjectLayer const &object_layer = *world.MainObjectLayer();
+    Float half_side_length = 0.5f * gs_object_layer_side_length;
+    Engine2::Circle::AreaTraceVector area_trace_vector;
+    Engine2::Circle::LineTraceBindingVector line_trace_binding_vector;
+
+    srand(2);
+    *hit_count = 0;
+    Stopwatch stopwatch;
+    for (Uint32 i = 0; i < trace_count; ++i)
+    {
+        FloatVector2 center(
+            Math::RandomFloat(-half_side_length, half_side_length),
+            Math::RandomFloat(-half_side_length, half_side_length));
+        FloatVector2 trace_vector(200.0f * Math::UnitVector(Math::RandomFloat(0.0f, 360.0f)));
+        if (is_using_vector_overloads)
+        {
+            physics_handler.AreaTrace(object_layer, center, 30.0f, true, area_trace_vector);
+            physics_handler.LineTrace(object_layer, center, trace_vector, 1.0f, true, line_trace_binding_vector);
+            *hit_count += area_trace_vector.size() + line_trace_binding_vector.size();
+        }
+        else
+        {
+            Engine2::Circle::AreaTraceList area_trace_list;
+            Engine2::Circle::LineTraceBindingSet line_trace_binding_set;
+            physics_handler.AreaTrace(object_layer, center, 30.0f, true, area_trace_list);
+            physics_handler.LineTrace(object_layer, center, trace_vector, 1.0f, true, line_trace_binding_set);
+            *hit_count += area_trace_list.size() + line_trace_binding_set.size();
+        }
+    }
+    return stopwatch.ElapsedSeconds() / trace_count;
+}
+
+} // end of anonymous namespace
+
+void BenchmarkPhysicsBroadPhase (std::ostream &out)
+{
+    static Uint32 const s_entity_count[] = { 500, 2000, 8000 };
+    static Float const s_entity_radius[] = { 2.0f, 8.0f };
+
+    for (Uint32 r = 0; r < LENGTHOF(s_entity_radius); ++r)
+    {
+        for (Uint32 c = 0; c < LENGTHOF(s_entity_count); ++c)
+        {
+            Uint32 quad_tree_pair_count;
+            Uint32 sort_and_sweep_pair_count;
+            double quad_tree_seconds = RunBroadPhase(Engine2::Circle::BP_QUAD_TREE, s_entity_count[c], s_entity_radius[r], &quad_tree_pair_count);
+            double sort_and_sweep_seconds = RunBroadPhase(Engine2::Circle::BP_SORT_AND_SWEEP, s_entity_count[c], s_entity_radius[r], &sort_and_sweep_pair_count);
+
+            out << "    " << s_entity_count[c] << " entities, radius ~" << s_entity_radius[r]
+                << ": quadtree " << 1000.0 * quad_tree_seconds << " ms/frame, "
+                << "sort-and-sweep " << 1000.0 * sort_and_sweep_seconds << " ms/frame, "
+                << quad_tree_pair_count / gs_frame_count << " pairs/frame" << endl;
+            if (quad_tree_pair_count != sort_and_sweep_pair_count)
+                out << "    WARNING: broad phases disagree -- quadtree found " << quad_tree_pair_count
+                    << " pairs, sort-and-sweep found " << sort_and_sweep_pair_count << endl;
+        }
+    }
+}
+
+void BenchmarkPhysicsIntegration (std::ostream &out)
+{
+    static Uint32 const s_entity_count[] = { 2000, 8000, 32000 };
+
+    for (Uint32 c = 0; c < LENGTHOF(s_entity_count); ++c)
+    {
+        double unpacked_checksum;
+        double packed_checksum;
+        double unpacked_seconds = RunIntegration(false, s_entity_count[c], &unpacked_checksum);
+        double packed_seconds = RunIntegration(true, s_entity_count[c], &packed_checksum);
+
+        out << "    " << s_entity_count[c] << " moving entities: "
+            << "per-entity " << 1000.0 * unpacked_seconds << " ms/frame, "
+            << "packed " << 1000.0 * packed_seconds << " ms/frame" << endl;
+        if (unpacked_checksum != packed_checksum)
+            out << "    WARNING: integration results differ -- position checksums "
+                << unpacked_checksum << " (per-entity) and " << packed_checksum << " (packed)" << endl;
+    }
+}
+
+void BenchmarkPhysicsContinuousCollision (std::ostream &out)
+{
+    // in units per second -- at 60 frames per second, these are 10, 50 and
+    // 200 units per frame, against targets roughly 4 units across.
+    static Float const s_bullet_speed[] = { 600.0f, 3000.0f, 12000.0f };
+
+    for (Uint32 s = 0; s < LENGTHOF(s_bullet_speed); ++s)
+    {
+        Uint32 discrete_pair_count;
+        Uint32 continuous_pair_count;
+        double discrete_seconds = RunContinuousCollision(false, 2000, 500, s_bullet_speed[s], &discrete_pair_count);
+        double continuous_seconds = RunContinuousCollision(true, 2000, 500, s_bullet_speed[s], &continuous_pair_count);
+
+        out << "    500 bullets at " << s_bullet_speed[s] << " units/s, 2000 targets: "
+            << "discrete " << 1000.0 * discrete_seconds << " ms/frame, " << discrete_pair_count << " pairs; "
+            << "continuous " << 1000.0 * continuous_seconds << " ms/frame, " << continuous_pair_count << " pairs" << endl;
+    }
+}
+
+void BenchmarkPhysicsTraces (std::ostream &out)
+{
+    static Uint32 const s_entity_count[] = { 2000, 8000 };
+    static Uint32 const s_trace_count = 20000;
+
+    for (Uint32 c = 0; c < LENGTHOF(s_entity_count); ++c)
+    {
+        Engine2::Circle::PhysicsHandler *physics_handler = new Engine2::Circle::PhysicsHandler();
+        Engine2::World *world = CreateBenchmarkWorld(physics_handler, s_entity_count[c], 2.0f, Engine2::Circle::CT_SOLID_COLLISION, 0.0f);
+
+        Uint32 container_hit_count;
+        Uint32 vector_hit_count;
+        double container_seconds = RunTraces(*world, false, s_trace_count, &container_hit_count);
+        double vector_seconds = RunTraces(*world, true, s_trace_count, &vector_hit_count);
+
+        out << "    " << s_entity_count[c] << " entities, "
+            << Float(container_hit_count) / s_trace_count << " hits per area+line trace: "
+            << "list/set " << 1.0e6 * container_seconds << " us, "
+            << "reused vector " << 1.0e6 * vector_seconds << " us" << endl;
+        if (container_hit_count != vector_hit_count)
+            out << "    WARNING: trace overloads disagree -- list/set found " << container_hit_count
+                << " hits, vector found " << vector_hit_count << endl;
+
+        Delete(world);
+    }
+}
+
+} // end of namespace Bm
@@ -0,0 +1,297 @@
+// ///////////////////////////////////////////////////////////////////////////
+// bm_quadtreebenchmark.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "bm_microbenchmark.hpp"
+
+#include <stdlib.h> // for srand()
+#include <vector>
+
+#include "xrb_engine2_circle_collisionquadtree.hpp"
+#include "xrb_engine2_object.hpp"
+#include "xrb_engine2_objectlayer.hpp"
+#include "xrb_engine2_visibilityquadtree.hpp"
+#include "xrb_engine2_world.hpp"
+#include "xrb_math.hpp"
+
+using namespace std;
+using namespace Xrb;
+
+namespace Bm
+{
+
+namespace {
+
+Uint32 const gs_object_count = 10000;
+Uint32 const gs_cycle_count = 20;
+Uint32 const gs_re_add_count_per_cycle = 10;
+Float const gs_tree_half_side_length = 500.0f;
+Uint8 const gs_tree_depth = 6;
+Uint8 const gs_tree_adaptive_max_depth = 9;
+Uint32 const gs_tree_split_threshold = 8;
+
+// adds, re-adds (after a small random motion) and removes gs_object_count
+// objects, gs_cycle_count times over, and reports the time per operation.
+void BenchmarkQuadTreeOperations (
+    char const *tree_name,
+    Engine2::QuadTree &quad_tree,
+    Engine2::QuadTreeType quad_tree_type,
+    std::ostream &out)
+{
+    srand(1);
+
+    std::vector<Engine2::Object *> object_vector(gs_object_count);
+    for (Uint32 i = 0; i < gs_object_count; ++i)
+    {
+        object_vector[i] = Engine2::Object::Create();
+        object_vector[i]->SetScaleFactor(Math::RandomFloat(0.5f, 4.0f));
+    }
+
+    double add_seconds = 0.0;
+    double re_add_seconds = 0.0;
+    double remove_seconds = 0.0;
+    Uint32 full_node_count = 0;
+    Engine2::QuadTree::ResetReAddObjectCounts();
+    Stopwatch stopwatch;
+    for (Uint32 cycle = 0; cycle < gs_cycle_count; ++cycle)
+    {
+        for (Uint32 i = 0; i < gs_object_count; ++i)
+            object_vector[i]->SetTranslation(
+                FloatVector2(
+                    Math::RandomFloat(-gs_tree_half_side_length, gs_tree_half_side_length),
+                    Math::RandomFloat(-gs_tree_half_side_length, gs_tree_half_side_length)));
+
+        stopwatch.Start();
+        for (Uint32 i = 0; i < gs_object_count; ++i)
+            quad_tree.AddObject(object_vector[i]);
+        add_seconds += stopwatch.ElapsedSeconds();
+        full_node_count = quad_tree.NodeCount();
+
+        for (Uint32 re_add = 0; re_add < gs_re_add_count_per_cycle; ++re_add)
+        {
+            // move each object a little (roughly a frame's worth of motion),
+            // keeping it inside the tree.
+            for (Uint32 i = 0; i < gs_object_count; ++i)
+            {
+                FloatVector2 translation(object_vector[i]->Translation() + FloatVector2(Math::RandomFloat(-2.0f, 2.0f), Math::RandomFloat(-2.0f, 2.0f)));
+                translation.SetComponents(
+                    Max(-gs_tree_half_side_length, Min(gs_tree_half_side_length, translation[Dim::X])),
+                    Max(-gs_tree_half_side_length, Min(gs_tree_half_side_length, translation[Dim::Y])));
+                object_vector[i]->SetTranslation(translation);
+            }
+
+            stopwatch.Start();
+            for (Uint32 i = 0; i < gs_object_count; ++i)
+                object_vector[i]->OwnerQuadTree(quad_tree_type)->ReAddObject(object_vector[i]);
+            re_add_seconds += stopwatch.ElapsedSeconds();
+        }
+
+        stopwatch.Start();
+        for (Uint32 i = 0; i < gs_object_count; ++i)
+            object_vector[i]->OwnerQuadTree(quad_tree_type)->RemoveObject(object_vector[i]);
+        remove_seconds += stopwatch.ElapsedSeconds();
+    }
+
+    ASSERT1(quad_tree.SubordinateObjectCount() == 0);
+    for (Uint32 i = 0; i < gs_object_count; ++i)
+        Delete(object_vector[i]);
+
+    double const ns_per_op = 1.0e9 / (gs_cycle_count * gs_object_count);
+    out << "    " << tree_name << ", " << gs_object_count << " objects: "
+        << "add " << add_seconds * ns_per_op << " ns, "
+        << "re-add " << re_add_seconds * ns_per_op / gs_re_add_count_per_cycle << " ns, "
+        << "remove " << remove_seconds * ns_per_op << " ns (per object), "
+        << 100 * Engine2::QuadTree::ReAddObjectSkipCount() / Max(1U, Engine2::QuadTree::ReAddObjectCallCount()) << "% of re-adds skipped, "
+        << full_node_count << " nodes" << endl;
+}
+
+// fills the quadtree with gs_object_count objects, mostly small but with a
+// few large ones (like the asteroids in disasteroids), and reports
+// the mean number of objects each of a set of random area queries tests.
+void MeasureQuadTreeObjectTests (
+    char const *tree_name,
+    Engine2::QuadTree &quad_tree,
+    Engine2::QuadTreeType quad_tree_type,
+    Engine2::ObjectLayer const &object_layer,
+    std::ostream &out)
+{
+    static Float const s_query_radius[] = { 10.0f, 100.0f };
+    static Uint32 const s_query_count = 10000;
+
+    srand(1);
+
+    std::vector<Engine2::Object *> object_vector(gs_object_count);
+    for (Uint32 i = 0; i < gs_object_count; ++i)
+    {
+        object_vector[i] = Engine2::Object::Create();
+        // one in twenty objects is large
+        if (rand() % 20 == 0)
+            object_vector[i]->SetScaleFactor(Math::RandomFloat(20.0f, 200.0f));
+        else
+            object_vector[i]->SetScaleFactor(Math::RandomFloat(0.5f, 4.0f));
+        object_vector[i]->SetTranslation(
+            FloatVector2(
+                Math::RandomFloat(-gs_tree_half_side_length, gs_tree_half_side_length),
+                Math::RandomFloat(-gs_tree_half_side_length, gs_tree_half_side_length)));
+        quad_tree.AddObject(object_vector[i]);
+    }
+
+    out << "    " << tree_name << ", bound factor " << quad_tree.BoundFactor() << ":";
+    for (Uint32 r = 0; r < LENGTHOF(s_query_radius); ++r)
+    {
+        Uint32 object_test_count = 0;
+        for (Uint32 q = 0; q < s_query_count; ++q)
+        {
+            FloatVector2 query_center(
+                Math::RandomFloat(-gs_tree_half_side_length, gs_tree_half_side_length),
+                Math::RandomFloat(-gs_tree_half_side_length, gs_tree_half_side_length));
+            object_test_count += quad_tree.AreaQueryObjectTestCount(query_center, s_query_radius[r], object_layer);
+        }
+        out << " " << Float(object_test_count) / s_query_count << " objects tested per radius " << s_query_radius[r] << " query"
+            << (r + 1 < LENGTHOF(s_query_radius) ? "," : "");
+    }
+    out << endl;
+
+    for (Uint32 i = 0; i < gs_object_count; ++i)
+    {
+        object_vector[i]->OwnerQuadTree(quad_tree_type)->RemoveObject(object_vector[i]);
+        Delete(object_vector[i]);
+    }
+}
+
+// fills the quadtree with gs_object_count small objects, either uniformly
+// or in a few tight clusters, and reports the node count and the mean number
+// of objects a radius 10 area query tests.  then empties the quadtree, and
+// reports the node count again.
+void MeasureQuadTreeAdaptivity (
+    char const *tree_name,
+    Engine2::QuadTree &quad_tree,
+    Engine2::QuadTreeType quad_tree_type,
+    Engine2::ObjectLayer const &object_layer,
+    bool is_clustered,
+    std::ostream &out)
+{
+    static Uint32 const s_cluster_count = 8;
+    static Float const s_cluster_radius = 40.0f;
+    static Uint32 const s_query_count = 10000;
+
+    srand(1);
+
+    FloatVector2 cluster_center[s_cluster_count];
+    for (Uint32 c = 0; c < s_cluster_count; ++c)
+        cluster_center[c].SetComponents(
+            Math::RandomFloat(s_cluster_radius - gs_tree_half_side_length, gs_tree_half_side_length - s_cluster_radius),
+            Math::RandomFloat(s_cluster_radius - gs_tree_half_side_length, gs_tree_half_side_length - s_cluster_radius));
+
+    std::vector<Engine2::Object *> object_vector(gs_object_count);
+    for (Uint32 i = 0; i < gs_object_count; ++i)
+    {
+        object_vector[i] = Engine2::Object::Create();
+        object_vector[i]->SetScaleFactor(Math::RandomFloat(0.5f, 4.0f));
+        if (is_clustered)
+            object_vector[i]->SetTranslation(
+                cluster_center[i % s_cluster_count] +
+                Math::RandomFloat(0.0f, s_cluster_radius) * Math::UnitVector(Math::RandomFloat(0.0f, 360.0f)));
+        else
+            object_vector[i]->SetTranslation(
+                FloatVector2(
+                    Math::RandomFloat(-gs_tree_half_side_length, gs_tree_half_side_length),
+                    Math::RandomFloat(-gs_tree_half_side_length, gs_tree_half_side_length)));
+        quad_tree.AddObject(object_vector[i]);
+    }
+
+    // query where the objects are, so that the clustered case isn't mostly empty queries
+    Uint32 object_test_count = 0;
+    for (Uint32 q = 0; q < s_query_count; ++q)
+        object_test_count += quad_tree.AreaQueryObjectTestCount(object_vector[rand() % gs_object_count]->Translation(), 10.0f, object_layer);
+    Uint32 full_node_count = quad_tree.NodeCount();
+
+    for (Uint32 i = 0; i < gs_object_count; ++i)
+    {
+        object_vector[i]->OwnerQuadTree(quad_tree_type)->RemoveObject(object_vector[i]);
+        Delete(object_vector[i]);
+    }
+
+    out << "    " << tree_name << ", " << (is_clustered ? "clustered" : "uniform") << ": "
+        << full_node_count << " nodes, "
+        << Float(object_test_count) / s_query_count << " objects tested per radius 10 query, "
+        << quad_tree.NodeCount() << " nodes once emptied" << endl;
+}
+
+} // end of anonymous namespace
+
+void BenchmarkQuadTree (std::ostream &out)
+{
+    {
+        Engine2::VisibilityQuadTree quad_tree(FloatVector2::ms_zero, gs_tree_half_side_length, gs_tree_depth);
+        BenchmarkQuadTreeOperations("VisibilityQuadTree", quad_tree, Engine2::QTT_VISIBILITY, out);
+    }
+    {
+        Engine2::Circle::CollisionQuadTree *quad_tree = Engine2::Circle::CollisionQuadTree::Create(gs_tree_half_side_length, gs_tree_depth);
+        BenchmarkQuadTreeOperations("CollisionQuadTree", *quad_tree, Engine2::QTT_PHYSICS_HANDLER, out);
+        Delete(quad_tree);
+    }
+    {
+        Engine2::Circle::CollisionQuadTree *quad_tree = Engine2::Circle::CollisionQuadTree::Create(gs_tree_half_side_length, gs_tree_adaptive_max_depth, 2.0f, gs_tree_split_threshold);
+        BenchmarkQuadTreeOperations("adaptive CollisionQuadTree", *quad_tree, Engine2::QTT_PHYSICS_HANDLER, out);
+        Delete(quad_tree);
+    }
+}
+
+void BenchmarkQuadTreeBoundFactor (std::ostream &out)
+{
+    static Float const s_bound_factor[] = { 2.0f, 3.0f, 4.0f };
+
+    // AreaQueryObjectTestCount needs an ObjectLayer for the wrapping
+    // adjustment, but doesn't use its quadtree.
+    Engine2::World *world = Engine2::World::CreateEmpty(NULL);
+    Engine2::ObjectLayer *object_layer = Engine2::ObjectLayer::Create(world, true, 2.0f * gs_tree_half_side_length, 1, 0.0f);
+    world->AddObjectLayer(object_layer);
+
+    for (Uint32 b = 0; b < LENGTHOF(s_bound_factor); ++b)
+    {
+        Engine2::VisibilityQuadTree quad_tree(FloatVector2::ms_zero, gs_tree_half_side_length, gs_tree_depth, s_bound_factor[b]);
+        MeasureQuadTreeObjectTests("VisibilityQuadTree", quad_tree, Engine2::QTT_VISIBILITY, *object_layer, out);
+    }
+    for (Uint32 b = 0; b < LENGTHOF(s_bound_factor); ++b)
+    {
+        Engine2::Circle::CollisionQuadTree *quad_tree = Engine2::Circle::CollisionQuadTree::Create(gs_tree_half_side_length, gs_tree_depth, s_bound_factor[b]);
+        MeasureQuadTreeObjectTests("CollisionQuadTree", *quad_tree, Engine2::QTT_PHYSICS_HANDLER, *object_layer, out);
+        Delete(quad_tree);
+    }
+
+    Delete(world);
+}
+
+void BenchmarkQuadTreeAdaptive (std::ostream &out)
+{
+    // AreaQueryObjectTestCount needs an ObjectLayer for the wrapping
+    // adjustment, but doesn't use its quadtree.
+    Engine2::World *world = Engine2::World::CreateEmpty(NULL);
+    Engine2::ObjectLayer *object_layer = Engine2::ObjectLayer::Create(world, true, 2.0f * gs_tree_half_side_length, 1, 0.0f);
+    world->AddObjectLayer(object_layer);
+
+    for (Uint32 is_clustered = 0; is_clustered < 2; ++is_clustered)
+    {
+        {
+            Engine2::Circle::CollisionQuadTree *quad_tree = Engine2::Circle::CollisionQuadTree::Create(gs_tree_half_side_length, gs_tree_depth);
+            MeasureQuadTreeAdaptivity("fixed depth 6", *quad_tree, Engine2::QTT_PHYSICS_HANDLER, *object_layer, is_clustered != 0, out);
+            Delete(quad_tree);
+        }
+        {
+            Engine2::Circle::CollisionQuadTree *quad_tree = Engine2::Circle::CollisionQuadTree::Create(gs_tree_half_side_length, gs_tree_adaptive_max_depth, 2.0f, gs_tree_split_threshold);
+            MeasureQuadTreeAdaptivity("adaptive (max depth 9, split above 8)", *quad_tree, Engine2::QTT_PHYSICS_HANDLER, *object_layer, is_clustered != 0, out);
+            Delete(quad_tree);
+        }
+    }
+
+    Delete(world);
+}
+
+} // end of namespace Bm
@@ -0,0 +1,372 @@
+// ///////////////////////////////////////////////////////////////////////////
+// bm_serializerbenchmark.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "bm_microbenchmark.hpp"
+
+#include <cstdio>
+#include <string.h>
+#include <vector>
+
+#include "xrb_binaryfileserializer.hpp"
+#include "xrb_bufferedfileserializer.hpp"
+#include "xrb_endian.hpp"
+#include "xrb_filesystem.hpp"
+#include "xrb_memorymappedserializer.hpp"
+#include "xrb_singleton.hpp"
+#include "xrb_vector.hpp"
+
+using namespace std;
+using namespace Xrb;
+
+namespace Bm
+{
+
+namespace {
+
+// roughly what VisibilityQuadTree::ReadObjects goes through for a big world
+Uint32 const gs_object_count = 200000;
+// every this many objects has a texture path, and every this many has a
+// polygon (like Compound's vertex arrays).
+Uint32 const gs_texture_path_period = 8;
+Uint32 const gs_polygon_period = 16;
+Uint32 const gs_polygon_vertex_count = 12;
+
+char const *const gs_serializer_file_path = "fs://serializerbenchmark.dat";
+char const *const gs_buffered_serializer_file_path = "fs://serializerbenchmark.buffered.dat";
+char const *const gs_foreign_serializer_file_path = "fs://serializerbenchmark.foreign.dat";
+
+// writes words in the target endianness, or switched (to produce a file as
+// if it had been written on a machine of the other endianness).
+class ObjectWriter
+{
+public:
+
+    ObjectWriter (Serializer &serializer, bool switch_byte_order) : m_serializer(serializer), m_switch_byte_order(switch_byte_order) { }
+
+    template <typename T>
+    void Put (T word)
+    {
+        if (m_switch_byte_order)
+            Word<T>::SwitchByteOrder(word);
+        m_serializer.Write<T>(word);
+    }
+    template <typename T>
+    void PutArray (T const *source, Uint32 length)
+    {
+        if (m_switch_byte_order)
+        {
+            std::vector<T> switched(source, source + length);
+            Word<T>::SwitchByteOrder(&switched[0], length);
+            m_serializer.WriteArray<T>(&switched[0], length);
+        }
+        else
+            m_serializer.WriteArray<T>(source, length);
+    }
+
+    // the same sort of thing as Object::Write and its subclasses
+    void WriteObject (Uint32 index)
+    {
+        Put<Uint8>(index % 7);
+        Put<Uint32>(index);
+        Float position[2] = { Float(index % 1000), Float(index / 1000) };
+        PutArray<Float>(position, 2);
+        Put<Float>(1.0f + Float(index % 13));
+        Put<Float>(Float(index % 360));
+        Put<Uint8>(index % 3 == 0 ? 0xFF : 0x00); // a bool
+        if (index % gs_texture_path_period == 0)
+        {
+            std::string path(FORMAT("fs://resources/sprite" << index % 100 << ".png"));
+            Put<Uint32>(path.length());
+            m_serializer.WriteArray<char>(path.data(), path.length());
+        }
+        if (index % gs_polygon_period == 0)
+        {
+            Float vertex[2*gs_polygon_vertex_count];
+            for (Uint32 v = 0; v < LENGTHOF(vertex); ++v)
+                vertex[v] = Float(index + v) * 0.5f;
+            Put<Uint32>(LENGTHOF(vertex));
+            PutArray<Float>(vertex, LENGTHOF(vertex));
+        }
+    }
+
+private:
+
+    Serializer &m_serializer;
+    bool const m_switch_byte_order;
+}; // end of class ObjectWriter
+
+Uint32 FloatBits (Float value)
+{
+    Uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// reads what ObjectWriter::WriteObject wrote, the way Object::Create would,
+// and returns a checksum of it.
+Uint32 ReadObject (Serializer &serializer)
+{
+    Uint32 checksum = serializer.Read<Uint8>();
+    Uint32 index = serializer.Read<Uint32>();
+    checksum = checksum*31 + index;
+    FloatVector2 position(serializer.ReadAggregate<FloatVector2>());
+    checksum = checksum*31 + FloatBits(position[Dim::X]) + FloatBits(position[Dim::Y]);
+    checksum = checksum*31 + FloatBits(serializer.Read<Float>());
+    checksum = checksum*31 + FloatBits(serializer.Read<Float>());
+    checksum = checksum*31 + (serializer.Read<bool>() ? 1 : 0);
+    if (index % gs_texture_path_period == 0)
+    {
+        std::string path(serializer.ReadAggregate<std::string>());
+        checksum = checksum*31 + path.length() + path[path.length()-1];
+    }
+    if (index % gs_polygon_period == 0)
+    {
+        Float *vertex = NULL;
+        Uint32 vertex_count;
+        serializer.ReadSizeAndAllocatedArray<Float>(vertex, vertex_count);
+        for (Uint32 v = 0; v < vertex_count; ++v)
+            checksum = checksum*31 + FloatBits(vertex[v]);
+        delete[] vertex;
+    }
+    return checksum;
+}
+
+void WriteObjects (Serializer &serializer, bool switch_byte_order)
+{
+    ObjectWriter writer(serializer, switch_byte_order);
+    for (Uint32 i = 0; i < gs_object_count; ++i)
+        writer.WriteObject(i);
+}
+
+double ReadObjects (Serializer &serializer, Uint32 &checksum)
+{
+    Stopwatch stopwatch;
+    checksum = 0;
+    for (Uint32 i = 0; i < gs_object_count; ++i)
+        checksum = checksum*7 + ReadObject(serializer);
+    return stopwatch.ElapsedSeconds();
+}
+
+bool FilesAreIdentical (std::string const &os_path_0, std::string const &os_path_1)
+{
+    MemoryMappedSerializer file_0(os_path_0);
+    MemoryMappedSerializer file_1(os_path_1);
+    return file_0.Size() == file_1.Size() && memcmp(file_0.Data(), file_1.Data(), file_0.Size()) == 0;
+}
+
+// changes the endianness byte of the file, so that the (already switched)
+// words in it are read as the other endianness.
+void SwitchFileEndiannessByte (std::string const &os_path)
+{
+    std::FILE *file = std::fopen(os_path.c_str(), "r+b");
+    ASSERT0(file != NULL);
+    Uint8 endianness_byte = Endianness::OF_TARGET == Endianness::LITTLE ? 0x00 : 0xFF;
+    std::fwrite(&endianness_byte, 1, 1, file);
+    std::fclose(file);
+}
+
+// a very large Compound-heavy world's worth of vertices
+Uint32 const gs_vertex_count = 1000000;
+// an odd number of bytes, so that the bulk byte-order switch has a partial tail
+Uint32 const gs_switched_byte_count = 4*1024*1024 + 24 + 8 + 6;
+Uint32 const gs_switch_repetition_count = 10;
+
+char const *const gs_vertex_file_path = "fs://serializerbenchmark.vertices.dat";
+char const *const gs_foreign_vertex_file_path = "fs://serializerbenchmark.vertices.foreign.dat";
+
+// switches each word in the array a byte at a time, the way SwitchByteOrder
+// used to.
+void SwitchByteOrder_PerWord (Uint8 *array, Uint32 word_size, Uint32 word_count)
+{
+    for (Uint32 i = 0; i < word_count; ++i)
+        SwitchByteOrder(array + i*word_size, word_size);
+}
+
+// returns the time taken by gs_switch_repetition_count switches of the
+// data, and whether the bulk and per-word switches agreed on the first one.
+double TimeSwitchByteOrder (Uint32 word_size, bool per_word, bool &matches)
+{
+    Uint32 word_count = gs_switched_byte_count / word_size;
+    std::vector<Uint8> data(gs_switched_byte_count);
+    for (Uint32 i = 0; i < data.size(); ++i)
+        data[i] = Uint8(i*7 + i/256);
+    std::vector<Uint8> expected(data);
+    SwitchByteOrder_PerWord(&expected[0], word_size, word_count);
+
+    Stopwatch stopwatch;
+    for (Uint32 r = 0; r < gs_switch_repetition_count; ++r)
+    {
+        if (per_word)
+            SwitchByteOrder_PerWord(&data[0], word_size, word_count);
+        else
+            SwitchByteOrder(&data[0], word_size, word_count);
+        if (r == 0)
+            matches = data == expected;
+    }
+    return stopwatch.ElapsedSeconds();
+}
+
+FloatVector2 VertexValue (Uint32 index)
+{
+    return FloatVector2(Float(index % 1000) * 0.25f, Float(index / 1000) * 0.5f);
+}
+
+void WriteVertices (std::string const &path, bool switch_byte_order)
+{
+    std::vector<FloatVector2> vertex(gs_vertex_count);
+    for (Uint32 i = 0; i < gs_vertex_count; ++i)
+        vertex[i] = VertexValue(i);
+    BufferedFileSerializer serializer(path);
+    ObjectWriter writer(serializer, switch_byte_order);
+    writer.Put<Uint32>(gs_vertex_count);
+    writer.PutArray<Float>(vertex[0].m, 2*gs_vertex_count);
+    serializer.Flush();
+}
+
+// reads the vertices the way Compound::ReadClassSpecific does (or did, when
+// per_vertex is true), and checks them.
+double ReadVertices (std::string const &path, bool per_vertex, bool &matches)
+{
+    Stopwatch stopwatch;
+    MemoryMappedSerializer serializer(path);
+    Uint32 vertex_count = serializer.Read<Uint32>();
+    FloatVector2 *vertex_array = new FloatVector2[vertex_count];
+    if (per_vertex)
+        for (Uint32 i = 0; i < vertex_count; ++i)
+            serializer.ReadAggregate<FloatVector2>(vertex_array[i]);
+    else
+        serializer.ReadArray<FloatVector2>(vertex_array, vertex_count);
+    double seconds = stopwatch.ElapsedSeconds();
+
+    matches = vertex_count == gs_vertex_count && serializer.IsAtEnd();
+    for (Uint32 i = 0; matches && i < vertex_count; ++i)
+        matches = vertex_array[i] == VertexValue(i);
+    delete[] vertex_array;
+    return seconds;
+}
+
+} // end of anonymous namespace
+
+void BenchmarkSerializer (std::ostream &out)
+{
+    std::string os_path(Singleton::FileSystem().OsPath(gs_serializer_file_path, FileSystem::WRITABLE));
+    std::string buffered_os_path(Singleton::FileSystem().OsPath(gs_buffered_serializer_file_path, FileSystem::WRITABLE));
+    std::string foreign_os_path(Singleton::FileSystem().OsPath(gs_foreign_serializer_file_path, FileSystem::WRITABLE));
+
+    double binary_write_seconds;
+    {
+        Stopwatch stopwatch;
+        BinaryFileSerializer serializer(os_path, IOD_WRITE);
+        WriteObjects(serializer, false);
+        binary_write_seconds = stopwatch.ElapsedSeconds();
+    }
+    double buffered_write_seconds;
+    {
+        Stopwatch stopwatch;
+        BufferedFileSerializer serializer(buffered_os_path);
+        WriteObjects(serializer, false);
+        serializer.Flush();
+        buffered_write_seconds = stopwatch.ElapsedSeconds();
+    }
+    bool files_are_identical = FilesAreIdentical(os_path, buffered_os_path);
+
+    Uint32 binary_checksum;
+    double binary_read_seconds;
+    {
+        BinaryFileSerializer serializer(os_path, IOD_READ);
+        binary_read_seconds = ReadObjects(serializer, binary_checksum);
+    }
+    Uint32 mapped_checksum;
+    double mapped_read_seconds;
+    {
+        MemoryMappedSerializer serializer(os_path);
+        mapped_read_seconds = ReadObjects(serializer, mapped_checksum);
+    }
+
+    // now a file as if written on a machine of the other endianness
+    {
+        BufferedFileSerializer serializer(foreign_os_path);
+        WriteObjects(serializer, true);
+    }
+    SwitchFileEndiannessByte(foreign_os_path);
+    Uint32 foreign_binary_checksum;
+    double foreign_binary_read_seconds;
+    {
+        BinaryFileSerializer serializer(foreign_os_path, IOD_READ);
+        foreign_binary_read_seconds = ReadObjects(serializer, foreign_binary_checksum);
+    }
+    Uint32 foreign_mapped_checksum;
+    double foreign_mapped_read_seconds;
+    {
+        MemoryMappedSerializer serializer(foreign_os_path);
+        foreign_mapped_read_seconds = ReadObjects(serializer, foreign_mapped_checksum);
+    }
+
+    std::remove(os_path.c_str());
+    std::remove(buffered_os_path.c_str());
+    std::remove(foreign_os_path.c_str());
+
+    double const ms = 1.0e3;
+    out << "    " << gs_object_count << " objects" << endl;
+    out << "    write: BinaryFileSerializer " << binary_write_seconds * ms << " ms, BufferedFileSerializer "
+        << buffered_write_seconds * ms << " ms (files " << (files_are_identical ? "identical" : "DIFFER") << ")" << endl;
+    out << "    read: BinaryFileSerializer " << binary_read_seconds * ms << " ms, MemoryMappedSerializer "
+        << mapped_read_seconds * ms << " ms (checksums " << (binary_checksum == mapped_checksum ? "match" : "DO NOT MATCH") << ")" << endl;
+    out << "    read (other endianness): BinaryFileSerializer " << foreign_binary_read_seconds * ms << " ms, MemoryMappedSerializer "
+        << foreign_mapped_read_seconds * ms << " ms (checksums "
+        << (foreign_binary_checksum == binary_checksum && foreign_mapped_checksum == binary_checksum ? "match" : "DO NOT MATCH") << ")" << endl;
+}
+
+void BenchmarkSerializerArrays (std::ostream &out)
+{
+    double const ms = 1.0e3;
+    bool all_match = true;
+
+    out << "    switching the byte order of " << gs_switched_byte_count << " bytes, " << gs_switch_repetition_count << " times" << endl;
+    Uint32 const word_size[] = { 2, 4, 8 };
+    for (Uint32 i = 0; i < LENGTHOF(word_size); ++i)
+    {
+        bool per_word_matches = false;
+        bool bulk_matches = false;
+        double per_word_seconds = TimeSwitchByteOrder(word_size[i], true, per_word_matches);
+        double bulk_seconds = TimeSwitchByteOrder(word_size[i], false, bulk_matches);
+        all_match = all_match && bulk_matches;
+        out << "    " << word_size[i] << "-byte words: per word " << per_word_seconds * ms << " ms, SwitchByteOrder "
+            << bulk_seconds * ms << " ms (" << (bulk_matches ? "match" : "DO NOT MATCH") << ")" << endl;
+    }
+
+    std::string vertex_os_path(Singleton::FileSystem().OsPath(gs_vertex_file_path, FileSystem::WRITABLE));
+    std::string foreign_vertex_os_path(Singleton::FileSystem().OsPath(gs_foreign_vertex_file_path, FileSystem::WRITABLE));
+    WriteVertices(vertex_os_path, false);
+    WriteVertices(foreign_vertex_os_path, true);
+    SwitchFileEndiannessByte(foreign_vertex_os_path);
+
+    out << "    reading " << gs_vertex_count << " vertices with MemoryMappedSerializer" << endl;
+    for (Uint32 foreign = 0; foreign < 2; ++foreign)
+    {
+        std::string const &os_path = foreign ? foreign_vertex_os_path : vertex_os_path;
+        bool per_vertex_matches = false;
+        bool bulk_matches = false;
+        double per_vertex_seconds = ReadVertices(os_path, true, per_vertex_matches);
+        double bulk_seconds = ReadVertices(os_path, false, bulk_matches);
+        all_match = all_match && per_vertex_matches && bulk_matches;
+        out << "    " << (foreign ? "other" : "same") << " endianness: ReadAggregate per vertex " << per_vertex_seconds * ms
+            << " ms, ReadArray " << bulk_seconds * ms << " ms ("
+            << (per_vertex_matches && bulk_matches ? "match" : "DO NOT MATCH") << ")" << endl;
+    }
+
+    std::remove(vertex_os_path.c_str());
+    std::remove(foreign_vertex_os_path.c_str());
+
+    if (!all_match)
+        out << "    MISMATCH" << endl;
+}
+
+} // end of namespace Bm
@@ -19,6 +19,8 @@
 #include "dis_resourcecache.hpp"
 #include "dis_titlescreenwidget.hpp"
 #include "dis_world.hpp"
+#include "xrb_engine2_quadtree.hpp"
+#include "xrb_gl.hpp"
 #include "xrb_inputstate.hpp"
 #include "xrb_pal.hpp"
 #include "xrb_screen.hpp"
@@ -27,6 +29,7 @@
 #include "xrb_stylesheet.hpp"
 
 #define HIGH_SCORES_FILENAME "disasteroids.scores"
+#define GLTEXTURE_ATLAS_CACHE_FILENAME "disasteroids.atlascache"
 
 using namespace Xrb;
 
@@ -152,6 +155,10 @@ Master::~Master ()
 
 void Master::Run ()
 {
+    // use the baked texture atlases if they exist (and are up to date), so
+    // that the textures in the resource cache don't have to be loaded and
+    // uploaded one at a time.
+    Singleton::Gl().LoadGlTextureAtlasCache(GLTEXTURE_ATLAS_CACHE_FILENAME);
     // cache frequently-used resources for the entire execution of Run()
     ResourceCache resource_cache;
 
@@ -266,10 +273,23 @@ void Master::Run ()
             m_game_widget->SetBindTextureCallHitPercent(bind_texture_call_hit_percent);
             Singleton::Gl().ResetBindTextureCallCounts();
 
+            Uint32 re_add_object_call_count = Engine2::QuadTree::ReAddObjectCallCount();
+            Uint32 re_add_object_skip_percent = 100;
+            if (re_add_object_call_count != 0)
+                re_add_object_skip_percent = 100 * Engine2::QuadTree::ReAddObjectSkipCount() / re_add_object_call_count;
+            m_game_widget->SetQuadTreeReAddSkipPercent(re_add_object_skip_percent);
+            Engine2::QuadTree::ResetReAddObjectCounts();
+
             m_game_widget->SetEntityCount(m_game_world->EntityCount());
         }
     }
 
+    // if any textures were loaded the slow way (all of them, the first time,
+    // or after an image has changed), bake them for next time.  this is done
+    // on the way out so that it doesn't add to the startup time.
+    if (Singleton::Gl().HasUnbakedGlTextures())
+        Singleton::Gl().BakeGlTextureAtlasCache(GLTEXTURE_ATLAS_CACHE_FILENAME);
+
     ASSERT1(m_game_widget == NULL);
     ASSERT1(m_game_world == NULL);
     ASSERT1(m_title_screen_widget == NULL);
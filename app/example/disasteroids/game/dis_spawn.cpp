@@ -167,6 +167,10 @@ Ballistic *SpawnDumbBallistic (
             weapon_level,
             owner,
             false);
+    // dumb ballistics don't do their own line trace (see Ballistic::Think),
+    // so have the physics handler sweep them, so they can't pass through
+    // small things at high speed.
+    ballistic->SetIsUsingContinuousCollision(true);
     Engine2::Sprite *sprite =
         SpawnDynamicSprite(
             object_layer,
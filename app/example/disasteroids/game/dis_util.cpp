@@ -35,15 +35,15 @@ void RadiusDamage (
     if (damage_amount == 0.0f)
         return;
 
-    Engine2::Circle::AreaTraceList area_trace_list;
+    Engine2::Circle::AreaTraceVector area_trace_vector;
     physics_handler.AreaTrace(
         object_layer,
         damage_area_center,
         damage_area_radius,
         false,
-        area_trace_list);
+        area_trace_vector);
 
-    for (Engine2::Circle::AreaTraceList::iterator it = area_trace_list.begin(), it_end = area_trace_list.end(); it != it_end; ++it)
+    for (Engine2::Circle::AreaTraceVector::iterator it = area_trace_vector.begin(), it_end = area_trace_vector.end(); it != it_end; ++it)
     {
         ASSERT1(*it != NULL);
         Entity &entity = *DStaticCast<Entity *>(*it);
@@ -94,16 +94,16 @@ void RadiusKnockback (
     ASSERT1(knockback_area_radius > 0.0f);
     ASSERT1(power > 0.0f);
 
-    Engine2::Circle::AreaTraceList area_trace_list;
+    Engine2::Circle::AreaTraceVector area_trace_vector;
     physics_handler.AreaTrace(
         object_layer,
         knockback_area_center,
         knockback_area_radius,
         false,
-        area_trace_list);
+        area_trace_vector);
 
     // iterate through the trace set and apply forces
-    for (Engine2::Circle::AreaTraceList::iterator it = area_trace_list.begin(), it_end = area_trace_list.end(); it != it_end; ++it)
+    for (Engine2::Circle::AreaTraceVector::iterator it = area_trace_vector.begin(), it_end = area_trace_vector.end(); it != it_end; ++it)
     {
         ASSERT1(*it != NULL);
         Entity &entity = *DStaticCast<Entity *>(*it);
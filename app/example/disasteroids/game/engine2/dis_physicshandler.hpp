@@ -34,7 +34,10 @@ public:
     PhysicsHandler ()
         :
         Engine2::Circle::PhysicsHandler()
-    { }
+    {
+        SetBroadPhase(Engine2::Circle::BP_SORT_AND_SWEEP);
+        SetIsUsingPackedIntegration(true);
+    }
     virtual ~PhysicsHandler () { }
 
     virtual bool CollisionExemption (Engine2::Circle::Entity const &entity0, Engine2::Circle::Entity const &entity1) const;
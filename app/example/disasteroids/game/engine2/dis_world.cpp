@@ -1286,6 +1286,7 @@ void World::ScheduleStateMachineInput (StateMachineInput input, Float time_delay
 void World::CancelScheduledStateMachineInput ()
 {
     OwnerEventQueue()->ScheduleMatchingEventsForDeletion(
+        *this,
         MatchEventType,
         Event::STATE_MACHINE_INPUT);
 }
@@ -1660,6 +1661,8 @@ void World::CreateAndPopulateBackgroundObjectLayers ()
                 4,                        // visibility quad tree depth
                 30000.0f);                // z depth
         AddObjectLayer(object_layer);
+        // nothing in this layer ever moves
+        object_layer->SetUsesStaticDrawCache(true);
 
         static std::string const s_galaxy_sprite_path[] =
         {
@@ -1710,6 +1713,8 @@ void World::CreateAndPopulateBackgroundObjectLayers ()
                 4,                        // visibility quad tree depth
                 5000.0f);                 // z depth
         AddObjectLayer(object_layer);
+        // nothing in this layer ever moves
+        object_layer->SetUsesStaticDrawCache(true);
 
         static std::string const s_starfield_sprite_path[] =
         {
@@ -1751,6 +1756,8 @@ void World::CreateAndPopulateBackgroundObjectLayers ()
                 6,                        // visibility quad tree depth
                 2000.0f);                 // z depth
         AddObjectLayer(object_layer);
+        // nothing in this layer ever moves
+        object_layer->SetUsesStaticDrawCache(true);
 
         static std::string const s_starfield_sprite_path[] =
         {
@@ -1795,6 +1802,8 @@ void World::CreateAndPopulateBackgroundObjectLayers ()
                 3,                        // visibility quad tree depth
                 1000.0f);                 // z depth
         AddObjectLayer(object_layer);
+        // nothing in this layer ever moves
+        object_layer->SetUsesStaticDrawCache(true);
 
         static std::string const s_planetfield_sprite_path[] =
         {
@@ -1840,6 +1849,8 @@ void World::CreateAndPopulateBackgroundObjectLayers ()
                 3,                        // visibility quad tree depth
                 10000.0f);                // z depth
         AddObjectLayer(object_layer);
+        // nothing in this layer ever moves
+        object_layer->SetUsesStaticDrawCache(true);
 
         static std::string const s_nebula_sprite_path[] =
         {
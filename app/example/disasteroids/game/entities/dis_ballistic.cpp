@@ -47,7 +47,6 @@ void Ballistic::Think (Time time, Time::Delta frame_dt)
             {
                 FloatVector2 trace_vector(frame_dt * Velocity());
                 FloatVector2 trace_start(Translation() - 0.5f * trace_vector);
-                Engine2::Circle::LineTraceBindingSet line_trace_binding_set;
                 ASSERT1(GetObjectLayer() != NULL);
                 GetPhysicsHandler()->LineTrace(
                     *GetObjectLayer(),
@@ -55,31 +54,31 @@ void Ballistic::Think (Time time, Time::Delta frame_dt)
                     trace_vector,
                     PhysicalRadius(),
                     false,
-                    line_trace_binding_set);
+                    m_line_trace_binding_vector);
 
-                for (Engine2::Circle::LineTraceBindingSet::iterator
-                        it = line_trace_binding_set.begin(),
-                        it_end = line_trace_binding_set.end();
+                for (Engine2::Circle::LineTraceBindingVector::iterator
+                        it = m_line_trace_binding_vector.begin(),
+                        it_end = m_line_trace_binding_vector.end();
                      it != it_end;
                      ++it)
                 {
                     // don't hit ourselves
-                    if (&it->m_entity == this)
+                    if (it->m_entity == this)
                         continue;
 
                     // don't hit the entity that fired us
-                    if (&it->m_entity == *m_owner)
+                    if (it->m_entity == *m_owner)
                         continue;
 
                     FloatVector2 collision_location(trace_start + it->m_clamped_trace_hit_parameter * trace_vector);
-                    FloatVector2 collision_normal(GetObjectLayer()->AdjustedDifference(collision_location, it->m_entity.Translation()));
+                    FloatVector2 collision_normal(GetObjectLayer()->AdjustedDifference(collision_location, it->m_entity->Translation()));
                     if (collision_normal.LengthSquared() < 0.001f)
                         collision_normal = FloatVector2(1.0f, 0.0f); // arbitrary unit vector
                     else
                         collision_normal.Normalize();
                     bool there_was_a_collision =
                         CollidePrivate(
-                            *DStaticCast<Entity *>(&it->m_entity),
+                            *DStaticCast<Entity *>(it->m_entity),
                             collision_location,
                             collision_normal,
                             0.0f,
@@ -87,6 +87,9 @@ protected:
     EntityReference<Entity> m_owner;
     bool m_perform_line_trace_for_accuracy;
     FloatVector2 m_initial_velocity;
+    // reusable storage for the line trace done in Think, so that it
+    // doesn't allocate memory every frame.
+    Engine2::Circle::LineTraceBindingVector m_line_trace_binding_vector;
 }; // end of class Ballistic
 
 } // end of namespace Dis
@@ -345,7 +345,6 @@ void Missile::Think (Time time, Time::Delta frame_dt)
     {
         FloatVector2 trace_vector(frame_dt * Velocity());
         FloatVector2 trace_start(Translation() - 0.5f * trace_vector);
-        Engine2::Circle::LineTraceBindingSet line_trace_binding_set;
         ASSERT1(GetObjectLayer() != NULL);
         GetPhysicsHandler()->LineTrace(
             *GetObjectLayer(),
@@ -353,16 +352,16 @@ void Missile::Think (Time time, Time::Delta frame_dt)
             trace_vector,
             PhysicalRadius(),
             false,
-            line_trace_binding_set);
+            m_line_trace_binding_vector);
 
         FloatVector2 collision_normal(trace_vector.Normalization());
-        for (Engine2::Circle::LineTraceBindingSet::iterator
-                it = line_trace_binding_set.begin(),
-                it_end = line_trace_binding_set.end();
+        for (Engine2::Circle::LineTraceBindingVector::iterator
+                it = m_line_trace_binding_vector.begin(),
+                it_end = m_line_trace_binding_vector.end();
              it != it_end;
              ++it)
         {
-            if (CheckIfItShouldDetonate(*DStaticCast<Entity *>(&it->m_entity), time, frame_dt))
+            if (CheckIfItShouldDetonate(*DStaticCast<Entity *>(it->m_entity), time, frame_dt))
             {
                 Detonate(time, frame_dt);
                 break;
@@ -489,15 +488,15 @@ void GuidedMissile::Think (Time time, Time::Delta frame_dt)
     Missile::Think(time, frame_dt);
 }
 
-EntityReference<Ship> GuidedMissile::FindTarget (Engine2::Circle::LineTraceBindingSet const &scan_set)
+EntityReference<Ship> GuidedMissile::FindTarget (Engine2::Circle::LineTraceBindingVector const &scan_set)
 {
-    for (Engine2::Circle::LineTraceBindingSet::const_iterator
+    for (Engine2::Circle::LineTraceBindingVector::const_iterator
             it = scan_set.begin(),
             it_end = scan_set.end();
          it != it_end;
          ++it)
     {
-        Entity &entity = *DStaticCast<Entity *>(&it->m_entity);
+        Entity &entity = *DStaticCast<Entity *>(it->m_entity);
         if (entity.IsShip() && &entity != *m_owner)
             return entity.GetReference();
     }
@@ -522,7 +521,6 @@ void GuidedMissile::Search (Time time, Time::Delta frame_dt)
         static Float const s_search_distance = 400.0f;
         static Float const s_search_radius = 70.0f;
 
-        Engine2::Circle::LineTraceBindingSet line_trace_binding_set;
         ASSERT1(GetObjectLayer() != NULL);
         GetPhysicsHandler()->LineTrace(
             *GetObjectLayer(),
@@ -530,9 +528,9 @@ void GuidedMissile::Search (Time time, Time::Delta frame_dt)
             s_search_distance * Math::UnitVector(Angle()),
             s_search_radius,
             false,
-            line_trace_binding_set);
+            m_line_trace_binding_vector);
 
-        m_target = FindTarget(line_trace_binding_set);
+        m_target = FindTarget(m_line_trace_binding_vector);
     }
 }
 
@@ -598,15 +596,15 @@ void GuidedMissile::AimAt (FloatVector2 const &position)
 //
 // ///////////////////////////////////////////////////////////////////////////
 
-EntityReference<Ship> GuidedEnemyMissile::FindTarget (Engine2::Circle::LineTraceBindingSet const &scan_set)
+EntityReference<Ship> GuidedEnemyMissile::FindTarget (Engine2::Circle::LineTraceBindingVector const &scan_set)
 {
-    for (Engine2::Circle::LineTraceBindingSet::const_iterator
+    for (Engine2::Circle::LineTraceBindingVector::const_iterator
             it = scan_set.begin(),
             it_end = scan_set.end();
          it != it_end;
          ++it)
     {
-        Entity &entity = *DStaticCast<Entity *>(&it->m_entity);
+        Entity &entity = *DStaticCast<Entity *>(it->m_entity);
         if (entity.GetEntityType() == ET_SOLITARY)
             return entity.GetReference();
     }
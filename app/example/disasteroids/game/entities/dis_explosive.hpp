@@ -197,6 +197,9 @@ protected:
     static Float const ms_acceleration[UPGRADE_LEVEL_COUNT];
 
     Time::Delta m_time_to_live;
+    // reusable storage for the line traces done in Think, so that they
+    // don't allocate memory every frame.
+    Engine2::Circle::LineTraceBindingVector m_line_trace_binding_vector;
 
 private:
 
@@ -250,7 +253,7 @@ public:
 
 protected:
 
-    virtual EntityReference<Ship> FindTarget (Engine2::Circle::LineTraceBindingSet const &scan_set);
+    virtual EntityReference<Ship> FindTarget (Engine2::Circle::LineTraceBindingVector const &scan_set);
 
 private:
 
@@ -296,7 +299,7 @@ public:
 
 protected:
 
-    virtual EntityReference<Ship> FindTarget (Engine2::Circle::LineTraceBindingSet const &scan_set);
+    virtual EntityReference<Ship> FindTarget (Engine2::Circle::LineTraceBindingVector const &scan_set);
 }; // end of class GuidedMissile
 
 } // end of namespace Dis
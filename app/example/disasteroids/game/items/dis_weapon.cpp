@@ -265,19 +265,18 @@ bool Laser::Activate (Float power, bool attack_boost_is_enabled, bool defense_bo
     if (SecondaryInput() > 0.0f &&
         time >= m_time_last_fired + 1.0f / secondary_fire_rate)
     {
-        Engine2::Circle::AreaTraceList area_trace_list;
         ASSERT1(OwnerShip()->GetObjectLayer() != NULL);
         OwnerShip()->GetPhysicsHandler()->AreaTrace(
             *OwnerShip()->GetObjectLayer(),
             OwnerShip()->Translation(),
             ms_secondary_range[UpgradeLevel()] + OwnerShip()->PhysicalRadius(),
             false,
-            area_trace_list);
+            m_area_trace_vector);
 
         Mortal *best_target = NULL;
         Sint32 best_target_priority = 0;
-        for (Engine2::Circle::AreaTraceList::iterator it = area_trace_list.begin(),
-                                                      it_end = area_trace_list.end();
+        for (Engine2::Circle::AreaTraceVector::iterator it = m_area_trace_vector.begin(),
+                                                        it_end = m_area_trace_vector.end();
              it != it_end;
              ++it)
         {
@@ -318,7 +317,6 @@ bool Laser::Activate (Float power, bool attack_boost_is_enabled, bool defense_bo
             }
 
             // do a line trace
-            Engine2::Circle::LineTraceBindingSet line_trace_binding_set;
             ASSERT1(OwnerShip()->GetObjectLayer() != NULL);
             OwnerShip()->GetPhysicsHandler()->LineTrace(
                 *OwnerShip()->GetObjectLayer(),
@@ -326,23 +324,23 @@ bool Laser::Activate (Float power, bool attack_boost_is_enabled, bool defense_bo
                 fire_vector,
                 0.0f,
                 false,
-                line_trace_binding_set);
+                m_line_trace_binding_vector);
 
-            Engine2::Circle::LineTraceBindingSet::iterator it = line_trace_binding_set.begin();
-            Engine2::Circle::LineTraceBindingSet::iterator it_end = line_trace_binding_set.end();
+            Engine2::Circle::LineTraceBindingVector::iterator it = m_line_trace_binding_vector.begin();
+            Engine2::Circle::LineTraceBindingVector::iterator it_end = m_line_trace_binding_vector.end();
             // don't damage the owner of this weapon or powerups
             while (it != it_end &&
-                   (DStaticCast<Entity *>(&it->m_entity)->IsPowerup() ||
-                    DStaticCast<Entity *>(&it->m_entity)->IsBallistic() ||
-                    DStaticCast<Entity *>(&it->m_entity) == OwnerShip()))
+                   (DStaticCast<Entity *>(it->m_entity)->IsPowerup() ||
+                    DStaticCast<Entity *>(it->m_entity)->IsBallistic() ||
+                    DStaticCast<Entity *>(it->m_entity) == OwnerShip()))
             {
                 ++it;
             }
 
             // only fire at ships and explosives
-            if (it != it_end && (DStaticCast<Entity *>(&it->m_entity)->IsShip() || DStaticCast<Entity *>(&it->m_entity)->IsExplosive()))
+            if (it != it_end && (DStaticCast<Entity *>(it->m_entity)->IsShip() || DStaticCast<Entity *>(it->m_entity)->IsExplosive()))
             {
-                DStaticCast<Mortal *>(&it->m_entity)->Damage(
+                DStaticCast<Mortal *>(it->m_entity)->Damage(
                     OwnerShip(),
                     NULL, // laser does not have an Entity medium
                     ms_secondary_impact_damage[UpgradeLevel()] * damage_factor,
@@ -377,7 +375,6 @@ bool Laser::Activate (Float power, bool attack_boost_is_enabled, bool defense_bo
     {
         ASSERT1(power <= PrimaryInput() * frame_dt * ms_max_primary_power_output_rate[UpgradeLevel()]);
 
-        Engine2::Circle::LineTraceBindingSet line_trace_binding_set;
         ASSERT1(OwnerShip()->GetObjectLayer() != NULL);
         OwnerShip()->GetPhysicsHandler()->LineTrace(
             *OwnerShip()->GetObjectLayer(),
@@ -385,13 +382,13 @@ bool Laser::Activate (Float power, bool attack_boost_is_enabled, bool defense_bo
             ms_primary_range[UpgradeLevel()] * MuzzleDirection(),
             ms_beam_radius[UpgradeLevel()],
             false,
-            line_trace_binding_set);
+            m_line_trace_binding_vector);
 
-        Engine2::Circle::LineTraceBindingSet::iterator it = line_trace_binding_set.begin();
-        Engine2::Circle::LineTraceBindingSet::iterator it_end = line_trace_binding_set.end();
+        Engine2::Circle::LineTraceBindingVector::iterator it = m_line_trace_binding_vector.begin();
+        Engine2::Circle::LineTraceBindingVector::iterator it_end = m_line_trace_binding_vector.end();
 
         // we don't want to hit the owner of the weapon or non-mortals, so just skip them.
-        while (it != it_end && (&it->m_entity == OwnerShip() || !DStaticCast<Entity *>(&it->m_entity)->IsMortal()))
+        while (it != it_end && (it->m_entity == OwnerShip() || !DStaticCast<Entity *>(it->m_entity)->IsMortal()))
             ++it;
 
         FloatVector2 laser_beam_hit_location(
@@ -403,9 +400,9 @@ bool Laser::Activate (Float power, bool attack_boost_is_enabled, bool defense_bo
                 power / (frame_dt * ms_max_primary_power_output_rate[UpgradeLevel()]);
             laser_beam_hit_location =
                 MuzzleLocation() + it->m_clamped_trace_hit_parameter * ms_primary_range[UpgradeLevel()] * MuzzleDirection();
-            if (DStaticCast<Entity *>(&it->m_entity)->IsMortal())
+            if (DStaticCast<Entity *>(it->m_entity)->IsMortal())
             {
-                DStaticCast<Mortal *>(&it->m_entity)->Damage(
+                DStaticCast<Mortal *>(it->m_entity)->Damage(
                     OwnerShip(),
                     NULL, // laser does not have a Entity medium
                     ms_damage_rate[UpgradeLevel()] * damage_factor * ratio_of_max_power_output * frame_dt,
@@ -588,7 +585,6 @@ bool GaussGun::Activate (Float power, bool attack_boost_is_enabled, bool defense
     ASSERT1(OwnerShip()->GetObjectLayer() != NULL);
 
     // do a line trace
-    Engine2::Circle::LineTraceBindingSet line_trace_binding_set;
     ASSERT1(OwnerShip()->GetObjectLayer() != NULL);
     OwnerShip()->GetPhysicsHandler()->LineTrace(
         *OwnerShip()->GetObjectLayer(),
@@ -596,10 +592,10 @@ bool GaussGun::Activate (Float power, bool attack_boost_is_enabled, bool defense
         ms_range[UpgradeLevel()] * MuzzleDirection(),
         0.0f,
         false,
-        line_trace_binding_set);
+        m_line_trace_binding_vector);
 
-    Engine2::Circle::LineTraceBindingSet::iterator it = line_trace_binding_set.begin();
-    Engine2::Circle::LineTraceBindingSet::iterator it_end = line_trace_binding_set.end();
+    Engine2::Circle::LineTraceBindingVector::iterator it = m_line_trace_binding_vector.begin();
+    Engine2::Circle::LineTraceBindingVector::iterator it_end = m_line_trace_binding_vector.end();
 
     static Float const s_impact_particle_spread_angle = 70.0f;
     static Uint32 const s_impact_particle_count = 8;
@@ -623,7 +619,7 @@ bool GaussGun::Activate (Float power, bool attack_boost_is_enabled, bool defense
     {
         // we don't want to hit the owner of this weapon or powerups
         // (continue without updating the furthest hit time)
-        if (&it->m_entity == OwnerShip() || DStaticCast<Entity *>(&it->m_entity)->IsPowerup())
+        if (it->m_entity == OwnerShip() || DStaticCast<Entity *>(it->m_entity)->IsPowerup())
         {
             ++it;
             continue;
@@ -632,10 +628,10 @@ bool GaussGun::Activate (Float power, bool attack_boost_is_enabled, bool defense
         first_hit_registered = true;
 
         furthest_hit_parameter = it->m_clamped_trace_hit_parameter;
-        if (DStaticCast<Entity *>(&it->m_entity)->IsMortal())
+        if (DStaticCast<Entity *>(it->m_entity)->IsMortal())
         {
             FloatVector2 impact_location(MuzzleLocation() + it->m_clamped_trace_hit_parameter * ms_range[UpgradeLevel()] * MuzzleDirection());
-            FloatVector2 impact_normal(OwnerShip()->GetObjectLayer()->AdjustedDifference(impact_location, it->m_entity.Translation()));
+            FloatVector2 impact_normal(OwnerShip()->GetObjectLayer()->AdjustedDifference(impact_location, it->m_entity->Translation()));
             if (impact_normal.LengthSquared() > 0.0001f)
                 impact_normal.Normalize();
             else
@@ -644,9 +640,9 @@ bool GaussGun::Activate (Float power, bool attack_boost_is_enabled, bool defense
             // add knockback momentum to the target (BEFORE damaging it)
             // TODO: possibly add a cap on the added speed (hitting a small asteroid
             // with the best gauss gun is hilarious otherwise)
-            it->m_entity.AccumulateMomentum(-damage_factor * ms_knockback_momentum[UpgradeLevel()] * impact_normal);
+            it->m_entity->AccumulateMomentum(-damage_factor * ms_knockback_momentum[UpgradeLevel()] * impact_normal);
 
-            DStaticCast<Mortal *>(&it->m_entity)->Damage(
+            DStaticCast<Mortal *>(it->m_entity)->Damage(
                 OwnerShip(),
                 NULL, // gauss gun does not have a Entity medium
                 damage_left_to_inflict,
@@ -665,7 +661,7 @@ bool GaussGun::Activate (Float power, bool attack_boost_is_enabled, bool defense
                 time,
                 impact_location,
                 impact_normal,
-                it->m_entity.Velocity(),
+                it->m_entity->Velocity(),
                 Math::RandomFloat(-10.0f, 10.0f),           // seed angle
                 damage_amount_used / total_damage_to_inflict * seed_radius,
                 s_impact_particle_count,
@@ -1031,18 +1027,17 @@ bool Tractor::Activate (Float power, bool attack_boost_is_enabled, bool defense_
             MuzzleLocation();
     }
 
-    Engine2::Circle::AreaTraceList area_trace_list;
     ASSERT1(OwnerShip()->GetObjectLayer() != NULL);
     OwnerShip()->GetPhysicsHandler()->AreaTrace(
         *OwnerShip()->GetObjectLayer(),
         reticle_coordinates,
         beam_radius,
         false,
-        area_trace_list);
+        m_area_trace_vector);
 
     Polynomial::SolutionSet solution_set;
-    for (Engine2::Circle::AreaTraceList::iterator it = area_trace_list.begin(),
-                                                  it_end = area_trace_list.end();
+    for (Engine2::Circle::AreaTraceVector::iterator it = m_area_trace_vector.begin(),
+                                                    it_end = m_area_trace_vector.end();
          it != it_end;
          ++it)
     {
@@ -1127,18 +1122,17 @@ bool AdvancedTractor::Activate (Float power, bool attack_boost_is_enabled, bool
             MuzzleLocation();
     }
 
-    Engine2::Circle::AreaTraceList area_trace_list;
     ASSERT1(OwnerShip()->GetObjectLayer() != NULL);
     OwnerShip()->GetPhysicsHandler()->AreaTrace(
         *OwnerShip()->GetObjectLayer(),
         reticle_coordinates,
         beam_radius,
         false,
-        area_trace_list);
+        m_area_trace_vector);
 
     Polynomial::SolutionSet solution_set;
-    for (Engine2::Circle::AreaTraceList::iterator it = area_trace_list.begin(),
-                                                  it_end = area_trace_list.end();
+    for (Engine2::Circle::AreaTraceVector::iterator it = m_area_trace_vector.begin(),
+                                                    it_end = m_area_trace_vector.end();
          it != it_end;
          ++it)
     {
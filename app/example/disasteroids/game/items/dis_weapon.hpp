@@ -66,6 +66,11 @@ protected:
     FloatVector2 const &MuzzleDirection () const { return m_muzzle_direction; }
     FloatVector2 const &ReticleCoordinates () const { return m_reticle_coordinates; }
 
+    // reusable storage for the traces done in Activate, so that firing
+    // doesn't allocate memory once these have grown to size.
+    Engine2::Circle::AreaTraceVector m_area_trace_vector;
+    Engine2::Circle::LineTraceBindingVector m_line_trace_binding_vector;
+
 private:
 
     // inputs
@@ -165,6 +165,16 @@ GameWidget::GameWidget (World *world, WidgetContext &context)
             m_debug_info_layout->AttachChild(m_bind_texture_call_hit_percent_label);
     //         m_bind_texture_call_hit_percent_label->Hide(); // for now
 
+            m_quad_tree_re_add_skip_percent_label =
+                new ValueLabel<Uint32>(
+                    "%u%% quadtree re-adds skipped",
+                    Util::TextToUint<Uint32>,
+                    context,
+                    "quadtree re-add skip percent label");
+            m_quad_tree_re_add_skip_percent_label->SetIsHeightFixedToTextHeight(true);
+            m_quad_tree_re_add_skip_percent_label->SetAlignment(Dim::X, RIGHT);
+            m_debug_info_layout->AttachChild(m_quad_tree_re_add_skip_percent_label);
+
             m_framerate_label =
                 new ValueLabel<Float>(
                     "%.1f fps",
@@ -486,6 +496,12 @@ void GameWidget::SetBindTextureCallHitPercent (Uint32 bind_texture_call_hit_perc
     m_bind_texture_call_hit_percent_label->SetValue(bind_texture_call_hit_percent);
 }
 
+void GameWidget::SetQuadTreeReAddSkipPercent (Uint32 quad_tree_re_add_skip_percent)
+{
+    ASSERT1(m_quad_tree_re_add_skip_percent_label != NULL);
+    m_quad_tree_re_add_skip_percent_label->SetValue(quad_tree_re_add_skip_percent);
+}
+
 void GameWidget::SetFramerate (Float const framerate)
 {
     ASSERT1(m_framerate_label != NULL);
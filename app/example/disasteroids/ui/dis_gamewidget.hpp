@@ -58,6 +58,7 @@ public:
     void SetEntityCount (Uint32 entity_count);
     void SetBindTextureCallCount (Uint32 bind_texture_call_count);
     void SetBindTextureCallHitPercent (Uint32 bind_texture_call_hit_percent);
+    void SetQuadTreeReAddSkipPercent (Uint32 quad_tree_re_add_skip_percent);
     void SetFramerate (Float framerate);
 
     void SetMineralInventory (Uint8 mineral_index, Float mineral_inventory);
@@ -92,6 +93,7 @@ private:
     ValueLabel<Uint32> *m_entity_count_label;
     ValueLabel<Uint32> *m_bind_texture_call_count_label;
     ValueLabel<Uint32> *m_bind_texture_call_hit_percent_label;
+    ValueLabel<Uint32> *m_quad_tree_re_add_skip_percent_label;
     ValueLabel<Float> *m_framerate_label;
 
     Layout *m_stats_and_inventory_layout;
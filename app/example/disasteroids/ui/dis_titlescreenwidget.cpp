@@ -286,6 +286,7 @@ void TitleScreenWidget::ScheduleStateMachineInput (StateMachineInput input, Time
 void TitleScreenWidget::CancelScheduledStateMachineInput ()
 {
     OwnerEventQueue()->ScheduleMatchingEventsForDeletion(
+        *this,
         MatchEventType,
         Event::STATE_MACHINE_INPUT);
 }
@@ -849,6 +849,7 @@ void WorldView::ScheduleStateMachineInput (StateMachineInput input, Time::Delta
 void WorldView::CancelScheduledStateMachineInput ()
 {
     OwnerEventQueue()->ScheduleMatchingEventsForDeletion(
+        *this,
         MatchEventType,
         Event::STATE_MACHINE_INPUT);
 }
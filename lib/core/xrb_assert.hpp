@@ -43,7 +43,7 @@ int assert_name (int an_error_here_indicates_a_compile_time_assert[(x) ? 1 : -1]
 // and will produce a compile error on conditions that are decidable during
 // compilation (e.g. "sizeof(something) == 4").
 #define CODE_SCOPE_COMPILE_TIME_ASSERT(x) \
-ThisCompileErrorIsActuallyAFailedCompileTimeAssert<static_cast<bool>(x)>::BLAH;
+static_cast<void>(ThisCompileErrorIsActuallyAFailedCompileTimeAssert<static_cast<bool>(x)>::BLAH);
 
 // ///////////////////////////////////////////////////////////////////////////
 // run-time assert macros
@@ -20,17 +20,33 @@ namespace Xrb {
 namespace Engine2 {
 namespace Circle {
 
-CollisionQuadTree::CollisionQuadTree (FloatVector2 const &center, Float half_side_length, Uint8 depth)
+namespace {
+
+// lets CollisionQuadTree::LineTraceTemplate add to either container type
+inline void AddLineTraceBinding (LineTraceBindingSet &line_trace_binding_set, LineTraceBinding const &binding)
+{
+    line_trace_binding_set.insert(binding);
+}
+
+inline void AddLineTraceBinding (LineTraceBindingVector &line_trace_binding_vector, LineTraceBinding const &binding)
+{
+    line_trace_binding_vector.push_back(binding);
+}
+
+} // end of anonymous namespace
+
+CollisionQuadTree::CollisionQuadTree (FloatVector2 const &center, Float half_side_length, Uint8 depth, Float bound_factor, Uint32 split_threshold)
     :
     QuadTree(NULL)
 {
-    Initialize<CollisionQuadTree>(center, half_side_length, depth);
+    Initialize<CollisionQuadTree>(center, half_side_length, depth, split_threshold);
     SetQuadTreeType(QTT_PHYSICS_HANDLER);
+    SetBoundFactor(bound_factor);
 }
 
-CollisionQuadTree *CollisionQuadTree::Create (Float half_side_length, Uint8 depth)
+CollisionQuadTree *CollisionQuadTree::Create (Float half_side_length, Uint8 depth, Float bound_factor, Uint32 split_threshold)
 {
-    return new CollisionQuadTree(FloatVector2::ms_zero, half_side_length, depth);
+    return new CollisionQuadTree(FloatVector2::ms_zero, half_side_length, depth, bound_factor, split_threshold);
 }
 
 bool CollisionQuadTree::DoesAreaOverlapAnyEntity (
@@ -48,8 +64,8 @@ bool CollisionQuadTree::DoesAreaOverlapAnyEntity (
         return false;
 
     // check if the area overlaps any object in this node's list.
-    for (ObjectSet::const_iterator it = m_object_set.begin(),
-                                   it_end = m_object_set.end();
+    for (ObjectVector::const_iterator it = m_object_vector.begin(),
+                                      it_end = m_object_vector.end();
          it != it_end;
          ++it)
     {
@@ -94,6 +110,49 @@ void CollisionQuadTree::LineTrace (
     bool check_nonsolid_collision_entities,
     LineTraceBindingSet &line_trace_binding_set,
     ObjectLayer const &object_layer) const
+{
+    LineTraceTemplate(trace_start, trace_vector, trace_radius, check_nonsolid_collision_entities, line_trace_binding_set, object_layer);
+}
+
+void CollisionQuadTree::LineTrace (
+    FloatVector2 const &trace_start,
+    FloatVector2 const &trace_vector,
+    Float trace_radius,
+    bool check_nonsolid_collision_entities,
+    LineTraceBindingVector &line_trace_binding_vector,
+    ObjectLayer const &object_layer) const
+{
+    LineTraceTemplate(trace_start, trace_vector, trace_radius, check_nonsolid_collision_entities, line_trace_binding_vector, object_layer);
+}
+
+void CollisionQuadTree::AreaTrace (
+    FloatVector2 const &trace_area_center,
+    Float trace_area_radius,
+    bool check_nonsolid_collision_entities,
+    AreaTraceList &area_trace_list,
+    ObjectLayer const &object_layer) const
+{
+    AreaTraceTemplate(trace_area_center, trace_area_radius, check_nonsolid_collision_entities, area_trace_list, object_layer);
+}
+
+void CollisionQuadTree::AreaTrace (
+    FloatVector2 const &trace_area_center,
+    Float trace_area_radius,
+    bool check_nonsolid_collision_entities,
+    AreaTraceVector &area_trace_vector,
+    ObjectLayer const &object_layer) const
+{
+    AreaTraceTemplate(trace_area_center, trace_area_radius, check_nonsolid_collision_entities, area_trace_vector, object_layer);
+}
+
+template <typename LineTraceBindingContainer>
+void CollisionQuadTree::LineTraceTemplate (
+    FloatVector2 const &trace_start,
+    FloatVector2 const &trace_vector,
+    Float trace_radius,
+    bool check_nonsolid_collision_entities,
+    LineTraceBindingContainer &line_trace_binding_container,
+    ObjectLayer const &object_layer) const
 {
     ASSERT1(!trace_vector.IsZero());
     ASSERT1(trace_radius >= 0.0f);
@@ -103,22 +162,14 @@ void CollisionQuadTree::LineTrace (
         return;
 
     // if this quad node doesn't intersect the line, return
+    if (!DoesLineOverlapQuadBounds(trace_start, trace_vector, trace_radius, object_layer))
+        return;
     Float a = trace_vector | trace_vector;
     ASSERT1(a >= 0.0f);
-    FloatVector2 trace_center(trace_start + 0.5f * trace_vector);
-    {
-        FloatVector2 p_minus_c = object_layer.AdjustedDifference(trace_start, Center());
-        Float R = 2.0f * Radius() + trace_radius;
-        Float b = p_minus_c | trace_vector;
-        Float c = (p_minus_c | p_minus_c) - R * R;
-        Float determinant = b * b - a * c;
-        if (determinant < 0.0f)
-            return;
-    }
 
     // check the line against the objects in this node
-    for (ObjectSet::iterator it = m_object_set.begin(),
-                             it_end = m_object_set.end();
+    for (ObjectVector::const_iterator it = m_object_vector.begin(),
+                                      it_end = m_object_vector.end();
          it != it_end;
          ++it)
     {
@@ -154,26 +205,27 @@ void CollisionQuadTree::LineTrace (
         if (t1 < 0.0f)
             continue;
 
-        line_trace_binding_set.insert(LineTraceBinding(t0, entity));
+        AddLineTraceBinding(line_trace_binding_container, LineTraceBinding(t0, t1, entity));
     }
 
     // call this function on the child nodes, if they exist
     if (HasChildren())
         for (Uint8 i = 0; i < 4; ++i)
-            Child<CollisionQuadTree>(i)->LineTrace(
+            Child<CollisionQuadTree>(i)->LineTraceTemplate(
                 trace_start,
                 trace_vector,
                 trace_radius,
                 check_nonsolid_collision_entities,
-                line_trace_binding_set,
+                line_trace_binding_container,
                 object_layer);
 }
 
-void CollisionQuadTree::AreaTrace (
+template <typename AreaTraceContainer>
+void CollisionQuadTree::AreaTraceTemplate (
     FloatVector2 const &trace_area_center,
     Float trace_area_radius,
     bool check_nonsolid_collision_entities,
-    AreaTraceList &area_trace_list,
+    AreaTraceContainer &area_trace_container,
     ObjectLayer const &object_layer) const
 {
     ASSERT1(trace_area_radius > 0.0f);
@@ -189,16 +241,16 @@ void CollisionQuadTree::AreaTrace (
     // call this function on the child nodes, if they exist
     if (HasChildren())
         for (Uint8 i = 0; i < 4; ++i)
-            Child<CollisionQuadTree>(i)->AreaTrace(
+            Child<CollisionQuadTree>(i)->AreaTraceTemplate(
                 trace_area_center,
                 trace_area_radius,
                 check_nonsolid_collision_entities,
-                area_trace_list,
+                area_trace_container,
                 object_layer);
 
     // check the line against the objects in this node
-    for (ObjectSet::iterator it = m_object_set.begin(),
-                             it_end = m_object_set.end();
+    for (ObjectVector::const_iterator it = m_object_vector.begin(),
+                                      it_end = m_object_vector.end();
          it != it_end;
          ++it)
     {
@@ -219,10 +271,31 @@ void CollisionQuadTree::AreaTrace (
         if (center_to_center.Length() >= entity.Radius(GetQuadTreeType()) + trace_area_radius)
             continue;
 
-        area_trace_list.push_back(&entity);
+        area_trace_container.push_back(&entity);
     }
 }
 
+bool CollisionQuadTree::DoesLineOverlapQuadBounds (
+    FloatVector2 const &trace_start,
+    FloatVector2 const &trace_vector,
+    Float trace_radius,
+    ObjectLayer const &object_layer) const
+{
+    Float a = trace_vector | trace_vector;
+    ASSERT1(a >= 0.0f);
+    FloatVector2 p_minus_c = object_layer.AdjustedDifference(trace_start, Center());
+    Float R = BoundingRadius() + trace_radius;
+    Float b = p_minus_c | trace_vector;
+    Float c = (p_minus_c | p_minus_c) - R * R;
+    Float determinant = b * b - a * c;
+    if (determinant < 0.0f)
+        return false;
+    // the line intersects the node's bounding circle, but the traced
+    // segment may lie entirely before or after it.
+    Float radical_part = Math::Sqrt(determinant);
+    return -b - radical_part <= a && -b + radical_part >= 0.0f;
+}
+
 void CollisionQuadTree::CollideEntity (Entity &entity, Time::Delta frame_dt, CollisionPairList &collision_pair_list) const
 {
     ASSERT1(entity.GetCollisionType() != Engine2::Circle::CT_NO_COLLISION);
@@ -242,7 +315,7 @@ void CollisionQuadTree::CollideEntity (CollisionQuadTree::CollideEntityLoopFunct
         return;
 
     // here is the actual entity loop
-    std::for_each(m_object_set.begin(), m_object_set.end(), functor);
+    std::for_each(m_object_vector.begin(), m_object_vector.end(), functor);
 
     // if there are child nodes, call CollideEntity on each
     if (HasChildren())
@@ -279,10 +352,8 @@ void CollisionQuadTree::CollideEntityLoopFunctor::operator () (Object *object)
         return;
     }
 
-    FloatVector2 ce0_translation(m_entity.Translation());
-    FloatVector2 ce1_translation(object->Translation());
     Float r = m_entity.Radius(QTT_PHYSICS_HANDLER) + object->Radius(QTT_PHYSICS_HANDLER);
-    FloatVector2 offset_0_to_1(m_object_layer.AdjustedDifference(ce1_translation, ce0_translation));
+    FloatVector2 offset_0_to_1(m_object_layer.AdjustedDifference(object->Translation(), m_entity.Translation()));
 
     if (offset_0_to_1.LengthSquared() >= Sqr(r))
         return;
@@ -295,36 +366,7 @@ void CollisionQuadTree::CollideEntityLoopFunctor::operator () (Object *object)
     ASSERT1(m_entity.GetPhysicsHandler() == other_entity.GetPhysicsHandler());
     PhysicsHandler &physics_handler = *m_entity.GetPhysicsHandler();
 
-    // NOTE: we're not worrying about elliptical shapes here, just pretend each Entity's
-    // physical shape is a circle.
-
-    FloatVector2 collision_location(
-        (other_entity.PhysicalRadius() * ce0_translation + m_entity.PhysicalRadius() * ce1_translation)
-        /
-        (m_entity.PhysicalRadius() + other_entity.PhysicalRadius()));
-    FloatVector2 collision_normal_0_to_1;
-    if (offset_0_to_1.IsZero())
-        collision_normal_0_to_1 = FloatVector2(1.0f, 0.0f);
-    else
-        collision_normal_0_to_1 = offset_0_to_1.Normalization();
-    Float collision_force = 0.0f; // to be determined by PhysicsHandler::CollisionResponse
-
-    // check if we should proceed with physical collision response
-    if (m_entity.GetCollisionType() == Engine2::Circle::CT_SOLID_COLLISION && // if they're both solid
-        other_entity.GetCollisionType() == Engine2::Circle::CT_SOLID_COLLISION &&
-        !physics_handler.CollisionExemption(m_entity, other_entity)) // and if this isn't an exception
-    {
-        collision_force = physics_handler.CollisionResponse(m_entity, other_entity, offset_0_to_1, m_frame_dt, collision_location, collision_normal_0_to_1);
-    }
-
-    // record the collision in the collision pair list.
-    m_collision_pair_list.push_back(
-        CollisionPair(
-            &m_entity,
-            &other_entity,
-            collision_location,
-            collision_normal_0_to_1,
-            collision_force));
+    physics_handler.RecordCollision(m_entity, other_entity, offset_0_to_1, m_frame_dt, m_collision_pair_list);
 }
 
 } // end of namespace Circle
@@ -26,10 +26,13 @@ class CollisionQuadTree : public QuadTree
 {
 public:
 
-    CollisionQuadTree (FloatVector2 const &center, Float half_side_length, Uint8 depth);
+    // see QuadTree::BoundFactor for bound_factor, and the comment above
+    // QuadTree for split_threshold (a nonzero value makes the tree adaptive,
+    // with depth being the maximum depth).
+    CollisionQuadTree (FloatVector2 const &center, Float half_side_length, Uint8 depth, Float bound_factor = 2.0f, Uint32 split_threshold = 0);
     virtual ~CollisionQuadTree () { }
 
-    static CollisionQuadTree *Create (Float half_side_length, Uint8 depth);
+    static CollisionQuadTree *Create (Float half_side_length, Uint8 depth, Float bound_factor = 2.0f, Uint32 split_threshold = 0);
 
     bool DoesAreaOverlapAnyEntity (
         FloatVector2 const &area_center,
@@ -44,6 +47,14 @@ public:
         bool check_nonsolid_collision_entities,
         LineTraceBindingSet &line_trace_binding_set,
         ObjectLayer const &object_layer) const;
+    // appends the hits to line_trace_binding_vector, in no particular order
+    void LineTrace (
+        FloatVector2 const &trace_start,
+        FloatVector2 const &trace_vector,
+        Float trace_radius,
+        bool check_nonsolid_collision_entities,
+        LineTraceBindingVector &line_trace_binding_vector,
+        ObjectLayer const &object_layer) const;
 
     // will never add a NULL entity to an AreaTraceList
     void AreaTrace (
@@ -52,17 +63,52 @@ public:
         bool check_nonsolid_collision_entities,
         AreaTraceList &area_trace_list,
         ObjectLayer const &object_layer) const;
+    // will never add a NULL entity to an AreaTraceVector
+    void AreaTrace (
+        FloatVector2 const &trace_area_center,
+        Float trace_area_radius,
+        bool check_nonsolid_collision_entities,
+        AreaTraceVector &area_trace_vector,
+        ObjectLayer const &object_layer) const;
 
     void CollideEntity (Entity &entity, Time::Delta frame_dt, CollisionPairList &collision_pair_list) const;
 
 protected:
 
-    CollisionQuadTree (CollisionQuadTree *parent) : QuadTree(parent) { }
+    // used (with no parent) by QuadTree::Initialize to allocate its node pool
+    CollisionQuadTree (CollisionQuadTree *parent = NULL) : QuadTree(parent) { }
+
+    friend class QuadTree;
 
 private:
 
     class CollideEntityLoopFunctor;
 
+    // the implementations of the LineTrace and AreaTrace overloads, which
+    // differ only in the container the results are added to.
+    template <typename LineTraceBindingContainer>
+    void LineTraceTemplate (
+        FloatVector2 const &trace_start,
+        FloatVector2 const &trace_vector,
+        Float trace_radius,
+        bool check_nonsolid_collision_entities,
+        LineTraceBindingContainer &line_trace_binding_container,
+        ObjectLayer const &object_layer) const;
+    template <typename AreaTraceContainer>
+    void AreaTraceTemplate (
+        FloatVector2 const &trace_area_center,
+        Float trace_area_radius,
+        bool check_nonsolid_collision_entities,
+        AreaTraceContainer &area_trace_container,
+        ObjectLayer const &object_layer) const;
+
+    // the node culling test of LineTrace
+    bool DoesLineOverlapQuadBounds (
+        FloatVector2 const &trace_start,
+        FloatVector2 const &trace_vector,
+        Float trace_radius,
+        ObjectLayer const &object_layer) const;
+
     void CollideEntity (CollideEntityLoopFunctor &functor) const;
 
     // instead of passing all these parameters into each call of a quad
@@ -30,6 +30,7 @@ Entity::Entity (CollisionType collision_type)
     m_velocity = FloatVector2::ms_zero;
     m_force = FloatVector2::ms_zero;
     m_angular_velocity = 0.0f;
+    m_is_using_continuous_collision = false;
 }
 
 PhysicsHandler const *Entity::GetPhysicsHandler () const
@@ -78,6 +79,7 @@ void Entity::CloneProperties (Entity const &entity)
     m_velocity = entity.m_velocity;
     m_force = entity.m_force;
     m_angular_velocity = entity.m_angular_velocity;
+    m_is_using_continuous_collision = entity.m_is_using_continuous_collision;
 }
 
 void Entity::ApplyInterceptCourseAcceleration (
@@ -49,6 +49,7 @@ public:
     FloatVector2 Momentum () const { return m_mass * m_velocity; }
     FloatVector2 const &Force () const { return m_force; }
     Float AngularVelocity () const { return m_angular_velocity; }
+    bool IsUsingContinuousCollision () const { return m_is_using_continuous_collision; }
 
     FloatVector2 AmbientVelocity (Float scan_area_radius) const;
 
@@ -100,6 +101,13 @@ public:
         ASSERT_NAN_SANITY_CHECK(Math::IsFinite(angular_velocity));
         m_angular_velocity = angular_velocity;
     }
+    // if true, PhysicsHandler sweeps this entity's path each frame, so that
+    // it can't pass completely through another entity between frames (meant
+    // for small, fast entities such as bullets).  the default is false.
+    void SetIsUsingContinuousCollision (bool is_using_continuous_collision)
+    {
+        m_is_using_continuous_collision = is_using_continuous_collision;
+    }
 
     // ///////////////////////////////////////////////////////////////////////
     // public procedures
@@ -228,6 +236,8 @@ private:
     FloatVector2 m_force;
     // angular velocity of the entity (positive is counterclockwise)
     Float m_angular_velocity;
+    // see SetIsUsingContinuousCollision
+    bool m_is_using_continuous_collision;
 }; // end of class Entity
 
 } // end of namespace Circle
@@ -10,6 +10,8 @@
 
 #include "xrb_engine2_circle_physicshandler.hpp"
 
+#include <algorithm>
+
 #include "xrb_engine2_circle_collisionquadtree.hpp"
 #include "xrb_engine2_circle_entity.hpp"
 #include "xrb_engine2_objectlayer.hpp"
@@ -23,7 +25,12 @@ PhysicsHandler::PhysicsHandler ()
     :
     Engine2::PhysicsHandler()
 {
+    m_broad_phase = BP_QUAD_TREE;
+    m_is_using_packed_integration = false;
     m_main_object_layer = NULL;
+    m_quad_tree_bound_factor = 2.0f;
+    m_quad_tree_depth = 5;
+    m_quad_tree_split_threshold = 0;
     m_quad_tree = NULL;
 }
 
@@ -69,6 +76,29 @@ void PhysicsHandler::LineTrace (
         *m_main_object_layer);
 }
 
+void PhysicsHandler::LineTrace (
+    ObjectLayer const &object_layer,
+    FloatVector2 const &trace_start,
+    FloatVector2 const &trace_vector,
+    Float trace_radius,
+    bool check_nonsolid_collision_entities,
+    LineTraceBindingVector &line_trace_binding_vector) const
+{
+    ASSERT1(&object_layer == m_main_object_layer);
+    ASSERT1(trace_radius >= 0.0f);
+    ASSERT1(trace_vector.Length() <= 0.5f * m_main_object_layer->SideLength());
+    line_trace_binding_vector.clear();
+    m_quad_tree->LineTrace(
+        trace_start,
+        trace_vector,
+        trace_radius,
+        check_nonsolid_collision_entities,
+        line_trace_binding_vector,
+        *m_main_object_layer);
+    // the hits are collected in quadtree order, so sort them once here.
+    std::sort(line_trace_binding_vector.begin(), line_trace_binding_vector.end(), OrderLineTraceBindingsByTime());
+}
+
 void PhysicsHandler::AreaTrace (
     ObjectLayer const &object_layer,
     FloatVector2 trace_area_center,
@@ -86,6 +116,24 @@ void PhysicsHandler::AreaTrace (
         *m_main_object_layer);
 }
 
+void PhysicsHandler::AreaTrace (
+    ObjectLayer const &object_layer,
+    FloatVector2 trace_area_center,
+    Float trace_area_radius,
+    bool check_nonsolid_collision_entities,
+    AreaTraceVector &area_trace_vector) const
+{
+    ASSERT1(&object_layer == m_main_object_layer);
+    ASSERT1(trace_area_radius > 0.0f);
+    area_trace_vector.clear();
+    m_quad_tree->AreaTrace(
+        trace_area_center,
+        trace_area_radius,
+        check_nonsolid_collision_entities,
+        area_trace_vector,
+        *m_main_object_layer);
+}
+
 void PhysicsHandler::CalculateAmbientMomentum (
     ObjectLayer const &object_layer,
     FloatVector2 const &scan_area_center,
@@ -132,7 +180,11 @@ void PhysicsHandler::SetMainObjectLayer (ObjectLayer &object_layer)
     m_main_object_layer = &object_layer;
     // now that the main object layer is set, we can create a
     // collision quadtree to match it.
-    m_quad_tree = CollisionQuadTree::Create(0.5f * m_main_object_layer->SideLength(), 5);
+    m_quad_tree = CollisionQuadTree::Create(
+        0.5f * m_main_object_layer->SideLength(),
+        m_quad_tree_depth,
+        m_quad_tree_bound_factor,
+        m_quad_tree_split_threshold);
 }
 
 void PhysicsHandler::AddEntity (Engine2::Entity &entity)
@@ -215,6 +267,56 @@ Float PhysicsHandler::CollisionResponse (
     return collision_force;
 }
 
+void PhysicsHandler::RecordCollision (
+    Entity &entity0,
+    Entity &entity1,
+    FloatVector2 const &offset_0_to_1,
+    Time::Delta frame_dt,
+    CollisionPairList &collision_pair_list)
+{
+    // NOTE: we're not worrying about elliptical shapes here, just pretend each Entity's
+    // physical shape is a circle.
+
+    FloatVector2 collision_location(
+        (entity1.PhysicalRadius() * entity0.Translation() + entity0.PhysicalRadius() * entity1.Translation())
+        /
+        (entity0.PhysicalRadius() + entity1.PhysicalRadius()));
+    RecordCollision(entity0, entity1, offset_0_to_1, frame_dt, collision_location, collision_pair_list);
+}
+
+void PhysicsHandler::RecordCollision (
+    Entity &entity0,
+    Entity &entity1,
+    FloatVector2 const &offset_0_to_1,
+    Time::Delta frame_dt,
+    FloatVector2 const &collision_location,
+    CollisionPairList &collision_pair_list)
+{
+    FloatVector2 collision_normal_0_to_1;
+    if (offset_0_to_1.IsZero())
+        collision_normal_0_to_1 = FloatVector2(1.0f, 0.0f);
+    else
+        collision_normal_0_to_1 = offset_0_to_1.Normalization();
+    Float collision_force = 0.0f; // to be determined by CollisionResponse
+
+    // check if we should proceed with physical collision response
+    if (entity0.GetCollisionType() == CT_SOLID_COLLISION && // if they're both solid
+        entity1.GetCollisionType() == CT_SOLID_COLLISION &&
+        !CollisionExemption(entity0, entity1)) // and if this isn't an exception
+    {
+        collision_force = CollisionResponse(entity0, entity1, offset_0_to_1, frame_dt, collision_location, collision_normal_0_to_1);
+    }
+
+    // record the collision in the collision pair list.
+    collision_pair_list.push_back(
+        CollisionPair(
+            &entity0,
+            &entity1,
+            collision_location,
+            collision_normal_0_to_1,
+            collision_force));
+}
+
 void PhysicsHandler::HandleFrame ()
 {
     ASSERT1(m_main_object_layer != NULL);
@@ -245,11 +347,19 @@ void PhysicsHandler::HandleFrame ()
                 "use ScheduleForRemovalFromWorld() instead");
     }
 
-    // apply the accumulated forces and torques
-    UpdateVelocities();
+    if (m_is_using_packed_integration)
+    {
+        // apply the accumulated forces and update the positions in one pass
+        UpdateVelocitiesAndPositionsPacked();
+    }
+    else
+    {
+        // apply the accumulated forces and torques
+        UpdateVelocities();
 
-    // update the entities' positions
-    UpdatePositions();
+        // update the entities' positions
+        UpdatePositions();
+    }
 
     // call the collision handlers for the entities.
     // the calls to Entity::Collide_ are done after the velocities and
@@ -322,7 +432,10 @@ void PhysicsHandler::UpdatePositions ()
 
         if (!entity.Velocity().IsZero())
         {
-            entity.Translate(FrameDT() * entity.Velocity());
+            FloatVector2 displacement(FrameDT() * entity.Velocity());
+            if (entity.IsUsingContinuousCollision() && entity.GetCollisionType() != CT_NO_COLLISION)
+                displacement *= SweepContinuousCollisionEntity(entity, displacement);
+            entity.Translate(displacement);
             ASSERT1(entity.GetObjectLayer() != NULL);
             entity.ReAddToQuadTree(QTT_VISIBILITY);
             if (entity.GetCollisionType() != CT_NO_COLLISION)
@@ -337,11 +450,226 @@ void PhysicsHandler::UpdatePositions ()
     }
 }
 
+void PhysicsHandler::UpdateVelocitiesAndPositionsPacked ()
+{
+    Uint32 const entity_count = m_entity_set.size();
+    m_packed_state.Resize(entity_count);
+
+    // copy the physical state into the packed arrays
+    {
+        Uint32 i = 0;
+        for (EntitySet::iterator it = m_entity_set.begin(), it_end = m_entity_set.end(); it != it_end; ++it, ++i)
+        {
+            ASSERT1(*it != NULL);
+            Entity &entity = **it;
+            ASSERT1(entity.Mass() > 0.0f);
+
+            m_packed_state.m_entity[i] = &entity;
+            m_packed_state.m_position_x[i] = entity.Translation()[Dim::X];
+            m_packed_state.m_position_y[i] = entity.Translation()[Dim::Y];
+            m_packed_state.m_velocity_x[i] = entity.Velocity()[Dim::X];
+            m_packed_state.m_velocity_y[i] = entity.Velocity()[Dim::Y];
+            m_packed_state.m_force_x[i] = entity.Force()[Dim::X];
+            m_packed_state.m_force_y[i] = entity.Force()[Dim::Y];
+            m_packed_state.m_mass[i] = entity.Mass();
+            m_packed_state.m_max_speed[i] = MaxSpeed(entity);
+            m_packed_state.m_angular_velocity[i] = entity.AngularVelocity();
+        }
+    }
+
+    // the integration kernel.  this loop has no branches or function calls,
+    // so that the compiler can vectorize it.  the arithmetic is the same as
+    // in UpdateVelocities and UpdatePositions, so the results are identical.
+    if (entity_count > 0)
+    {
+        Float const dt = FrameDT();
+        Float *position_x = &m_packed_state.m_position_x[0];
+        Float *position_y = &m_packed_state.m_position_y[0];
+        Float *velocity_x = &m_packed_state.m_velocity_x[0];
+        Float *velocity_y = &m_packed_state.m_velocity_y[0];
+        Float const *force_x = &m_packed_state.m_force_x[0];
+        Float const *force_y = &m_packed_state.m_force_y[0];
+        Float const *mass = &m_packed_state.m_mass[0];
+        Float const *max_speed = &m_packed_state.m_max_speed[0];
+        for (Uint32 i = 0; i < entity_count; ++i)
+        {
+            Float vx = velocity_x[i] + dt * force_x[i] / mass[i];
+            Float vy = velocity_y[i] + dt * force_y[i] / mass[i];
+            // WHOA THERE BUDDY!  SLOW DOWN!
+            Float speed_squared = vx * vx + vy * vy;
+            Float max_speed_squared = max_speed[i] * max_speed[i];
+            Float scale = (speed_squared > max_speed_squared) ? max_speed[i] / Math::Sqrt(speed_squared) : 1.0f;
+            vx *= scale;
+            vy *= scale;
+            velocity_x[i] = vx;
+            velocity_y[i] = vy;
+            position_x[i] += dt * vx;
+            position_y[i] += dt * vy;
+        }
+    }
+
+    // write the velocities back to the entities.  this is done in its own
+    // loop because SweepContinuousCollisionEntity (below) may accumulate
+    // force on any entity, which must not be reset afterwards.
+    for (Uint32 i = 0; i < entity_count; ++i)
+    {
+        Entity &entity = *m_packed_state.m_entity[i];
+        entity.SetVelocity(FloatVector2(m_packed_state.m_velocity_x[i], m_packed_state.m_velocity_y[i]));
+        entity.ResetForce();
+    }
+
+    // write the positions back to the entities, and reset them in the quadtrees
+    for (Uint32 i = 0; i < entity_count; ++i)
+    {
+        Entity &entity = *m_packed_state.m_entity[i];
+
+        // Entity::SetTranslation also does HandleContainmentOrWrapping and
+        // ReAddToQuadTree for both quadtrees.
+        if (!entity.Velocity().IsZero())
+        {
+            FloatVector2 translation(m_packed_state.m_position_x[i], m_packed_state.m_position_y[i]);
+            if (entity.IsUsingContinuousCollision() && entity.GetCollisionType() != CT_NO_COLLISION)
+            {
+                FloatVector2 displacement(translation - entity.Translation());
+                if (!displacement.IsZero())
+                    translation = entity.Translation() + SweepContinuousCollisionEntity(entity, displacement) * displacement;
+            }
+            entity.SetTranslation(translation);
+        }
+        if (m_packed_state.m_angular_velocity[i] != 0.0f)
+            entity.Rotate(FrameDT() * m_packed_state.m_angular_velocity[i]);
+    }
+}
+
+void PhysicsHandler::PackedState::Resize (Uint32 const size)
+{
+    m_entity.resize(size);
+    m_position_x.resize(size);
+    m_position_y.resize(size);
+    m_velocity_x.resize(size);
+    m_velocity_y.resize(size);
+    m_force_x.resize(size);
+    m_force_y.resize(size);
+    m_mass.resize(size);
+    m_max_speed.resize(size);
+    m_angular_velocity.resize(size);
+}
+
+Float PhysicsHandler::SweepContinuousCollisionEntity (Entity &entity, FloatVector2 const &displacement)
+{
+    ASSERT1(m_main_object_layer != NULL);
+    ASSERT1(m_quad_tree != NULL);
+    ASSERT1(entity.IsUsingContinuousCollision());
+    ASSERT1(entity.GetCollisionType() != CT_NO_COLLISION);
+    ASSERT1(!displacement.IsZero());
+
+    // LineTrace can't handle traces longer than half the ObjectLayer
+    // (they would be ambiguous in a wrapped ObjectLayer), so don't sweep.
+    if (displacement.Length() > 0.5f * m_main_object_layer->SideLength())
+        return 1.0f;
+
+    // trace the entity's path, including nonsolid entities (which are still
+    // owed Collide calls).  the other entities are in whatever position they
+    // are in at the time of this call.
+    Float entity_radius = entity.Radius(QTT_PHYSICS_HANDLER);
+    LineTrace(
+        *m_main_object_layer,
+        entity.Translation(),
+        displacement,
+        entity_radius,
+        true,
+        m_continuous_collision_binding_vector);
+
+    // a solid entity stopped by the previous sweep ends that frame exactly
+    // touching what stopped it, so on this sweep its hit parameter is about
+    // 0, and rounding may put it slightly below.  touching doesn't count as
+    // overlapping in the discrete collision check, so hit parameters this
+    // close to 0 are treated as swept hits.
+    Float const hit_parameter_tolerance = 0.01f * entity_radius / displacement.Length();
+
+    Float displacement_fraction = 1.0f;
+    // the bindings are ordered by hit time
+    for (LineTraceBindingVector::iterator it = m_continuous_collision_binding_vector.begin(),
+                                          it_end = m_continuous_collision_binding_vector.end();
+         it != it_end;
+         ++it)
+    {
+        LineTraceBinding const &binding = *it;
+        Entity &other = *binding.m_entity;
+
+        // anything the entity reaches after it has been stopped doesn't count.
+        if (binding.m_unclamped_trace_hit_parameter > displacement_fraction)
+            break;
+        // the entity can't hit itself.
+        if (&other == &entity)
+            continue;
+        // if the entities were already overlapping at the start of the sweep,
+        // then the discrete collision check in HandleInterpenetrations has
+        // recorded it.
+        if (binding.m_unclamped_trace_hit_parameter < -hit_parameter_tolerance)
+            continue;
+        // a touching entity which is moving away from (or along) the other
+        // one doesn't hit it.
+        if (binding.m_unclamped_trace_hit_parameter <= 0.0f &&
+            (m_main_object_layer->AdjustedDifference(other.Translation(), entity.Translation()) | displacement) <= 0.0f)
+        {
+            continue;
+        }
+        // a solid entity stops the sweep at the point of contact, even if it
+        // would otherwise end the frame overlapping the other one -- the
+        // collision force computed from a deep overlap may push the entity
+        // the rest of the way through.  otherwise, if the entities will still
+        // be overlapping at the end of the sweep, the discrete collision
+        // check will record it.
+        bool is_stopped_by_other =
+            entity.GetCollisionType() == CT_SOLID_COLLISION &&
+            other.GetCollisionType() == CT_SOLID_COLLISION &&
+            !CollisionExemption(entity, other);
+        if (!is_stopped_by_other && binding.m_unclamped_trace_exit_parameter >= 1.0f)
+            continue;
+
+        // record the collision as it was at the time of contact.
+        Float hit_parameter = Max(0.0f, binding.m_unclamped_trace_hit_parameter);
+        Float other_radius = other.Radius(QTT_PHYSICS_HANDLER);
+        FloatVector2 contact_translation(entity.Translation() + hit_parameter * displacement);
+        FloatVector2 offset_to_other(m_main_object_layer->AdjustedDifference(other.Translation(), contact_translation));
+        FloatVector2 collision_location(contact_translation + entity_radius / (entity_radius + other_radius) * offset_to_other);
+        // order the pair the same way CollisionQuadTree::CollideEntity
+        // does: by radius, and then by owner object pointer value.
+        if (entity_radius < other_radius
+            ||
+            (entity_radius == other_radius && entity.OwnerObject() < other.OwnerObject())) // yes, this is a pointer comparison.
+        {
+            RecordCollision(entity, other, offset_to_other, FrameDT(), collision_location, m_collision_pair_list);
+        }
+        else
+        {
+            RecordCollision(other, entity, -offset_to_other, FrameDT(), collision_location, m_collision_pair_list);
+        }
+
+        // the collision force (if any) will be applied on the next frame.
+        if (is_stopped_by_other)
+            displacement_fraction = hit_parameter;
+    }
+
+    return displacement_fraction;
+}
+
 void PhysicsHandler::HandleInterpenetrations ()
 {
     ASSERT1(m_quad_tree != NULL);
     ASSERT1(m_collision_pair_list.empty());
 
+    switch (m_broad_phase)
+    {
+        case BP_QUAD_TREE:      HandleInterpenetrationsUsingQuadTree();     break;
+        case BP_SORT_AND_SWEEP: HandleInterpenetrationsUsingSortAndSweep(); break;
+        default: ASSERT1(false && "invalid BroadPhase"); break;
+    }
+}
+
+void PhysicsHandler::HandleInterpenetrationsUsingQuadTree ()
+{
     for (EntitySet::iterator it = m_entity_set.begin(), it_end = m_entity_set.end(); it != it_end; ++it)
     {
         ASSERT1(*it != NULL);
@@ -356,6 +684,95 @@ void PhysicsHandler::HandleInterpenetrations ()
     }
 }
 
+void PhysicsHandler::HandleInterpenetrationsUsingSortAndSweep ()
+{
+    ASSERT1(m_main_object_layer != NULL);
+
+    ObjectLayer const &object_layer = *m_main_object_layer;
+    bool is_wrapped = object_layer.IsWrapped();
+    Float side_length = object_layer.SideLength();
+    Float half_side_length = 0.5f * side_length;
+
+    // find the largest collision radius, which determines how close to the
+    // right edge of a wrapped layer an entity must be to need a ghost entry.
+    Float max_radius = 0.0f;
+    for (EntitySet::iterator it = m_entity_set.begin(), it_end = m_entity_set.end(); it != it_end; ++it)
+    {
+        ASSERT1(*it != NULL);
+        Entity &entity = **it;
+        if (entity.GetCollisionType() != CT_NO_COLLISION)
+            max_radius = Max(max_radius, entity.Radius(QTT_PHYSICS_HANDLER));
+    }
+
+    // build the list of X-axis intervals
+    m_sweep_entry_vector.clear();
+    for (EntitySet::iterator it = m_entity_set.begin(), it_end = m_entity_set.end(); it != it_end; ++it)
+    {
+        Entity &entity = **it;
+
+        // don't attempt to collide no-collision entities
+        if (entity.GetCollisionType() == CT_NO_COLLISION)
+            continue;
+
+        Float x = entity.Translation()[Dim::X];
+        Float radius = entity.Radius(QTT_PHYSICS_HANDLER);
+        m_sweep_entry_vector.push_back(SweepEntry(x, radius, &entity, false));
+        // any entity which could overlap another across the X seam gets a
+        // ghost entry on the far side of the left edge.
+        if (is_wrapped && x + radius + max_radius > half_side_length)
+            m_sweep_entry_vector.push_back(SweepEntry(x - side_length, radius, &entity, true));
+    }
+
+    std::sort(m_sweep_entry_vector.begin(), m_sweep_entry_vector.end());
+
+    // sweep the sorted list.  each entry only has to be checked against the
+    // entries after it whose intervals start before its interval ends.
+    for (SweepEntryVector::iterator it = m_sweep_entry_vector.begin(), it_end = m_sweep_entry_vector.end(); it != it_end; ++it)
+    {
+        SweepEntry const &entry = *it;
+        for (SweepEntryVector::iterator other_it = it + 1; other_it != it_end && other_it->m_min_x < entry.m_max_x; ++other_it)
+        {
+            SweepEntry const &other_entry = *other_it;
+
+            // an entity and its own ghost, and two ghosts (which duplicate
+            // the un-ghosted pair), are skipped.
+            if (entry.m_entity == other_entry.m_entity || (entry.m_is_ghost && other_entry.m_is_ghost))
+                continue;
+            // in a wrapped layer, the same pair may show up as both a
+            // real/ghost and a ghost/real pairing -- only the pairing whose
+            // X separation is the wrapped (shortest) one is used.
+            if (is_wrapped)
+            {
+                Float dx = other_entry.m_x - entry.m_x;
+                if (dx <= -half_side_length || dx > half_side_length)
+                    continue;
+            }
+
+            // order the pair the same way CollisionQuadTree::CollideEntity
+            // does: by radius, and then by owner object pointer value.
+            Entity *entity0 = entry.m_entity;
+            Entity *entity1 = other_entry.m_entity;
+            if (entity0->Radius(QTT_PHYSICS_HANDLER) > entity1->Radius(QTT_PHYSICS_HANDLER)
+                ||
+                (entity0->Radius(QTT_PHYSICS_HANDLER) == entity1->Radius(QTT_PHYSICS_HANDLER)
+                 && entity0->OwnerObject() > entity1->OwnerObject())) // yes, this is a pointer comparison.
+            {
+                std::swap(entity0, entity1);
+            }
+
+            Float r = entity0->Radius(QTT_PHYSICS_HANDLER) + entity1->Radius(QTT_PHYSICS_HANDLER);
+            FloatVector2 offset_0_to_1(object_layer.AdjustedDifference(entity1->Translation(), entity0->Translation()));
+            if (offset_0_to_1.LengthSquared() >= Sqr(r))
+                continue;
+
+            // at this point, a collision has happened (the entities are overlapping).
+            ASSERT1(entity0->GetPhysicsHandler() == this);
+            ASSERT1(entity1->GetPhysicsHandler() == this);
+            RecordCollision(*entity0, *entity1, offset_0_to_1, FrameDT(), m_collision_pair_list);
+        }
+    }
+}
+
 } // end of namespace Circle
 } // end of namespace Engine2
 } // end of namespace Xrb
@@ -14,6 +14,7 @@
 #include "xrb.hpp"
 
 #include <set>
+#include <vector>
 
 #include "xrb_engine2_circle_types.hpp"
 #include "xrb_engine2_physicshandler.hpp"
@@ -33,6 +34,47 @@ public:
     PhysicsHandler ();
     virtual ~PhysicsHandler ();
 
+    BroadPhase GetBroadPhase () const { return m_broad_phase; }
+    // selects the algorithm used to find colliding pairs (the default is BP_QUAD_TREE).
+    void SetBroadPhase (BroadPhase broad_phase)
+    {
+        ASSERT1(broad_phase < BP_COUNT);
+        m_broad_phase = broad_phase;
+    }
+    bool IsUsingPackedIntegration () const { return m_is_using_packed_integration; }
+    // if true, the per-frame velocity/position integration copies the entities'
+    // physical state into contiguous arrays, integrates those in a single
+    // tight loop, and writes the results back (the default is false).
+    void SetIsUsingPackedIntegration (bool is_using_packed_integration)
+    {
+        m_is_using_packed_integration = is_using_packed_integration;
+    }
+
+    Float QuadTreeBoundFactor () const { return m_quad_tree_bound_factor; }
+    // sets the bound factor of the collision quadtree (see
+    // QuadTree::BoundFactor -- the default is 2).  this must be set before
+    // the main object layer, since that is when the quadtree is created.
+    void SetQuadTreeBoundFactor (Float quad_tree_bound_factor)
+    {
+        ASSERT1(m_quad_tree == NULL && "the collision quadtree has already been created");
+        ASSERT1(quad_tree_bound_factor >= 2.0f);
+        m_quad_tree_bound_factor = quad_tree_bound_factor;
+    }
+    Uint8 QuadTreeDepth () const { return m_quad_tree_depth; }
+    Uint32 QuadTreeSplitThreshold () const { return m_quad_tree_split_threshold; }
+    // sets the depth of the collision quadtree (the default is 5) and its
+    // split threshold (the default is 0).  a nonzero split threshold makes
+    // the quadtree adaptive (see QuadTree), with the depth as its maximum
+    // depth.  like the bound factor, these must be set before the main
+    // object layer.
+    void SetQuadTreeDepth (Uint8 quad_tree_depth, Uint32 quad_tree_split_threshold = 0)
+    {
+        ASSERT1(m_quad_tree == NULL && "the collision quadtree has already been created");
+        ASSERT1(quad_tree_depth > 0);
+        m_quad_tree_depth = quad_tree_depth;
+        m_quad_tree_split_threshold = quad_tree_split_threshold;
+    }
+
     // this does wrapped object layer checking
     bool DoesAreaOverlapAnyEntityInObjectLayer (
         ObjectLayer const &object_layer,
@@ -48,6 +90,17 @@ public:
         Float trace_radius,
         bool check_nonsolid_collision_entities,
         LineTraceBindingSet &line_trace_binding_set) const;
+    // does a line trace in the quadtree, storing the results in
+    // line_trace_binding_vector sorted by OrderLineTraceBindingsByTime.
+    // the vector is cleared first, but keeps its capacity, so reusing the
+    // same vector for each trace avoids allocating memory.
+    void LineTrace (
+        ObjectLayer const &object_layer,
+        FloatVector2 const &trace_start,
+        FloatVector2 const &trace_vector,
+        Float trace_radius,
+        bool check_nonsolid_collision_entities,
+        LineTraceBindingVector &line_trace_binding_vector) const;
 
     // does an area trace in the quadtree
     void AreaTrace (
@@ -56,6 +109,16 @@ public:
         Float trace_area_radius,
         bool check_nonsolid_collision_entities,
         AreaTraceList &area_trace_list) const;
+    // does an area trace in the quadtree, storing the results in
+    // area_trace_vector.  the vector is cleared first, but keeps its
+    // capacity, so reusing the same vector for each trace avoids
+    // allocating memory.
+    void AreaTrace (
+        ObjectLayer const &object_layer,
+        FloatVector2 trace_area_center,
+        Float trace_area_radius,
+        bool check_nonsolid_collision_entities,
+        AreaTraceVector &area_trace_vector) const;
 
     // gives the local momentum (and mass) in a given radius
     void CalculateAmbientMomentum (
@@ -105,6 +168,18 @@ public:
         FloatVector2 const &collision_location,
         FloatVector2 const &collision_normal_0_to_1);
 
+    // narrow-phase collision handling for a pair of entities already known to
+    // overlap -- performs the collision response (if appropriate) and records
+    // the collision in collision_pair_list.  entity0 must be the smaller of
+    // the two (by radius, then by owner object pointer value), and
+    // offset_0_to_1 must already be adjusted for ObjectLayer wrapping.
+    void RecordCollision (
+        Entity &entity0,
+        Entity &entity1,
+        FloatVector2 const &offset_0_to_1,
+        Time::Delta frame_dt,
+        CollisionPairList &collision_pair_list);
+
 protected:
 
     virtual void HandleFrame ();
@@ -118,13 +193,93 @@ private:
 
     void UpdateVelocities ();
     void UpdatePositions ();
+    // does the same as UpdateVelocities followed by UpdatePositions, but
+    // using m_packed_state (see SetIsUsingPackedIntegration).
+    void UpdateVelocitiesAndPositionsPacked ();
+    // sweeps an entity which is using continuous collision along the given
+    // displacement (its motion for this frame), recording collisions with the
+    // entities it would otherwise pass completely through.  returns the
+    // proportion of the displacement the entity should actually be moved
+    // (less than 1 if it was stopped by a solid entity).
+    Float SweepContinuousCollisionEntity (Entity &entity, FloatVector2 const &displacement);
+    // does the work of RecordCollision, using an already-computed collision location.
+    void RecordCollision (
+        Entity &entity0,
+        Entity &entity1,
+        FloatVector2 const &offset_0_to_1,
+        Time::Delta frame_dt,
+        FloatVector2 const &collision_location,
+        CollisionPairList &collision_pair_list);
     void HandleInterpenetrations ();
+    void HandleInterpenetrationsUsingQuadTree ();
+    void HandleInterpenetrationsUsingSortAndSweep ();
+
+    // one element of the BP_SORT_AND_SWEEP sorted list.  wrapped ObjectLayers
+    // get an extra "ghost" entry (shifted by minus one ObjectLayer side length)
+    // for each entity near the right edge, so pairs straddling the X seam are
+    // still adjacent in the sorted list.
+    struct SweepEntry
+    {
+        Float m_min_x;
+        Float m_max_x;
+        Float m_x;
+        Entity *m_entity;
+        bool m_is_ghost;
+
+        SweepEntry (Float x, Float radius, Entity *entity, bool is_ghost)
+            :
+            m_min_x(x - radius),
+            m_max_x(x + radius),
+            m_x(x),
+            m_entity(entity),
+            m_is_ghost(is_ghost)
+        { }
+
+        bool operator < (SweepEntry const &other) const { return m_min_x < other.m_min_x; }
+    }; // end of struct PhysicsHandler::SweepEntry
+
+    typedef std::vector<SweepEntry> SweepEntryVector;
+
+    // structure-of-arrays copy of the entities' physical state, used by
+    // UpdateVelocitiesAndPositionsPacked.  element i of each array
+    // corresponds to m_entity[i].
+    struct PackedState
+    {
+        std::vector<Entity *> m_entity;
+        std::vector<Float> m_position_x;
+        std::vector<Float> m_position_y;
+        std::vector<Float> m_velocity_x;
+        std::vector<Float> m_velocity_y;
+        std::vector<Float> m_force_x;
+        std::vector<Float> m_force_y;
+        std::vector<Float> m_mass;
+        std::vector<Float> m_max_speed;
+        std::vector<Float> m_angular_velocity;
+
+        void Resize (Uint32 size);
+    }; // end of struct PhysicsHandler::PackedState
 
+    // the broad-phase algorithm used in HandleInterpenetrations
+    BroadPhase m_broad_phase;
+    // see SetIsUsingPackedIntegration
+    bool m_is_using_packed_integration;
+    // storage for UpdateVelocitiesAndPositionsPacked, kept around to avoid
+    // reallocating every frame
+    PackedState m_packed_state;
+    // storage for BP_SORT_AND_SWEEP, kept around to avoid reallocating every frame
+    SweepEntryVector m_sweep_entry_vector;
+    // storage for SweepContinuousCollisionEntity's line traces
+    LineTraceBindingVector m_continuous_collision_binding_vector;
     // the list of collision pairs for this frame
     CollisionPairList m_collision_pair_list;
     // keeps track of the main object layer (really only used to make
     // sure that all entities are added to the main object layer)
     ObjectLayer *m_main_object_layer;
+    // see SetQuadTreeBoundFactor
+    Float m_quad_tree_bound_factor;
+    // see SetQuadTreeDepth
+    Uint8 m_quad_tree_depth;
+    Uint32 m_quad_tree_split_threshold;
     // the quadtree used in collision detection and other spatial shit
     CollisionQuadTree *m_quad_tree;
 }; // end of class PhysicsHandler
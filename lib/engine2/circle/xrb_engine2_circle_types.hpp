@@ -26,6 +26,9 @@ namespace Circle {
 class Entity;
 
 typedef std::list<Entity *> AreaTraceList;
+// AreaTrace results, for use with the AreaTrace overloads which reuse a
+// caller-provided buffer instead of allocating a list node per hit.
+typedef std::vector<Entity *> AreaTraceVector;
 
 struct CollisionPair
 {
@@ -73,6 +76,20 @@ enum CollisionType
     CT_COUNT                ///< Number of collision types
 }; // end of enum CollisionType
 
+/// @brief Selects the algorithm Circle::PhysicsHandler uses to find the overlapping pairs of entities each frame.
+/// @details BP_QUAD_TREE traverses the collision quadtree once per entity, so each pair is
+/// considered from both sides (and rejected from one of them).  BP_SORT_AND_SWEEP sorts the
+/// collision entities along the X axis once per frame and sweeps the sorted list, so that each
+/// candidate pair is considered exactly once.  Both produce the same set of collision pairs,
+/// including across the edges of wrapped ObjectLayers.
+enum BroadPhase
+{
+    BP_QUAD_TREE = 0,       ///< Per-entity traversal of the collision quadtree.
+    BP_SORT_AND_SWEEP,      ///< Single sort-and-sweep pass over all collision entities.
+
+    BP_COUNT                ///< Number of broad-phase types
+}; // end of enum BroadPhase
+
 struct LineTraceBinding
 {
     // the proportion along the traced line which the trace hit -- clipped to be no less than 0.
@@ -80,29 +97,36 @@ struct LineTraceBinding
     // same as m_trace_dt, except not clipped (can be less than 0).  this can be used as the parameter
     // for a linear interpolation to figure out the location of the hit.
     Float m_unclamped_trace_hit_parameter;
-    // the Entity which was hit.
-    Entity &m_entity;
+    // the proportion along the traced line at which the trace leaves the
+    // Entity which was hit (not clipped -- can be greater than 1).
+    Float m_unclamped_trace_exit_parameter;
+    // the Entity which was hit (never NULL).
+    Entity *m_entity;
 
-    LineTraceBinding (Float trace_hit_parameter, Entity &entity)
+    LineTraceBinding (Float trace_hit_parameter, Float trace_exit_parameter, Entity &entity)
         :
         m_clamped_trace_hit_parameter(Max(0.0f, trace_hit_parameter)),
         m_unclamped_trace_hit_parameter(trace_hit_parameter),
-        m_entity(entity)
+        m_unclamped_trace_exit_parameter(trace_exit_parameter),
+        m_entity(&entity)
     { }
 }; // end of struct LineTraceBinding
 
 struct OrderLineTraceBindingsByTime
 {
-    bool operator () (LineTraceBinding const &binding0, LineTraceBinding const &binding1)
+    bool operator () (LineTraceBinding const &binding0, LineTraceBinding const &binding1) const
     {
         return binding0.m_unclamped_trace_hit_parameter < binding1.m_unclamped_trace_hit_parameter
                ||
                (binding0.m_unclamped_trace_hit_parameter == binding1.m_unclamped_trace_hit_parameter &&
-                &binding0.m_entity < &binding1.m_entity); // yes, this is pointer comparison.
+                binding0.m_entity < binding1.m_entity); // yes, this is pointer comparison.
     }
 }; // end of struct OrderEntitiesByTraceTime
 
 typedef std::set<LineTraceBinding, OrderLineTraceBindingsByTime> LineTraceBindingSet;
+// LineTrace results, for use with the LineTrace overloads which reuse a
+// caller-provided buffer.  these are sorted by OrderLineTraceBindingsByTime.
+typedef std::vector<LineTraceBinding> LineTraceBindingVector;
 
 } // end of namespace Circle
 } // end of namespace Engine2
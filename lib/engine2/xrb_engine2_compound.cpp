@@ -103,8 +103,7 @@ void Compound::ReadClassSpecific (Serializer &serializer)
     serializer.Read<Uint32>(m_vertex_count);
     ASSERT1(m_vertex_count > 0);
     m_vertex_array = new FloatVector2[m_vertex_count];
-    for (Uint32 i = 0; i < m_vertex_count; ++i)
-        serializer.ReadAggregate<FloatVector2>(m_vertex_array[i]);
+    serializer.ReadArray<FloatVector2>(m_vertex_array, m_vertex_count);
 
     m_polygon_count = serializer.Read<Uint32>();
     ASSERT1(m_polygon_count > 0);
@@ -122,8 +121,7 @@ void Compound::WriteClassSpecific (Serializer &serializer) const
     ASSERT1(m_polygon_array != NULL);
 
     serializer.Write<Uint32>(m_vertex_count);
-    for (Uint32 i = 0; i < m_vertex_count; ++i)
-        serializer.WriteAggregate<FloatVector2>(m_vertex_array[i]);
+    serializer.WriteArray<FloatVector2>(m_vertex_array, m_vertex_count);
 
     serializer.Write<Uint32>(m_polygon_count);
     for (Uint32 i = 0; i < m_polygon_count; ++i)
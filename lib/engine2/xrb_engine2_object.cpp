@@ -156,6 +156,7 @@ Object::Object (ObjectType object_type)
     {
         m_radius[i] = 0.0f;
         m_owner_quad_tree[i] = NULL;
+        m_owner_quad_tree_index[i] = 0;
     }
     m_entity = NULL;
     m_is_transparent = false;
@@ -29,6 +29,7 @@ namespace Engine2 {
 class Entity;
 class ObjectLayer;
 class QuadTree;
+class SpriteBatch;
 class World;
 
 // base class for Sprite and Compound.  an Object which does not have an
@@ -79,16 +80,24 @@ public:
         FloatMatrix2 const &m_world_to_screen;
         Color m_color_bias;
         Color m_color_mask;
+        // if not NULL, objects which return true from DrawsIntoSpriteBatch
+        // should append their geometry to this instead of drawing it directly.
+        SpriteBatch *m_sprite_batch;
 
         DrawData (RenderContext const &render_context, FloatMatrix2 const &world_to_screen)
             :
             m_render_context(render_context),
-            m_world_to_screen(world_to_screen)
+            m_world_to_screen(world_to_screen),
+            m_sprite_batch(NULL)
         { }
     }; // end of struct Engine2::Object::DrawData
 
     // draw this object using the given alpha mask
     virtual void Draw (DrawData const &draw_data) const { }
+    // should return true iff Draw uses DrawData::m_sprite_batch when it's
+    // provided.  the caller must flush the sprite batch before calling Draw
+    // on objects which return false, to preserve the draw order.
+    virtual bool DrawsIntoSpriteBatch () const { return false; }
     // create a clone of this object
     virtual Object *Clone () const;
 
@@ -133,6 +142,12 @@ public:
         ASSERT3(quad_tree_type <= QTT_COUNT);
         return m_owner_quad_tree[quad_tree_type];
     }
+    // returns the index of this object in its owner quadtree node's object list
+    Uint32 OwnerQuadTreeIndex (QuadTreeType const quad_tree_type) const
+    {
+        ASSERT3(quad_tree_type <= QTT_COUNT);
+        return m_owner_quad_tree_index[quad_tree_type];
+    }
 
     // set the z depth (as used by the OpenGL depth buffer during drawing).
     // a lower value indicates closer to the viewpoint (and will be drawn
@@ -159,6 +174,14 @@ public:
         ASSERT3(quad_tree_type <= QTT_COUNT);
         m_owner_quad_tree[quad_tree_type] = owner_quad_tree;
     }
+    // sets the index of this object in its owner quadtree node's object list
+    void SetOwnerQuadTreeIndex (
+        QuadTreeType const quad_tree_type,
+        Uint32 const owner_quad_tree_index)
+    {
+        ASSERT3(quad_tree_type <= QTT_COUNT);
+        m_owner_quad_tree_index[quad_tree_type] = owner_quad_tree_index;
+    }
 
 protected:
 
@@ -210,6 +233,9 @@ protected:
     // there is one array entry for each type of quadtree (the visibility
     // quadtree in each object layer, and the physics handler quadtree)
     QuadTree *m_owner_quad_tree[QTT_COUNT];
+    // the index of this object in each owner quadtree node's object list
+    // (this makes removal from the quadtree nodes constant-time)
+    Uint32 m_owner_quad_tree_index[QTT_COUNT];
 
 private:
 
@@ -20,6 +20,7 @@ namespace Engine2 {
 
 ObjectLayer::~ObjectLayer ()
 {
+    Delete(m_static_draw_cache);
     Delete(m_quad_tree);
 }
 
@@ -29,7 +30,9 @@ ObjectLayer *ObjectLayer::Create (
     Float const side_length,
     Uint32 const tree_depth,
     Float const z_depth,
-    std::string const &name)
+    std::string const &name,
+    Float const quad_tree_bound_factor,
+    Uint32 const quad_tree_split_threshold)
 {
     ASSERT1(owner_world != NULL);
     ASSERT1(side_length > 0.0);
@@ -47,7 +50,9 @@ ObjectLayer *ObjectLayer::Create (
         new VisibilityQuadTree(
             FloatVector2::ms_zero,
             0.5f*side_length,
-            tree_depth);
+            tree_depth,
+            quad_tree_bound_factor,
+            quad_tree_split_threshold);
 
     return retval;
 }
@@ -133,7 +138,9 @@ Uint32 ObjectLayer::Draw (
     ASSERT1(draw_object_collector.m_pixels_in_view_radius > 0.0f);
     ASSERT1(draw_object_collector.m_view_radius > 0.0f);
 
-    if (m_is_wrapped)
+    if (m_static_draw_cache != NULL)
+        return m_quad_tree->DrawStaticDrawCache(render_context, world_to_screen, draw_object_collector, *this, *m_static_draw_cache);
+    else if (m_is_wrapped)
         return m_quad_tree->DrawWrapped(render_context, world_to_screen, draw_object_collector, *this);
     else
         return m_quad_tree->Draw(render_context, world_to_screen, draw_object_collector, *this);
@@ -153,6 +160,8 @@ void ObjectLayer::AddObject (Object *const object)
     DEBUG1_CODE(bool add_success =)
     m_quad_tree->AddObject(object);
     ASSERT1(add_success);
+    if (m_static_draw_cache != NULL)
+        m_static_draw_cache->Invalidate();
 
     ASSERT1(object->OwnerQuadTree(QTT_VISIBILITY) != NULL);
 }
@@ -163,6 +172,16 @@ void ObjectLayer::RemoveObject (Object *const object)
     ASSERT1(object->GetObjectLayer() == this);
     ASSERT1(object->OwnerQuadTree(QTT_VISIBILITY) != NULL);
     object->OwnerQuadTree(QTT_VISIBILITY)->RemoveObject(object);
+    if (m_static_draw_cache != NULL)
+        m_static_draw_cache->Invalidate();
+}
+
+void ObjectLayer::SetUsesStaticDrawCache (bool uses_static_draw_cache)
+{
+    if (uses_static_draw_cache && m_static_draw_cache == NULL)
+        m_static_draw_cache = new StaticDrawCache();
+    else if (!uses_static_draw_cache && m_static_draw_cache != NULL)
+        DeleteAndNullify(m_static_draw_cache);
 }
 
 void ObjectLayer::HandleContainmentOrWrapping (Object *object)
@@ -303,6 +322,7 @@ ObjectLayer::ObjectLayer (
     m_quad_tree = NULL;
     m_name = name;
     m_background_color = Color::ms_transparent_black;
+    m_static_draw_cache = NULL;
 }
 
 } // end of namespace Engine2
@@ -44,7 +44,9 @@ public:
         Float side_length,
         Uint32 tree_depth,
         Float z_depth,
-        std::string const &name = "");
+        std::string const &name = "",
+        Float quad_tree_bound_factor = 2.0f,
+        Uint32 quad_tree_split_threshold = 0);
     static ObjectLayer *Create (
         Serializer &serializer,
         World *owner_world);
@@ -55,6 +57,7 @@ public:
     bool IsWrapped () const { return m_is_wrapped; }
     Float SideLength () const { return m_side_length; }
     Float ZDepth () const { return m_z_depth; }
+    bool UsesStaticDrawCache () const { return m_static_draw_cache != NULL; }
     Object *SmallestObjectTouchingPoint (FloatVector2 const &point) const;
     bool DoesAreaOverlapAnyObject (
         FloatVector2 const &area_center,
@@ -66,8 +69,21 @@ public:
     Float AdjustedDistanceSquared (FloatVector2 const &p, FloatVector2 const &q) const { return AdjustedDifference(p, q).LengthSquared(); }
 
     void SetBackgroundColor (Color const &background_color) { m_background_color = background_color; }
-    void SetIsWrapped (bool is_wrapped) { m_is_wrapped = is_wrapped; }
+    void SetIsWrapped (bool is_wrapped)
+    {
+        m_is_wrapped = is_wrapped;
+        if (m_static_draw_cache != NULL)
+            m_static_draw_cache->Invalidate();
+    }
     void SetZDepth (Float z_depth) { m_z_depth = z_depth; }
+    // if enabled, the sorted and batched drawing of the objects around the
+    // view is kept from frame to frame (see StaticDrawCache), and is only
+    // redone when objects are added or removed, or when the view leaves the
+    // cached region.  this is meant for background layers full of static
+    // sprites -- the objects must not move or otherwise change once added.
+    // layers containing anything other than Sprites (e.g. dynamic objects,
+    // AnimatedSprites or Compounds) are drawn normally.
+    void SetUsesStaticDrawCache (bool uses_static_draw_cache);
 
     void Write (Serializer &serializer) const;
     Uint32 Draw (
@@ -128,6 +144,8 @@ private:
     bool m_is_wrapped;
     // color which will be painted before drawing this layer (default is transparent black)
     Color m_background_color;
+    // see SetUsesStaticDrawCache (NULL if not used)
+    StaticDrawCache *m_static_draw_cache;
 }; // end of class Engine2::ObjectLayer
 
 } // end of namespace Engine2
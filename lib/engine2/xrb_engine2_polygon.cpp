@@ -97,12 +97,13 @@ void Polygon::Draw () const
             vertex_array[i] = GetVertex(i);
         }
 
-        glVertexPointer(2, GL_FLOAT, 0, vertex_array);
-        glTexCoordPointer(2, GL_FLOAT, 0, texture_coord_array); // TODO: fix
+        Gl::VertexPointer(2, GL_FLOAT, m_vertex_count, vertex_array);
+        Gl::TexCoordPointer(2, GL_FLOAT, m_vertex_count, texture_coord_array); // TODO: fix
 
-        glDrawArrays(GL_TRIANGLE_FAN, 0, m_vertex_count);
+        Gl::DrawArrays(GL_TRIANGLE_FAN, 0, m_vertex_count);
 
         delete[] vertex_array;
+        delete[] texture_coord_array;
     }
 }
 
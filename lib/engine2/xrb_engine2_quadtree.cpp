@@ -16,11 +16,14 @@
 namespace Xrb {
 namespace Engine2 {
 
+Uint32 QuadTree::ms_re_add_object_call_count = 0;
+Uint32 QuadTree::ms_re_add_object_skip_count = 0;
+
 QuadTree::~QuadTree ()
 {
     // delete all the objects in this node's list
-    for (ObjectSet::iterator it = m_object_set.begin(),
-                           it_end = m_object_set.end();
+    for (ObjectVector::iterator it = m_object_vector.begin(),
+                              it_end = m_object_vector.end();
          it != it_end;
          ++it)
     {
@@ -28,9 +31,12 @@ QuadTree::~QuadTree ()
         ASSERT1(object != NULL);
         Delete(object);
     }
-    m_object_set.clear();
+    m_object_vector.clear();
 
-    if (HasChildren())
+    // pooled children are all deleted at once by the root node
+    if (m_node_pool != NULL)
+        m_delete_node_pool(m_node_pool);
+    else if (HasChildren() && !m_children_are_pooled)
         for (Uint8 i = 0; i < 4; ++i)
             Delete(m_child[i]);
 }
@@ -43,6 +49,15 @@ QuadTree const *QuadTree::RootNode () const
     return quad_node;
 }
 
+Uint32 QuadTree::NodeCount () const
+{
+    Uint32 retval = 1;
+    if (HasChildren())
+        for (Uint8 i = 0; i < 4; ++i)
+            retval += m_child[i]->NodeCount();
+    return retval;
+}
+
 Object *QuadTree::SmallestObjectTouchingPoint (
     FloatVector2 const &point)
 {
@@ -53,7 +68,7 @@ Object *QuadTree::SmallestObjectTouchingPoint (
         return retval;
 
     // if the point is outside the reaches of this quad node, early out
-    if ((point - m_center).LengthSquared() > 4.0*m_radius*m_radius)
+    if ((point - m_center).LengthSquared() > Sqr(BoundingRadius()))
         return retval;
 
     Object *smallest_candidate;
@@ -79,8 +94,8 @@ Object *QuadTree::SmallestObjectTouchingPoint (
         return retval;
 
     // check against all the objects owned by this node
-    for (ObjectSet::iterator it = m_object_set.begin(),
-                           it_end = m_object_set.end();
+    for (ObjectVector::iterator it = m_object_vector.begin(),
+                              it_end = m_object_vector.end();
          it != it_end;
          ++it)
     {
@@ -113,8 +128,8 @@ bool QuadTree::DoesAreaOverlapAnyObject (
         return false;
 
     // check if the area overlaps any object in this node's list.
-    for (ObjectSet::const_iterator it = m_object_set.begin(),
-                                   it_end = m_object_set.end();
+    for (ObjectVector::const_iterator it = m_object_vector.begin(),
+                                      it_end = m_object_vector.end();
          it != it_end;
          ++it)
     {
@@ -140,10 +155,25 @@ bool QuadTree::DoesAreaOverlapAnyObject (
         return false;
 }
 
+Uint32 QuadTree::AreaQueryObjectTestCount (
+    FloatVector2 const &area_center,
+    Float area_radius,
+    ObjectLayer const &object_layer) const
+{
+    if (SubordinateObjectCount() == 0 || !DoesAreaOverlapQuadBounds(area_center, area_radius, object_layer, false))
+        return 0;
+
+    Uint32 retval = m_object_vector.size();
+    if (HasChildren())
+        for (Uint8 i = 0; i < 4; ++i)
+            retval += m_child[i]->AreaQueryObjectTestCount(area_center, area_radius, object_layer);
+    return retval;
+}
+
 void QuadTree::Clear ()
 {
     // clear the object list
-    m_object_set.clear();
+    m_object_vector.clear();
     // if there are children, clear the children
     if (HasChildren())
     {
@@ -161,8 +191,8 @@ bool QuadTree::AddObject (Object *object)
     ASSERT1(object->OwnerQuadTree(m_quad_tree_type) == NULL);
 
     // range checking -- an object can't have a larger radius
-    // than the quadnode that owns it
-    ASSERT1(object->Radius(GetQuadTreeType()) <= m_radius);
+    // than the quadnode that owns it allows
+    ASSERT1(object->Radius(GetQuadTreeType()) <= MaxObjectRadius());
 
     // return if the object's center is not inside this node
     if (!IsPointInsideQuad(object->Translation()))
@@ -174,11 +204,11 @@ bool QuadTree::AddObject (Object *object)
     if (IsAllowableSizedObject(*object) || !HasChildren())
     {
         // add to this node
-        object->SetOwnerQuadTree(m_quad_tree_type, this);
-        m_object_set.insert(object);
+        InsertIntoObjectVector(object);
         ++m_subordinate_object_count;
         if (!object->IsDynamic())
             ++m_subordinate_static_object_count;
+        SplitIfNecessary();
     }
     else
     {
@@ -203,17 +233,26 @@ bool QuadTree::AddObject (Object *object)
 }
 
 bool QuadTree::RemoveObject (Object *const object)
+{
+    if (!RemoveObjectWithoutCollapsing(object))
+        return false;
+
+    // NOTE: this may delete this node, so nothing may be done after it.
+    if (IsAdaptive())
+        CollapseEmptyNodes(this);
+    return true;
+}
+
+bool QuadTree::RemoveObjectWithoutCollapsing (Object *const object)
 {
     ASSERT1(object != NULL);
     ASSERT1(object->OwnerQuadTree(m_quad_tree_type) == this);
 
-    ObjectSet::iterator it = m_object_set.find(object);
-    if (it != m_object_set.end())
+    Uint32 index = object->OwnerQuadTreeIndex(m_quad_tree_type);
+    if (index < m_object_vector.size() && m_object_vector[index] == object)
     {
-        // remove the object from the object set of its owner
-        object->OwnerQuadTree(m_quad_tree_type)->m_object_set.erase(it);
-        // set the object to un-owned
-        object->SetOwnerQuadTree(m_quad_tree_type, NULL);
+        // remove the object from this node and set it to un-owned
+        EraseFromObjectVector(object);
         // decrement subordinate object count
         DecrementSubordinateObjectCount();
         // decrement the subordinate static object count if appropriate
@@ -234,19 +273,45 @@ bool QuadTree::ReAddObject (Object *const object)
     ASSERT1(object != NULL);
     ASSERT1(object->OwnerQuadTree(m_quad_tree_type) != NULL);
 
+    ++ms_re_add_object_call_count;
+
+    // most of the time, a moving object hasn't left its node -- in that
+    // case, don't bother with the traversal.
+    if (object->OwnerQuadTree(m_quad_tree_type) == this &&
+        IsPointInsideQuad(object->Translation()) &&
+        IsCorrectlySizedObject(*object))
+    {
+        ++ms_re_add_object_skip_count;
+        return true;
+    }
+
+    return ReAddObjectRecursive(object);
+}
+
+void QuadTree::ResetReAddObjectCounts ()
+{
+    ms_re_add_object_call_count = 0;
+    ms_re_add_object_skip_count = 0;
+}
+
+bool QuadTree::ReAddObjectRecursive (Object *const object)
+{
+    ASSERT1(object != NULL);
+    ASSERT1(object->OwnerQuadTree(m_quad_tree_type) != NULL);
+
     bool object_was_added = false;
 
     // if the object's position is inside current quadnode
     if (IsPointInsideQuad(object->Translation()))
     {
-        Float object_radius_over_quad_radius = object->Radius(GetQuadTreeType()) / m_radius;
+        Float object_radius_over_quad_radius = object->Radius(GetQuadTreeType()) / MaxObjectRadius();
         // if the object is too big for current quadnode
         if (object_radius_over_quad_radius > 1.0f)
         {
             if (m_parent != NULL)
             {
                 // traverse to the parent
-                object_was_added = m_parent->ReAddObject(object);
+                object_was_added = m_parent->ReAddObjectRecursive(object);
                 ASSERT1(object_was_added);
             }
             else
@@ -267,12 +332,12 @@ bool QuadTree::ReAddObject (Object *const object)
                     if (object_translation[Dim::Y] >= m_center[Dim::Y])
                     {
                         ASSERT1(m_child[0]->IsPointInsideQuad(object->Translation()));
-                        object_was_added = m_child[0]->ReAddObject(object);
+                        object_was_added = m_child[0]->ReAddObjectRecursive(object);
                     }
                     else
                     {
                         ASSERT1(m_child[3]->IsPointInsideQuad(object->Translation()));
-                        object_was_added = m_child[3]->ReAddObject(object);
+                        object_was_added = m_child[3]->ReAddObjectRecursive(object);
                     }
                 }
                 else
@@ -280,12 +345,12 @@ bool QuadTree::ReAddObject (Object *const object)
                     if (object_translation[Dim::Y] >= m_center[Dim::Y])
                     {
                         ASSERT1(m_child[1]->IsPointInsideQuad(object->Translation()));
-                        object_was_added = m_child[1]->ReAddObject(object);
+                        object_was_added = m_child[1]->ReAddObjectRecursive(object);
                     }
                     else
                     {
                         ASSERT1(m_child[2]->IsPointInsideQuad(object->Translation()));
-                        object_was_added = m_child[2]->ReAddObject(object);
+                        object_was_added = m_child[2]->ReAddObjectRecursive(object);
                     }
                 }
                 ASSERT1(object_was_added);
@@ -311,7 +376,7 @@ bool QuadTree::ReAddObject (Object *const object)
         if (m_parent != NULL)
         {
             // traverse to the parent
-            object_was_added = m_parent->ReAddObject(object);
+            object_was_added = m_parent->ReAddObjectRecursive(object);
         }
         else
         {
@@ -331,11 +396,19 @@ QuadTree::QuadTree (QuadTree *const parent)
     m_parent = parent;
     m_half_side_length = 0.0f;
     m_radius = 0.0f;
+    m_bound_factor = 2.0f;
     for (Uint8 i = 0; i < 4; ++i)
         m_child[i] = NULL;
     m_subordinate_object_count = 0;
     m_subordinate_static_object_count = 0;
+    m_split_threshold = 0;
+    m_max_depth = 1;
+    m_depth = (parent != NULL) ? parent->m_depth + 1 : 0;
     m_quad_tree_type = QTT_COUNT;
+    m_node_pool = NULL;
+    m_delete_node_pool = NULL;
+    m_create_node = NULL;
+    m_children_are_pooled = false;
 }
 
 bool QuadTree::IsPointInsideQuad (FloatVector2 const &point) const
@@ -361,7 +434,7 @@ bool QuadTree::DoesAreaOverlapQuadBounds (
     bool disable_wrapping_adjustment) const
 {
     ASSERT1(area_radius > 0.0f);
-    Float radius_sum = area_radius + 2.0f * Radius();
+    Float radius_sum = area_radius + BoundingRadius();
     if (disable_wrapping_adjustment)
         return (area_center - m_center).LengthSquared() < Sqr(radius_sum);
     else
@@ -377,6 +450,16 @@ void QuadTree::SetQuadTreeType (QuadTreeType const quad_tree_type)
             m_child[i]->SetQuadTreeType(m_quad_tree_type);
 }
 
+void QuadTree::SetBoundFactor (Float const bound_factor)
+{
+    ASSERT1(bound_factor >= 2.0f && "objects must be allowed to be as large as the node itself");
+    ASSERT1(m_subordinate_object_count == 0);
+    m_bound_factor = bound_factor;
+    if (HasChildren())
+        for (Uint8 i = 0; i < 4; ++i)
+            m_child[i]->SetBoundFactor(m_bound_factor);
+}
+
 void QuadTree::IncrementSubordinateObjectCount ()
 {
     QuadTree *quad_node = this;
@@ -421,15 +504,152 @@ void QuadTree::DecrementSubordinateStaticObjectCount ()
     }
 }
 
+void QuadTree::InitializeNode (
+    QuadTree *const parent,
+    FloatVector2 const &center,
+    Float const half_side_length)
+{
+    ASSERT1(half_side_length > 0.0f);
+    ASSERT1(m_object_vector.empty());
+
+    m_parent = parent;
+    m_center = center;
+    m_half_side_length = half_side_length;
+    m_radius = Math::Sqrt(2.0f) * m_half_side_length;
+    m_depth = (parent != NULL) ? parent->m_depth + 1 : 0;
+    for (Uint8 i = 0; i < 4; ++i)
+        m_child[i] = NULL;
+    m_subordinate_object_count = 0;
+    m_subordinate_static_object_count = 0;
+}
+
+void QuadTree::AttachChild (Uint32 const index, QuadTree *const child)
+{
+    ASSERT1(index < 4);
+    ASSERT1(child != NULL);
+    ASSERT1(m_child[index] == NULL);
+
+    // see the comment on m_child for the quadrant ordering
+    Float child_half_side_length = 0.5f * m_half_side_length;
+    child->InitializeNode(
+        this,
+        m_center + child_half_side_length * FloatVector2((index == 0 || index == 3) ? 1.0f : -1.0f,
+                                                         (index == 0 || index == 1) ? 1.0f : -1.0f),
+        child_half_side_length);
+    child->m_bound_factor = m_bound_factor;
+    child->m_split_threshold = m_split_threshold;
+    child->m_max_depth = m_max_depth;
+    child->m_create_node = m_create_node;
+    child->m_quad_tree_type = m_quad_tree_type;
+    m_child[index] = child;
+}
+
+Uint32 QuadTree::ChildIndex (FloatVector2 const &point) const
+{
+    // this must agree with ReAddObjectRecursive's choice of child
+    if (point[Dim::X] >= m_center[Dim::X])
+        return (point[Dim::Y] >= m_center[Dim::Y]) ? 0 : 3;
+    else
+        return (point[Dim::Y] >= m_center[Dim::Y]) ? 1 : 2;
+}
+
+void QuadTree::SplitIfNecessary ()
+{
+    if (!IsAdaptive() ||
+        HasChildren() ||
+        m_object_vector.size() <= m_split_threshold ||
+        m_depth + 1 >= m_max_depth)
+    {
+        return;
+    }
+
+    ASSERT1(m_create_node != NULL);
+    ASSERT1(m_node_pool == NULL);
+    ASSERT1(!m_children_are_pooled);
+    for (Uint32 i = 0; i < 4; ++i)
+        AttachChild(i, m_create_node());
+
+    // move the objects which are small enough down a level.  going backwards
+    // means the object EraseFromObjectVector swaps into the vacated slot has
+    // already been looked at.  the subordinate counts of this node and its
+    // ancestors don't change, since the objects stay below this node.
+    for (Uint32 i = m_object_vector.size(); i-- > 0; )
+    {
+        Object *object = m_object_vector[i];
+        if (IsAllowableSizedObject(*object))
+            continue;
+
+        // an object which has moved but not yet been re-added may not be
+        // inside this node anymore -- its ReAddObject will sort it out.
+        QuadTree *child = m_child[ChildIndex(object->Translation())];
+        EraseFromObjectVector(object);
+        child->InsertIntoObjectVector(object);
+        ++child->m_subordinate_object_count;
+        if (!object->IsDynamic())
+            ++child->m_subordinate_static_object_count;
+    }
+
+    // the objects may all have landed in the same child
+    for (Uint32 i = 0; i < 4; ++i)
+        m_child[i]->SplitIfNecessary();
+}
+
+void QuadTree::CollapseEmptyNodes (QuadTree *const node)
+{
+    ASSERT1(node != NULL);
+    ASSERT1(node->IsAdaptive());
+
+    // a node whose subordinate objects are all its own has nothing below it.
+    // once an ancestor still has objects below it, so do all the ones above.
+    QuadTree *parent = node->m_parent;
+    while (parent != NULL && parent->m_subordinate_object_count == parent->m_object_vector.size())
+    {
+        ASSERT1(parent->HasChildren());
+        ASSERT1(!parent->m_children_are_pooled);
+        for (Uint8 i = 0; i < 4; ++i)
+        {
+            ASSERT1(parent->m_child[i]->m_subordinate_object_count == 0);
+            Delete(parent->m_child[i]);
+            parent->m_child[i] = NULL;
+        }
+        parent = parent->m_parent;
+    }
+}
+
+void QuadTree::InsertIntoObjectVector (Object *const object)
+{
+    ASSERT1(object != NULL);
+    object->SetOwnerQuadTree(m_quad_tree_type, this);
+    object->SetOwnerQuadTreeIndex(m_quad_tree_type, m_object_vector.size());
+    m_object_vector.push_back(object);
+}
+
+void QuadTree::EraseFromObjectVector (Object *const object)
+{
+    ASSERT1(object != NULL);
+    ASSERT1(object->OwnerQuadTree(m_quad_tree_type) == this);
+    Uint32 index = object->OwnerQuadTreeIndex(m_quad_tree_type);
+    ASSERT1(index < m_object_vector.size());
+    ASSERT1(m_object_vector[index] == object);
+
+    // move the last object into the vacated slot (order doesn't matter)
+    Object *last_object = m_object_vector.back();
+    m_object_vector[index] = last_object;
+    last_object->SetOwnerQuadTreeIndex(m_quad_tree_type, index);
+    m_object_vector.pop_back();
+
+    object->SetOwnerQuadTree(m_quad_tree_type, NULL);
+}
+
 void QuadTree::NonRecursiveAddObject (Object *object)
 {
     ASSERT1(object != NULL);
     ASSERT1(object->OwnerQuadTree(m_quad_tree_type) == NULL);
 
     // do range adjusting -- an object can't have a larger radius
-    // than the quadnode that owns it
-    if (object->Radius(GetQuadTreeType()) > m_radius)
-        object->SetScaleFactor(m_radius);
+    // than the quadnode that owns it allows
+    if (object->Radius(GetQuadTreeType()) > MaxObjectRadius())
+        object->SetScaleFactor(MaxObjectRadius());
 
     ASSERT1(IsPointInsideQuad(object->Translation()));
 
@@ -438,11 +658,11 @@ void QuadTree::NonRecursiveAddObject (Object *object)
     // for this quadtree's radius or that there are no child quadtree nodes.
     ASSERT1(IsAllowableSizedObject(*object) || !HasChildren());
     // add to this node
-    object->SetOwnerQuadTree(m_quad_tree_type, this);
-    m_object_set.insert(object);
+    InsertIntoObjectVector(object);
     IncrementSubordinateObjectCount();
     if (!object->IsDynamic())
         IncrementSubordinateStaticObjectCount();
+    SplitIfNecessary();
 }
 
 void QuadTree::AddObjectIfNotAlreadyAdded (Object *const object)
@@ -453,8 +673,13 @@ void QuadTree::AddObjectIfNotAlreadyAdded (Object *const object)
     // only move the object to this quadnode if it's not already here.
     if (object->OwnerQuadTree(m_quad_tree_type) != this)
     {
-        object->OwnerQuadTree(m_quad_tree_type)->RemoveObject(object);
+        // collapsing the old owner's empty ancestors before the object is
+        // added here could delete this node, so collapse afterwards.
+        QuadTree *old_owner = object->OwnerQuadTree(m_quad_tree_type);
+        old_owner->RemoveObjectWithoutCollapsing(object);
         NonRecursiveAddObject(object);
+        if (IsAdaptive())
+            CollapseEmptyNodes(old_owner);
     }
 }
 
@@ -13,7 +13,7 @@
 
 #include "xrb.hpp"
 
-#include <set>
+#include <vector>
 
 #include "xrb_engine2_object.hpp"
 #include "xrb_engine2_enums.hpp"
@@ -30,6 +30,27 @@ class Object;
 // noted that it actually uses circle-intersections to determine containment,
 // which will give a boost in speed due to the ease of calculating radiuses
 // (as opposed to messier (rotated) rectangle intersection calculations).
+//
+// The nodes of a tree built by Initialize are allocated in one contiguous
+// block (in breadth-first order), and each node keeps its objects in a
+// vector, with each Object storing its index in that vector, so that adding
+// and removing objects doesn't touch the heap (beyond the vector growing).
+//
+// Each node owns the objects whose centers are inside it and whose radii are
+// at most MaxObjectRadius, so everything a node owns is within its
+// BoundingRadius of its center.  The bound factor (the ratio of the bounding
+// radius to the node's own radius) is 2 by default, meaning objects may be
+// as large as the node itself.  A larger bound factor makes a "looser" tree --
+// large objects are kept further down the tree instead of piling up near the
+// root (where every query has to test them), at the cost of each node's
+// bounds overlapping more of its neighbors'.
+//
+// A tree built with a nonzero split threshold is adaptive -- it starts out as
+// a single node, a leaf node is subdivided once it owns more than the split
+// threshold number of objects (as long as the depth allows), and a node's
+// children are deleted once there are no objects left below it.  This way
+// the size of the tree follows the distribution of the objects in it,
+// instead of being fully subdivided down to a fixed depth.
 class QuadTree
 {
 public:
@@ -45,16 +66,38 @@ public:
     Float SideLength () const { return 2.0f * m_half_side_length; }
     Float HalfSideLength () const { return m_half_side_length; }
     Float Radius () const { return m_radius; }
+    // see the comment above the class
+    Float BoundFactor () const { return m_bound_factor; }
+    // the largest object this node will own (the root node owns objects of any size)
+    Float MaxObjectRadius () const { return (m_bound_factor - 1.0f) * m_radius; }
+    // the radius of the circle around Center() containing every object this node owns
+    Float BoundingRadius () const { return m_bound_factor * m_radius; }
+    // see the comment above the class -- this is 0 for non-adaptive trees
+    Uint32 SplitThreshold () const { return m_split_threshold; }
+    bool IsAdaptive () const { return m_split_threshold > 0; }
+    // the number of levels the tree has (non-adaptive) or may have (adaptive)
+    Uint8 MaxDepth () const { return m_max_depth; }
+    // the number of nodes in this node's subtree, including this node
+    Uint32 NodeCount () const;
     Uint32 SubordinateObjectCount () const { return m_subordinate_object_count; }
     Uint32 SubordinateStaticObjectCount () const { return m_subordinate_static_object_count; }
     Object *SmallestObjectTouchingPoint (FloatVector2 const &point);
     // TODO: write a wrapped version of SmallestObjectTouchingPoint
-    bool IsAllowableSizedObject (Object const &object) const { return object.Radius(GetQuadTreeType()) > 0.5f*m_radius; }
+    // returns true if the object is too large for this node's children.
+    bool IsAllowableSizedObject (Object const &object) const { return object.Radius(GetQuadTreeType()) > 0.5f*MaxObjectRadius(); }
 
     bool DoesAreaOverlapAnyObject (
         FloatVector2 const &area_center,
         Float area_radius,
         ObjectLayer const &object_layer) const;
+    // returns the number of objects an area query (e.g. an AreaTrace) for the
+    // given circle would test, i.e. the number of objects owned by the nodes
+    // whose bounds the circle overlaps.  this is for measuring how well the
+    // tree culls, and doesn't otherwise do anything.
+    Uint32 AreaQueryObjectTestCount (
+        FloatVector2 const &area_center,
+        Float area_radius,
+        ObjectLayer const &object_layer) const;
 
     // clears out all objects but leaves the QuadTree structure intact
     void Clear ();
@@ -66,9 +109,16 @@ public:
     // removes the object from the quadtree in an efficient manner
     bool RemoveObject (Object *object);
     // moves an object that is already in this quadtree into the
-    // correct place.
+    // correct place.  if this is the object's owner node and the object
+    // is still inside it and correctly sized for it, this does nothing.
     bool ReAddObject (Object *object);
 
+    // the number of ReAddObject calls (on any QuadTree) since the counts were last reset
+    static Uint32 ReAddObjectCallCount () { return ms_re_add_object_call_count; }
+    // the number of those ReAddObject calls which left the object where it was
+    static Uint32 ReAddObjectSkipCount () { return ms_re_add_object_skip_count; }
+    static void ResetReAddObjectCounts ();
+
 protected:
 
     // for use in Create
@@ -90,6 +140,15 @@ protected:
     }
     // returns true if the given point is inside this quad.
     bool IsPointInsideQuad (FloatVector2 const &point) const;
+    // returns true if this is the node the object belongs in, size-wise
+    // (i.e. where AddObject would put it if its center were inside).
+    bool IsCorrectlySizedObject (Object const &object) const
+    {
+        Float object_radius = object.Radius(GetQuadTreeType());
+        return (object_radius <= MaxObjectRadius() || m_parent == NULL)
+               &&
+               (object_radius > 0.5f*MaxObjectRadius() || !HasChildren());
+    }
     // returns true if this quad's bounding circle is intersecting the given
     // circle (e.g. used in determining the potential intersecting set of the
     // specified circle).  disable_wrapping_adjustment is used when AdjustedDifference
@@ -101,6 +160,9 @@ protected:
         bool disable_wrapping_adjustment) const;
 
     void SetQuadTreeType (QuadTreeType quad_tree_type);
+    // sets the bound factor of this node and all nodes below it.  this must
+    // be done before any objects are added.
+    void SetBoundFactor (Float bound_factor);
 
     // increment m_subordinate_object_count at this node and up through all parents
     void IncrementSubordinateObjectCount ();
@@ -111,13 +173,16 @@ protected:
     // decrement m_subordinate_static_object_count at this node and up through all parents
     void DecrementSubordinateStaticObjectCount ();
 
+    // builds the tree.  if split_threshold is 0, the tree is fully subdivided
+    // to the given depth, otherwise it is adaptive (see the comment above the
+    // class), with depth limiting how many levels it may have.
     template <typename QuadTreeClass>
-    void Initialize (FloatVector2 const &center, Float const half_side_length, Uint8 const depth);
+    void Initialize (FloatVector2 const &center, Float const half_side_length, Uint8 const depth, Uint32 const split_threshold = 0);
 
-    typedef std::set<Object *> ObjectSet;
+    typedef std::vector<Object *> ObjectVector;
 
-    // list of objects for this node
-    ObjectSet m_object_set;
+    // list of objects for this node (unordered -- see Object::OwnerQuadTreeIndex)
+    ObjectVector m_object_vector;
     // one child for each quadrant
     // 1st quadrant (X non-negative, Y non-negative)
     // 2nd quadrant (X non-positive, Y non-negative)
@@ -132,16 +197,78 @@ protected:
     Float m_half_side_length;
     // the radius of this quad node
     Float m_radius;
+    // see BoundFactor
+    Float m_bound_factor;
 
 private:
 
+    typedef void (*DeleteNodePoolFunction) (QuadTree *node_pool);
+    typedef QuadTree *(*CreateNodeFunction) ();
+
+    template <typename QuadTreeClass>
+    static void DeleteNodePool (QuadTree *node_pool)
+    {
+        delete[] DStaticCast<QuadTreeClass *>(node_pool);
+    }
+    template <typename QuadTreeClass>
+    static QuadTree *CreateNode ()
+    {
+        return new QuadTreeClass();
+    }
+
+    // sets up the geometry of a single node and clears its contents (used by Initialize)
+    void InitializeNode (QuadTree *parent, FloatVector2 const &center, Float half_side_length);
+    // sets up child as this node's child in the given quadrant
+    void AttachChild (Uint32 index, QuadTree *child);
+    // returns the index of the child whose quadrant contains the given point
+    Uint32 ChildIndex (FloatVector2 const &point) const;
+
+    // if this adaptive leaf node owns too many objects, creates its children
+    // and moves the objects which are small enough down into them.
+    void SplitIfNecessary ();
+    // deletes the children of each of node's ancestors which no longer have
+    // any objects below them, starting with node's parent.  node itself may
+    // be deleted by this.
+    static void CollapseEmptyNodes (QuadTree *node);
+
+    // appends the object to m_object_vector and sets the object's owner (does no counting)
+    void InsertIntoObjectVector (Object *object);
+    // swap-removes the object from m_object_vector and clears the object's owner (does no counting)
+    void EraseFromObjectVector (Object *object);
+
+    // the part of RemoveObject which doesn't collapse empty nodes
+    bool RemoveObjectWithoutCollapsing (Object *object);
+    // does the work of ReAddObject, recursing up or down the tree as necessary
+    bool ReAddObjectRecursive (Object *object);
     void NonRecursiveAddObject (Object *object);
     void AddObjectIfNotAlreadyAdded (Object *object);
 
+    // see ReAddObjectCallCount and ReAddObjectSkipCount
+    static Uint32 ms_re_add_object_call_count;
+    static Uint32 ms_re_add_object_skip_count;
+
+    // the contiguous block of all the nodes below this one -- only non-NULL
+    // for the root node of a tree built by Initialize.
+    QuadTree *m_node_pool;
+    // deletes m_node_pool (it must be deleted as an array of the subclass type)
+    DeleteNodePoolFunction m_delete_node_pool;
+    // allocates a node of the subclass type (used by adaptive trees to split nodes)
+    CreateNodeFunction m_create_node;
+    // true if m_child were allocated as part of a node pool (as opposed to
+    // individually, e.g. by VisibilityQuadTree::ReadStructure), in which
+    // case this node must not delete them.
+    bool m_children_are_pooled;
+
     // number of objects this quad node and all its children contain
     Uint32 m_subordinate_object_count;
     // number of non-entities this quad node and all its children contain
     Uint32 m_subordinate_static_object_count;
+    // see SplitThreshold
+    Uint32 m_split_threshold;
+    // see MaxDepth
+    Uint8 m_max_depth;
+    // the depth of this node (the root node is at depth 0)
+    Uint8 m_depth;
     // the quad_tree_type of quadtree this is (the index into
     // Engine2::Object::m_owner_quad_tree that stores a pointer to this
     // quadtree
@@ -152,45 +279,47 @@ template <typename QuadTreeClass>
 void QuadTree::Initialize (
     FloatVector2 const &center,
     Float const half_side_length,
-    Uint8 const depth)
+    Uint8 const depth,
+    Uint32 const split_threshold)
 {
     ASSERT1(half_side_length > 0.0f);
     ASSERT1(depth != 0);
+    ASSERT1(m_node_pool == NULL);
+
+    m_split_threshold = split_threshold;
+    m_max_depth = depth;
 
-    m_parent = NULL;
-    m_center = center;
-    m_half_side_length = half_side_length;
-    m_radius = Math::Sqrt(2.0f) * m_half_side_length;
-    m_subordinate_object_count = 0;
-    m_subordinate_static_object_count = 0;
-    if (depth <= 1)
+    // an adaptive tree starts out as just this node
+    if (split_threshold > 0)
     {
-        for (Uint8 i = 0; i < 4; ++i)
-            m_child[i] = NULL;
+        InitializeNode(NULL, center, half_side_length);
+        m_create_node = CreateNode<QuadTreeClass>;
+        return;
     }
-    else
+
+    ASSERT1(depth <= 15 && "quadtree node count would overflow");
+
+    // the nodes are numbered in breadth-first order, where node 0 is this
+    // one and node n > 0 is m_node_pool[n-1].  the children of node n are
+    // nodes 4n+1 through 4n+4.
+    Uint32 node_count = (Math::PowInt(4, depth) - 1) / 3;
+    Uint32 parent_node_count = node_count - Math::PowInt(4, depth - 1);
+    QuadTreeClass *node_pool = (node_count > 1) ? new QuadTreeClass[node_count - 1] : NULL;
+
+    InitializeNode(NULL, center, half_side_length);
+    m_node_pool = node_pool;
+    m_delete_node_pool = DeleteNodePool<QuadTreeClass>;
+    m_children_are_pooled = true;
+
+    for (Uint32 n = 0; n < parent_node_count; ++n)
     {
-        Float child_half_side_length = 0.5f * m_half_side_length;
-
-        m_child[0] = new QuadTreeClass(
-            center + child_half_side_length * FloatVector2( 1.0f,  1.0f),
-            child_half_side_length,
-            depth - 1);
-        m_child[1] = new QuadTreeClass(
-            center + child_half_side_length * FloatVector2(-1.0f,  1.0f),
-            child_half_side_length,
-            depth - 1);
-        m_child[2] = new QuadTreeClass(
-            center + child_half_side_length * FloatVector2(-1.0f, -1.0f),
-            child_half_side_length,
-            depth - 1);
-        m_child[3] = new QuadTreeClass(
-            center + child_half_side_length * FloatVector2( 1.0f, -1.0f),
-            child_half_side_length,
-            depth - 1);
-
-        for (Uint8 i = 0; i < 4; ++i)
-            m_child[i]->m_parent = this;
+        QuadTree *node = (n == 0) ? static_cast<QuadTree *>(this) : static_cast<QuadTree *>(&node_pool[n-1]);
+        for (Uint32 i = 0; i < 4; ++i)
+        {
+            QuadTree *child = &node_pool[4*n + i];
+            node->AttachChild(i, child);
+            child->m_children_are_pooled = true;
+        }
     }
 }
 
@@ -11,6 +11,7 @@
 #include "xrb_engine2_sprite.hpp"
 
 #include "xrb_engine2_animatedsprite.hpp"
+#include "xrb_engine2_spritebatch.hpp"
 #include "xrb_gl.hpp"
 #include "xrb_gltextureatlas.hpp"
 #include "xrb_rendercontext.hpp"
@@ -161,6 +162,25 @@ void Sprite::CalculateRadius (QuadTreeType const quad_tree_type) const
 
 void Sprite::RenderGlTexture (DrawData const &draw_data, GlTexture const &gltexture) const
 {
+    // if batching, just append the transformed quad to the batch, which
+    // will draw it along with the rest of its run.
+    if (draw_data.m_sprite_batch != NULL)
+    {
+        FloatVector2 vertex_array[4] =
+        {
+            FloatVector2(-1, -1),
+            FloatVector2( 1, -1),
+            FloatVector2(-1,  1),
+            FloatVector2( 1,  1)
+        };
+
+        for (Uint32 i = 0; i < 4; ++i)
+            vertex_array[i] = Transformation() * vertex_array[i];
+
+        draw_data.m_sprite_batch->AddQuad(vertex_array, gltexture, draw_data.m_color_mask, draw_data.m_color_bias);
+        return;
+    }
+
 #if !USE_SOFTWARE_TRANSFORM
     // set up the gl modelview matrix
     glMatrixMode(GL_MODELVIEW);
@@ -199,7 +219,7 @@ void Sprite::RenderGlTexture (DrawData const &draw_data, GlTexture const &gltext
              1,  1
         };
 
-        glVertexPointer(2, GL_SHORT, 0, s_vertex_array);
+        Gl::VertexPointer(2, GL_SHORT, 4, s_vertex_array);
 #else
         FloatVector2 vertex_array[4] =
         {
@@ -212,10 +232,10 @@ void Sprite::RenderGlTexture (DrawData const &draw_data, GlTexture const &gltext
         for (Uint32 i = 0; i < 4; ++i)
             vertex_array[i] = Transformation() * vertex_array[i];
 
-        glVertexPointer(2, GL_FLOAT, 0, vertex_array);
+        Gl::VertexPointer(2, GL_FLOAT, 4, vertex_array);
 #endif
-        glTexCoordPointer(2, GL_SHORT, 0, gltexture.TextureCoordinateArray());
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        Gl::TexCoordPointer(2, GL_SHORT, 4, gltexture.TextureCoordinateArray());
+        Gl::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
 
 #if !USE_SOFTWARE_TRANSFORM
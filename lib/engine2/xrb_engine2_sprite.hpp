@@ -50,6 +50,8 @@ public:
 
     // draws this sprite
     virtual void Draw (DrawData const &draw_data) const;
+    // sprites are drawn as a single textured quad, so they can be batched
+    virtual bool DrawsIntoSpriteBatch () const { return true; }
     // create a clone of this object (sprite)
     virtual Object *Clone () const;
 
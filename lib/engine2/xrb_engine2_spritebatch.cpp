@@ -0,0 +1,145 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_engine2_spritebatch.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "xrb_engine2_spritebatch.hpp"
+
+#include "xrb_gl.hpp"
+#include "xrb_gltexture.hpp"
+
+namespace Xrb {
+namespace Engine2 {
+
+// the triangle strip vertex indices of the two triangles making up a quad
+static Uint32 const gs_quad_triangle_index[6] = { 0, 1, 2, 2, 1, 3 };
+
+Uint32 SpriteBatch::ms_draw_call_count = 0;
+Uint32 SpriteBatch::ms_quad_count = 0;
+
+SpriteBatch::SpriteBatch (bool is_retained)
+    :
+    m_is_retained(is_retained),
+    m_run_vertex_index(0),
+    m_gltexture(NULL),
+    m_atlas(NULL),
+    m_translation(FloatVector2::ms_zero)
+{ }
+
+void SpriteBatch::ResetCounts ()
+{
+    ms_draw_call_count = 0;
+    ms_quad_count = 0;
+}
+
+void SpriteBatch::AddQuad (
+    FloatVector2 const *vertex_array,
+    GlTexture const &gltexture,
+    Color const &color_mask,
+    Color const &color_bias)
+{
+    ASSERT3(vertex_array != NULL);
+
+    // start a new run if the state changes (the color mask isn't state)
+    if (!IsEmpty() && (&gltexture.Atlas() != m_atlas || color_bias != m_color_bias))
+        Flush();
+    if (IsEmpty())
+    {
+        m_gltexture = &gltexture;
+        m_atlas = &gltexture.Atlas();
+        m_color_bias = color_bias;
+    }
+
+    Uint32 color_mask_rgba = color_mask.Rgba();
+    Sint16 const *texture_coordinate_array = gltexture.TextureCoordinateArray();
+    for (Uint32 i = 0; i < 6; ++i)
+    {
+        Uint32 index = gs_quad_triangle_index[i];
+        m_vertex_array.push_back(vertex_array[index] + m_translation);
+        m_texture_coordinate_array.push_back(texture_coordinate_array[2*index]);
+        m_texture_coordinate_array.push_back(texture_coordinate_array[2*index+1]);
+        m_color_array.push_back(color_mask_rgba);
+    }
+}
+
+void SpriteBatch::Flush ()
+{
+    if (IsEmpty())
+        return;
+
+    ASSERT1(m_gltexture != NULL);
+    ASSERT1(m_texture_coordinate_array.size() == 2*m_vertex_array.size());
+    ASSERT1(m_color_array.size() == m_vertex_array.size());
+    ASSERT1((m_vertex_array.size() - m_run_vertex_index) % 6 == 0);
+
+    Run run(m_gltexture, m_color_bias, m_run_vertex_index, m_vertex_array.size() - m_run_vertex_index);
+    if (m_is_retained)
+    {
+        m_run_vector.push_back(run);
+        m_run_vertex_index = m_vertex_array.size();
+    }
+    else
+    {
+        DrawRun(run);
+        // clear (but keep the capacity of) the arrays for the next run
+        m_vertex_array.clear();
+        m_texture_coordinate_array.clear();
+        m_color_array.clear();
+        ASSERT1(m_run_vertex_index == 0);
+    }
+    m_gltexture = NULL;
+    m_atlas = NULL;
+}
+
+void SpriteBatch::Draw ()
+{
+    ASSERT1(m_is_retained);
+    ASSERT1(IsEmpty() && "the current run hasn't been flushed");
+    for (RunVector::const_iterator it = m_run_vector.begin(), it_end = m_run_vector.end(); it != it_end; ++it)
+        DrawRun(*it);
+}
+
+void SpriteBatch::Clear ()
+{
+    m_vertex_array.clear();
+    m_texture_coordinate_array.clear();
+    m_color_array.clear();
+    m_run_vector.clear();
+    m_run_vertex_index = 0;
+    m_gltexture = NULL;
+    m_atlas = NULL;
+}
+
+void SpriteBatch::DrawRun (Run const &run)
+{
+    ASSERT1(run.m_gltexture != NULL);
+    ASSERT1(run.m_vertex_index + run.m_vertex_count <= m_vertex_array.size());
+
+    // texture unit 0 modulates the texture by the primary color, which comes
+    // from the color array here, so the mask passed in is ignored.
+    Singleton::Gl().SetupTextureUnits(*run.m_gltexture, Color::ms_identity_color_mask, run.m_color_bias);
+
+    Gl::EnableClientState(GL_VERTEX_ARRAY);
+    ASSERT1(Gl::ClientActiveTexture() == GL_TEXTURE0);
+    Gl::EnableClientState(GL_TEXTURE_COORD_ARRAY);
+    Gl::EnableClientState(GL_COLOR_ARRAY);
+
+    Gl::VertexPointer(2, GL_FLOAT, run.m_vertex_count, &m_vertex_array[run.m_vertex_index]);
+    Gl::TexCoordPointer(2, GL_SHORT, run.m_vertex_count, &m_texture_coordinate_array[2*run.m_vertex_index]);
+    Gl::ColorPointer(4, GL_UNSIGNED_BYTE, run.m_vertex_count, &m_color_array[run.m_vertex_index]);
+    Gl::DrawArrays(GL_TRIANGLES, 0, run.m_vertex_count);
+
+    // everything else uses glColor for the color mask
+    Gl::DisableClientState(GL_COLOR_ARRAY);
+
+    ++ms_draw_call_count;
+    ms_quad_count += run.m_vertex_count / 6;
+}
+
+} // end of namespace Engine2
+} // end of namespace Xrb
@@ -0,0 +1,127 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_engine2_spritebatch.hpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#if !defined(_XRB_ENGINE2_SPRITEBATCH_HPP_)
+#define _XRB_ENGINE2_SPRITEBATCH_HPP_
+
+#include "xrb.hpp"
+
+#include <vector>
+
+#include "xrb_color.hpp"
+#include "xrb_vector.hpp"
+
+namespace Xrb {
+
+class GlTexture;
+class GlTextureAtlas;
+
+namespace Engine2 {
+
+/// @brief Accumulates textured quads which share the same openGL state, so that each run of them is drawn with a single draw call.
+/// @details VisibilityQuadTree::Draw sorts the objects it draws by texture atlas and color bias,
+/// so consecutive sprites generally use the same state.  Sprite::Draw appends its quad via AddQuad,
+/// which flushes the current run only when the atlas or color bias changes.  The color mask (which
+/// includes the per-object distance fade, and so is different for nearly every object) is carried
+/// per vertex instead of as openGL state.  Flush must be called before drawing anything which
+/// doesn't go through the batch (and at the end of drawing), so that the draw order is preserved.
+///
+/// A retained SpriteBatch doesn't draw anything when flushed; it keeps its runs so that they can
+/// be drawn any number of times with Draw (see StaticDrawCache).
+class SpriteBatch
+{
+public:
+
+    SpriteBatch (bool is_retained = false);
+
+    /// The number of glDrawArrays calls made by all SpriteBatches since the last ResetCounts.
+    static Uint32 DrawCallCount () { return ms_draw_call_count; }
+    /// The number of quads drawn by all SpriteBatches since the last ResetCounts.
+    static Uint32 QuadCount () { return ms_quad_count; }
+    static void ResetCounts ();
+
+    bool IsRetained () const { return m_is_retained; }
+    /// Returns true iff there are no quads in the current (unflushed) run.
+    bool IsEmpty () const { return m_vertex_array.size() == m_run_vertex_index; }
+    /// The number of runs kept by a retained batch (i.e. the draw calls Draw will make).
+    Uint32 RetainedRunCount () const { return m_run_vector.size(); }
+
+    /// Sets the offset which is added to the vertices of the quads added from now on
+    /// (e.g. a wrapped ObjectLayer's tile offset).
+    void SetTranslation (FloatVector2 const &translation) { m_translation = translation; }
+
+    /// @brief Appends a quad to the current run, first flushing the run if its atlas or color bias differs.
+    /// @details vertex_array must contain the 4 world-space corners of the quad in the same
+    /// (triangle strip) order as GlTexture::TextureCoordinateArray.
+    void AddQuad (
+        FloatVector2 const *vertex_array,
+        GlTexture const &gltexture,
+        Color const &color_mask,
+        Color const &color_bias);
+    /// @brief Ends the current run (if any).
+    /// @details A non-retained batch draws the run with a single GL_TRIANGLES call and
+    /// empties itself.  A retained batch keeps the run for Draw.
+    void Flush ();
+    /// Draws all the runs kept by a retained batch.
+    void Draw ();
+    /// Discards everything, including the runs kept by a retained batch.
+    void Clear ();
+
+private:
+
+    struct Run
+    {
+        // only used for Gl::SetupTextureUnits, which only uses its atlas.
+        GlTexture const *m_gltexture;
+        Color m_color_bias;
+        Uint32 m_vertex_index;
+        Uint32 m_vertex_count;
+
+        Run (GlTexture const *gltexture, Color const &color_bias, Uint32 vertex_index, Uint32 vertex_count)
+            :
+            m_gltexture(gltexture),
+            m_color_bias(color_bias),
+            m_vertex_index(vertex_index),
+            m_vertex_count(vertex_count)
+        { }
+    }; // end of struct SpriteBatch::Run
+
+    typedef std::vector<Run> RunVector;
+
+    void DrawRun (Run const &run);
+
+    bool const m_is_retained;
+    // the corners of the quads, 6 per quad (two triangles)
+    std::vector<FloatVector2> m_vertex_array;
+    // the texture coordinates (in atlas pixels), 12 per quad
+    std::vector<Sint16> m_texture_coordinate_array;
+    // the color masks, in 32 bit RGBA format, 6 per quad
+    std::vector<Uint32> m_color_array;
+    // the runs kept by a retained batch
+    RunVector m_run_vector;
+    // the index in m_vertex_array of the first vertex of the current run
+    Uint32 m_run_vertex_index;
+    // the state of the current run
+    GlTexture const *m_gltexture;
+    GlTextureAtlas const *m_atlas;
+    Color m_color_bias;
+    // see SetTranslation
+    FloatVector2 m_translation;
+
+    // see DrawCallCount and QuadCount
+    static Uint32 ms_draw_call_count;
+    static Uint32 ms_quad_count;
+}; // end of class Engine2::SpriteBatch
+
+} // end of namespace Engine2
+} // end of namespace Xrb
+
+#endif // !defined(_XRB_ENGINE2_SPRITEBATCH_HPP_)
+
@@ -10,6 +10,8 @@
 
 #include "xrb_engine2_types.hpp"
 
+#include <string.h>
+
 #include "xrb_engine2_object.hpp"
 #include "xrb_rendercontext.hpp"
 
@@ -37,9 +39,12 @@ int DrawObject::Compare (void const *l_, void const *r_)
     // - rendering params (to minimize the number of openGL calls)
     //     * texture atlas
     //     * color bias
-    //     * color mask
-    // - pointer values (wouldn't want this if we combined all wrapped rendering
-    //                   into one std::sort.  see VisibilityQuadTree::DrawWrapped)
+    //   the color mask isn't a criterion, because SpriteBatch carries it
+    //   per vertex (and with the distance fade applied, it's different for
+    //   nearly every object, which would break up the batches).
+    // - pointer values (DrawObjectCollector::Sort breaks ties by collection
+    //                   order instead, since VisibilityQuadTree::DrawWrapped
+    //                   collects the same object once per wrapped copy)
 
     Sint32 c;
 
@@ -61,12 +66,6 @@ int DrawObject::Compare (void const *l_, void const *r_)
         return c;
     // otherwise they're equal, so continue.
 
-    c = Xrb::Compare(l.m_color_mask_rgba, r.m_color_mask_rgba);
-    if (c != 0)
-//         return c < 0;
-        return c;
-    // otherwise they're equal, so continue.
-
     // the final test is pointer values.
 //     return l.m_object < r.m_object;
     return Xrb::Compare(l.m_object, r.m_object);
@@ -82,8 +81,11 @@ DrawObjectCollector::DrawObjectCollector ()
     m_pixels_in_view_radius(0.0f),
     m_view_center(FloatVector2::ms_zero),
     m_view_radius(0.0f),
-    m_object_layer(NULL)
-{ }
+    m_object_layer(NULL),
+    m_translation(FloatVector2::ms_zero)
+{
+    Clear();
+}
 
 void DrawObjectCollector::operator () (Object const *object)
 {
@@ -102,8 +104,156 @@ void DrawObjectCollector::operator () (Object const *object)
         Color color_mask(m_render_context->MaskedColor(object->ColorMask()));
         color_mask[Dim::A] *= Object::CalculateDistanceFade(object_radius);
         // add the DrawObject
-        m_draw_object.push_back(DrawObject(object, color_bias.Rgba(), color_mask.Rgba()));
+        AddDrawObject(object, color_bias.Rgba(), color_mask.Rgba());
+    }
+}
+
+void DrawObjectCollector::Clear ()
+{
+    m_draw_object.clear();
+    m_color_bias_index_map.clear();
+    // the usual color bias (transparent black, i.e. none) gets index 0,
+    // which also primes the last-lookup cache in ColorBiasIndex.
+    m_color_bias_index_map[Color::ms_identity_color_bias.Rgba()] = 0;
+    m_last_color_bias_rgba = Color::ms_identity_color_bias.Rgba();
+    m_last_color_bias_index = 0;
+}
+
+void DrawObjectCollector::AddDrawObject (Object const *object, Uint32 color_bias_rgba, Uint32 color_mask_rgba)
+{
+    ASSERT3(object != NULL);
+    // the object's virtual methods are called only here, once per object,
+    // instead of once per comparison during the sort.
+    Uint64 sort_key = SortKey(object->ZDepth(), object->GlTextureAtlasHandle(), ColorBiasIndex(color_bias_rgba));
+    m_draw_object.push_back(DrawObject(object, color_bias_rgba, color_mask_rgba, sort_key, m_translation));
+}
+
+void DrawObjectCollector::Sort ()
+{
+    Uint32 const radix_bits = 8;
+    Uint32 const radix = 1 << radix_bits;
+    Uint32 const pass_count = 64 / radix_bits;
+
+    Uint32 count = m_draw_object.size();
+    if (count <= 1)
+        return;
+
+    // histogram all the digits at once
+    Uint32 histogram[pass_count][radix];
+    memset(histogram, 0, sizeof(histogram));
+    for (Uint32 i = 0; i < count; ++i)
+    {
+        Uint64 sort_key = m_draw_object[i].m_sort_key;
+        for (Uint32 pass = 0; pass < pass_count; ++pass)
+            ++histogram[pass][(sort_key >> (pass*radix_bits)) & (radix-1)];
     }
+
+    // least significant digit first.  each pass is stable, so the whole sort is.
+    m_sort_buffer.resize(count, m_draw_object[0]);
+    for (Uint32 pass = 0; pass < pass_count; ++pass)
+    {
+        Uint32 *pass_histogram = histogram[pass];
+        // skip the digits every key has in common (e.g. the high bits of
+        // the z depth, which is usually the same throughout an ObjectLayer).
+        if (pass_histogram[(m_draw_object[0].m_sort_key >> (pass*radix_bits)) & (radix-1)] == count)
+            continue;
+
+        // turn the histogram into the starting index of each digit's bucket
+        Uint32 start = 0;
+        for (Uint32 digit = 0; digit < radix; ++digit)
+        {
+            Uint32 digit_count = pass_histogram[digit];
+            pass_histogram[digit] = start;
+            start += digit_count;
+        }
+
+        for (Uint32 i = 0; i < count; ++i)
+        {
+            DrawObject const &draw_object = m_draw_object[i];
+            m_sort_buffer[pass_histogram[(draw_object.m_sort_key >> (pass*radix_bits)) & (radix-1)]++] = draw_object;
+        }
+        m_draw_object.swap(m_sort_buffer);
+    }
+}
+
+Uint64 DrawObjectCollector::SortKey (Float z_depth, Uint32 gltexture_atlas_handle, Uint32 color_bias_index)
+{
+    // map the float's bits to an unsigned integer with the same ordering
+    // (flip all the bits of negatives, and just the sign bit of positives),
+    // then invert it so that greater z depths come first.
+    Uint32 z_depth_bits;
+    ASSERT1(sizeof(z_depth_bits) == sizeof(z_depth));
+    memcpy(&z_depth_bits, &z_depth, sizeof(z_depth_bits));
+    z_depth_bits ^= (z_depth_bits & 0x80000000) != 0 ? 0xFFFFFFFF : 0x80000000;
+    z_depth_bits = ~z_depth_bits;
+
+    return (static_cast<Uint64>(z_depth_bits) << 32) |
+           (static_cast<Uint64>(Min(gltexture_atlas_handle, Uint32(0xFFFF))) << 16) |
+           static_cast<Uint64>(Min(color_bias_index, Uint32(0xFFFF)));
+}
+
+Uint32 DrawObjectCollector::ColorBiasIndex (Uint32 color_bias_rgba)
+{
+    if (color_bias_rgba == m_last_color_bias_rgba)
+        return m_last_color_bias_index;
+
+    ColorBiasIndexMap::iterator it = m_color_bias_index_map.find(color_bias_rgba);
+    if (it == m_color_bias_index_map.end())
+    {
+        Uint32 color_bias_index = m_color_bias_index_map.size();
+        it = m_color_bias_index_map.insert(ColorBiasIndexMap::value_type(color_bias_rgba, color_bias_index)).first;
+    }
+    m_last_color_bias_rgba = color_bias_rgba;
+    m_last_color_bias_index = it->second;
+    return it->second;
+}
+
+// ///////////////////////////////////////////////////////////////////////////
+// StaticDrawCache
+// ///////////////////////////////////////////////////////////////////////////
+
+Float const StaticDrawCache::ms_region_radius_factor = 2.0f;
+Float const StaticDrawCache::ms_scale_tolerance = 0.01f;
+
+StaticDrawCache::StaticDrawCache ()
+    :
+    m_sprite_batch(true)
+{
+    Invalidate();
+}
+
+bool StaticDrawCache::IsValidFor (DrawObjectCollector const &draw_object_collector) const
+{
+    ASSERT1(draw_object_collector.m_render_context != NULL);
+    ASSERT1(draw_object_collector.m_view_radius > 0.0f);
+
+    if (!m_is_valid)
+        return false;
+
+    // the view must be entirely inside the cached region
+    if ((draw_object_collector.m_view_center - m_region_center).Length() + draw_object_collector.m_view_radius > m_region_radius)
+        return false;
+
+    Float pixels_per_unit = draw_object_collector.m_pixels_in_view_radius / draw_object_collector.m_view_radius;
+    if (Abs(pixels_per_unit - m_pixels_per_unit) > ms_scale_tolerance * m_pixels_per_unit)
+        return false;
+
+    RenderContext const &render_context = *draw_object_collector.m_render_context;
+    return render_context.ColorMask().Rgba() == m_color_mask_rgba &&
+           render_context.ColorBias().Rgba() == m_color_bias_rgba;
+}
+
+void StaticDrawCache::Invalidate ()
+{
+    m_sprite_batch.Clear();
+    m_is_valid = false;
+    m_is_uncacheable = false;
+    m_region_center = FloatVector2::ms_zero;
+    m_region_radius = 0.0f;
+    m_pixels_per_unit = 0.0f;
+    m_color_mask_rgba = 0;
+    m_color_bias_rgba = 0;
+    m_object_count = 0;
 }
 
 } // end of namespace Engine2
@@ -13,9 +13,11 @@
 
 #include "xrb.hpp"
 
+#include <map>
 #include <vector>
 
 #include "xrb_color.hpp"
+#include "xrb_engine2_spritebatch.hpp"
 #include "xrb_vector.hpp"
 
 namespace Xrb {
@@ -43,16 +45,27 @@ struct DrawObject
     Object const *m_object;
     Uint32 m_color_bias_rgba; // color bias munged through the render context, in 32 bit RGBA format
     Uint32 m_color_mask_rgba; // color mask munged through the render context, with distance fade applied, in 32 bit RGBA format
-
-    DrawObject (Object const *object, Uint32 color_bias_rgba, Uint32 color_mask_rgba)
+    Uint64 m_sort_key; // see DrawObjectCollector::SortKey
+    FloatVector2 m_translation; // offset of the wrapped copy of the object layer this was collected from
+
+    DrawObject (
+        Object const *object,
+        Uint32 color_bias_rgba,
+        Uint32 color_mask_rgba,
+        Uint64 sort_key,
+        FloatVector2 const &translation = FloatVector2::ms_zero)
         :
         m_object(object),
         m_color_bias_rgba(color_bias_rgba),
-        m_color_mask_rgba(color_mask_rgba)
+        m_color_mask_rgba(color_mask_rgba),
+        m_sort_key(sort_key),
+        m_translation(translation)
     {
         ASSERT1(m_object != NULL);
     }
 
+    // the comparison-based ordering DrawObjectCollector::Sort replaced (it
+    // reads the z depth and atlas handle through m_object on every call).
     // had to use C-style qsort because std::sort was handing me bad pointers.
     static int Compare (void const *l, void const *r);
 }; // end of struct Engine2::DrawObject
@@ -75,13 +88,90 @@ struct DrawObjectCollector
     FloatVector2 m_view_center;
     Float m_view_radius;
     ObjectLayer const *m_object_layer;
+    // stored in each DrawObject added (see VisibilityQuadTree::DrawWrapped)
+    FloatVector2 m_translation;
+    // used to draw each run of sorted sprites which share the same
+    // state with a single draw call.  kept here to reuse its buffers.
+    SpriteBatch m_sprite_batch;
 
     DrawObjectCollector ();
 
     // this is the functorial method which collects vectors from quadtree nodes
     void operator () (Object const *object);
+
+    // clears the collected objects (and the color bias indices used by their sort keys)
+    void Clear ();
+    // adds a DrawObject for the given object, computing its sort key
+    void AddDrawObject (Object const *object, Uint32 color_bias_rgba, Uint32 color_mask_rgba);
+    // stably sorts m_draw_object by sort key (back-to-front, and then by
+    // atlas and color bias), using a radix sort.
+    void Sort ();
+
+    // packs the draw order criteria into a single integer which sorts in
+    // the same order, most important first:
+    // - z depth, greatest first (correctness of draw order) -- the top 32 bits
+    // - atlas handle (to minimize the number of openGL calls) -- 16 bits
+    // - color bias index (see ColorBiasIndex) -- 16 bits
+    // atlas handles and color bias indices too large for their fields are
+    // clamped, which only costs some batching, never draw order correctness.
+    static Uint64 SortKey (Float z_depth, Uint32 gltexture_atlas_handle, Uint32 color_bias_index);
+
+private:
+
+    // returns a small integer identifying the given color bias, in the order
+    // they were first seen since the last call to Clear.
+    Uint32 ColorBiasIndex (Uint32 color_bias_rgba);
+
+    typedef std::map<Uint32, Uint32> ColorBiasIndexMap;
+
+    ColorBiasIndexMap m_color_bias_index_map;
+    // the most recently looked up color bias (most objects have the same one)
+    Uint32 m_last_color_bias_rgba;
+    Uint32 m_last_color_bias_index;
+    // scratch space for Sort
+    DrawObjectVector m_sort_buffer;
 }; // end of struct Engine2::DrawObjectCollector
 
+// the retained, already sorted and batched drawing of the objects in and
+// around the view of an ObjectLayer whose contents never change (see
+// ObjectLayer::SetUsesStaticDrawCache).  it covers a region larger than
+// the view, so it stays valid while the view pans within that region.
+struct StaticDrawCache
+{
+    // the radius of the cached region, relative to the view radius
+    static Float const ms_region_radius_factor;
+    // the relative change in view scale (e.g. from zooming) which
+    // invalidates the cache (distance culling and fade depend on it)
+    static Float const ms_scale_tolerance;
+
+    // retained, so that it keeps the runs for drawing each frame
+    SpriteBatch m_sprite_batch;
+    // false if it must be rebuilt before drawing
+    bool m_is_valid;
+    // set if some object can't be cached (e.g. a Compound or AnimatedSprite),
+    // in which case the ObjectLayer is drawn normally until invalidated.
+    bool m_is_uncacheable;
+    // the cached region
+    FloatVector2 m_region_center;
+    Float m_region_radius;
+    // the view scale (DrawObjectCollector::m_pixels_in_view_radius over
+    // DrawObjectCollector::m_view_radius) the cache was built with
+    Float m_pixels_per_unit;
+    // the render context color mask and bias the cache was built with
+    Uint32 m_color_mask_rgba;
+    Uint32 m_color_bias_rgba;
+    // the number of objects in the cache
+    Uint32 m_object_count;
+
+    StaticDrawCache ();
+
+    // returns true iff the cache can be drawn in place of drawing the view
+    // described by draw_object_collector.
+    bool IsValidFor (DrawObjectCollector const &draw_object_collector) const;
+    // call this when the ObjectLayer's contents change
+    void Invalidate ();
+}; // end of struct Engine2::StaticDrawCache
+
 } // end of namespace Engine2
 } // end of namespace Xrb
 
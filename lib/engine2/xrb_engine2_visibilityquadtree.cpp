@@ -11,10 +11,10 @@
 #include "xrb_engine2_visibilityquadtree.hpp"
 
 #include <algorithm>
-#include <cstdlib>
 
 #include "xrb_engine2_entity.hpp"
 #include "xrb_engine2_objectlayer.hpp"
+#include "xrb_engine2_spritebatch.hpp"
 #include "xrb_gl.hpp"
 #include "xrb_render.hpp"
 #include "xrb_rendercontext.hpp"
@@ -30,20 +30,24 @@ namespace Engine2 {
 VisibilityQuadTree::VisibilityQuadTree (
     FloatVector2 const &center,
     Float const half_side_length,
-    Uint8 const depth)
+    Uint8 const depth,
+    Float const bound_factor,
+    Uint32 const split_threshold)
     :
     QuadTree(NULL)
 {
-    Initialize<VisibilityQuadTree>(center, half_side_length, depth);
+    Initialize<VisibilityQuadTree>(center, half_side_length, depth, split_threshold);
     SetQuadTreeType(QTT_VISIBILITY);
+    SetBoundFactor(bound_factor);
 }
 
-VisibilityQuadTree *VisibilityQuadTree::Create (Serializer &serializer)
+VisibilityQuadTree *VisibilityQuadTree::Create (Serializer &serializer, Float const bound_factor)
 {
     VisibilityQuadTree *retval = new VisibilityQuadTree(NULL);
 
     retval->ReadStructure(serializer);
     retval->SetQuadTreeType(QTT_VISIBILITY);
+    retval->SetBoundFactor(bound_factor);
     // the objects are left to be read once this new quadtree
     // is returned to the objectlayer
 
@@ -113,8 +117,8 @@ Uint32 VisibilityQuadTree::WriteObjects (Serializer &serializer) const
     Uint32 retval = 0;
 
     // write out the non-entities that this quad node contains
-    for (ObjectSet::const_iterator it = m_object_set.begin(),
-                                   it_end = m_object_set.end();
+    for (ObjectVector::const_iterator it = m_object_vector.begin(),
+                                      it_end = m_object_vector.end();
          it != it_end;
          ++it)
     {
@@ -153,28 +157,15 @@ Uint32 VisibilityQuadTree::Draw (
         return 0;
 
     // clear the collection vector and collect objects to draw
-    draw_object_collector.m_draw_object.clear();
+    draw_object_collector.Clear();
     CollectDrawObjects(draw_object_collector);
     // sort objects (back-to-front, and then by other criteria)
-//     std::sort(draw_object_collector.m_draw_object.begin(), draw_object_collector.m_draw_object.end(), DrawObjectOrder());
-    // NOTE: qsort is being used because std::sort was handing me bad pointers.
-    std::qsort(&draw_object_collector.m_draw_object[0], draw_object_collector.m_draw_object.size(), sizeof(DrawObject), DrawObject::Compare);
-
+    draw_object_collector.Sort();
     // now draw them
-    Object::DrawData draw_data(render_context, world_to_screen);
-    for (DrawObjectVector::const_iterator it = draw_object_collector.m_draw_object.begin(),
-                                          it_end = draw_object_collector.m_draw_object.end();
-         it != it_end;
-         ++it)
-    {
-        DrawObject const &draw_object = *it;
-        ASSERT3(draw_object.m_object != NULL);
-        draw_data.m_color_bias = Color(draw_object.m_color_bias_rgba);
-        draw_data.m_color_mask = Color(draw_object.m_color_mask_rgba);
-        draw_object.m_object->Draw(draw_data);
-    }
+    DrawCollectedObjects(render_context, world_to_screen, draw_object_collector);
+
     Uint32 drawn_object_count = draw_object_collector.m_draw_object.size();
-    draw_object_collector.m_draw_object.clear(); // might as well clear the vector again
+    draw_object_collector.Clear(); // might as well clear the vector again
     return drawn_object_count;
 }
 
@@ -185,50 +176,59 @@ Uint32 VisibilityQuadTree::DrawWrapped (
     ObjectLayer const &object_layer) const
 {
     ASSERT1(m_parent == NULL && "this can only be called on the root node");
-
-    Uint32 drawn_object_count = 0;
+    ASSERT1(draw_object_collector.m_object_layer != NULL);
 
     // if there are no objects, just return
     if (SubordinateObjectCount() == 0)
-        return drawn_object_count;
+        return 0;
 
-    ASSERT2(m_half_side_length > 0.0f);
+    // collect the objects from all the visible wrapped copies of the quadtree
+    // at once (each DrawObject records its copy's offset), so that they're
+    // sorted and batched together, instead of once per copy.
+    std::vector<FloatVector2> view_offset_vector;
+    WrappedViewOffsets(draw_object_collector.m_view_center, draw_object_collector.m_view_radius, view_offset_vector);
+    draw_object_collector.Clear();
+    CollectWrappedDrawObjects(draw_object_collector, view_offset_vector);
+    draw_object_collector.Sort();
 
-    Float side_length = SideLength();
-    Float radius_sum = 2.0f*Radius() + draw_object_collector.m_view_radius;
-    Float top = floor((draw_object_collector.m_view_center[Dim::Y]+radius_sum)/side_length);
-    Float bottom = ceil((draw_object_collector.m_view_center[Dim::Y]-radius_sum)/side_length);
-    Float left = ceil((draw_object_collector.m_view_center[Dim::X]-radius_sum)/side_length);
-    Float right = floor((draw_object_collector.m_view_center[Dim::X]+radius_sum)/side_length);
-    FloatVector2 old_view_center(draw_object_collector.m_view_center);
-    FloatVector2 view_offset;
+    // the offsets are applied per object, relative to the untranslated modelview matrix.
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    DrawCollectedObjects(render_context, world_to_screen, draw_object_collector);
 
-    for (Float x = left; x <= right; x += 1.0f)
-    {
-        for (Float y = bottom; y <= top; y += 1.0f)
-        {
-            view_offset.SetComponents(side_length*x, side_length*y);
-            // this IF statement culls quadtree nodes that are outside of the
-            // circular view radius from the square grid of nodes to be drawn
-            if ((old_view_center - view_offset).LengthSquared() < Sqr(radius_sum))
-            {
-                draw_object_collector.m_view_center = old_view_center - view_offset;
+    Uint32 drawn_object_count = draw_object_collector.m_draw_object.size();
+    draw_object_collector.Clear(); // might as well clear the vector again
+    return drawn_object_count;
+}
 
-                glMatrixMode(GL_MODELVIEW);
-                glLoadIdentity();
-                glTranslatef(
-                    view_offset[Dim::X],
-                    view_offset[Dim::Y],
-                    0.0f);
+Uint32 VisibilityQuadTree::DrawStaticDrawCache (
+    RenderContext const &render_context,
+    FloatMatrix2 const &world_to_screen,
+    DrawObjectCollector &draw_object_collector,
+    ObjectLayer const &object_layer,
+    StaticDrawCache &static_draw_cache) const
+{
+    ASSERT1(m_parent == NULL && "this can only be called on the root node");
 
-                // call the non-wrapped Draw.  NOTE: the world_to_screen transformation here is wrong
-                // by a translation of view_offset.
-                drawn_object_count += Draw(render_context, world_to_screen, draw_object_collector, object_layer);
-            }
-        }
+    // only static objects can be cached
+    if (SubordinateObjectCount() == 0 || SubordinateStaticObjectCount() != SubordinateObjectCount())
+        static_draw_cache.Invalidate();
+    else if (!static_draw_cache.m_is_uncacheable && !static_draw_cache.IsValidFor(draw_object_collector))
+        RebuildStaticDrawCache(render_context, world_to_screen, draw_object_collector, object_layer, static_draw_cache);
+
+    if (!static_draw_cache.m_is_valid)
+    {
+        if (object_layer.IsWrapped())
+            return DrawWrapped(render_context, world_to_screen, draw_object_collector, object_layer);
+        else
+            return Draw(render_context, world_to_screen, draw_object_collector, object_layer);
     }
 
-    return drawn_object_count;
+    // the tile offsets of wrapped layers are baked into the cached vertices
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    static_draw_cache.m_sprite_batch.Draw();
+    return static_draw_cache.m_object_count;
 }
 
 void VisibilityQuadTree::DrawBounds (RenderContext const &render_context, Color const &color) const
@@ -288,7 +288,7 @@ void VisibilityQuadTree::CollectDrawObjects (DrawObjectCollector &draw_object_co
     // gs_radius_limit_lower threshold -- a form of distance culling,
     // which gives a huge speedup and allows zooming to any level
     // maintain a consistent framerate.
-    if (draw_object_collector.m_pixels_in_view_radius * Radius()
+    if (draw_object_collector.m_pixels_in_view_radius * MaxObjectRadius()
         <
         draw_object_collector.m_view_radius * Object::ms_radius_limit_lower)
     {
@@ -303,7 +303,7 @@ void VisibilityQuadTree::CollectDrawObjects (DrawObjectCollector &draw_object_co
     // be lost when that locally scoped object is destroyed at the end of std::for_each.
     // we want 'the' instance of draw_object_collector (not a copy) to be used on each
     // element of the set.
-    std::for_each<ObjectSet::const_iterator, DrawObjectCollector &>(m_object_set.begin(), m_object_set.end(), draw_object_collector);
+    std::for_each<ObjectVector::const_iterator, DrawObjectCollector &>(m_object_vector.begin(), m_object_vector.end(), draw_object_collector);
 
     // if there are child nodes, call Draw on each
     if (HasChildren())
@@ -311,5 +311,187 @@ void VisibilityQuadTree::CollectDrawObjects (DrawObjectCollector &draw_object_co
             Child<VisibilityQuadTree>(i)->CollectDrawObjects(draw_object_collector);
 }
 
+void VisibilityQuadTree::CollectWrappedDrawObjects (
+    DrawObjectCollector &draw_object_collector,
+    std::vector<FloatVector2> const &view_offset_vector) const
+{
+    FloatVector2 view_center(draw_object_collector.m_view_center);
+    for (std::vector<FloatVector2>::const_iterator it = view_offset_vector.begin(),
+                                                   it_end = view_offset_vector.end();
+         it != it_end;
+         ++it)
+    {
+        // collecting with the view moved by -offset is equivalent to
+        // collecting from a copy of the quadtree moved by +offset.
+        draw_object_collector.m_view_center = view_center - *it;
+        draw_object_collector.m_translation = *it;
+        CollectDrawObjects(draw_object_collector);
+    }
+    draw_object_collector.m_view_center = view_center;
+    draw_object_collector.m_translation = FloatVector2::ms_zero;
+}
+
+void VisibilityQuadTree::DrawCollectedObjects (
+    RenderContext const &render_context,
+    FloatMatrix2 const &world_to_screen,
+    DrawObjectCollector &draw_object_collector) const
+{
+    // sprites are accumulated in the sprite batch, which draws each run
+    // of them sharing the same atlas and color bias at once.
+    SpriteBatch &sprite_batch = draw_object_collector.m_sprite_batch;
+    ASSERT1(sprite_batch.IsEmpty());
+    Object::DrawData draw_data(render_context, world_to_screen);
+    for (DrawObjectVector::const_iterator it = draw_object_collector.m_draw_object.begin(),
+                                          it_end = draw_object_collector.m_draw_object.end();
+         it != it_end;
+         ++it)
+    {
+        DrawObject const &draw_object = *it;
+        ASSERT3(draw_object.m_object != NULL);
+        draw_data.m_color_bias = Color(draw_object.m_color_bias_rgba);
+        draw_data.m_color_mask = Color(draw_object.m_color_mask_rgba);
+        if (draw_object.m_object->DrawsIntoSpriteBatch())
+        {
+            draw_data.m_sprite_batch = &sprite_batch;
+            sprite_batch.SetTranslation(draw_object.m_translation);
+            draw_object.m_object->Draw(draw_data);
+        }
+        else
+        {
+            // anything batched so far must be drawn before this object
+            sprite_batch.Flush();
+            draw_data.m_sprite_batch = NULL;
+            if (draw_object.m_translation != FloatVector2::ms_zero)
+            {
+                glMatrixMode(GL_MODELVIEW);
+                glPushMatrix();
+                glTranslatef(
+                    draw_object.m_translation[Dim::X],
+                    draw_object.m_translation[Dim::Y],
+                    0.0f);
+                // NOTE: the world_to_screen transformation here is wrong
+                // by a translation of m_translation.
+                draw_object.m_object->Draw(draw_data);
+                glMatrixMode(GL_MODELVIEW);
+                glPopMatrix();
+            }
+            else
+            {
+                draw_object.m_object->Draw(draw_data);
+            }
+        }
+    }
+    sprite_batch.Flush();
+    sprite_batch.SetTranslation(FloatVector2::ms_zero);
+}
+
+void VisibilityQuadTree::WrappedViewOffsets (
+    FloatVector2 const &view_center,
+    Float const view_radius,
+    std::vector<FloatVector2> &view_offset_vector) const
+{
+    ASSERT1(m_parent == NULL && "this can only be called on the root node");
+    ASSERT2(m_half_side_length > 0.0f);
+
+    view_offset_vector.clear();
+
+    Float side_length = SideLength();
+    Float radius_sum = BoundingRadius() + view_radius;
+    Float top = floor((view_center[Dim::Y]+radius_sum)/side_length);
+    Float bottom = ceil((view_center[Dim::Y]-radius_sum)/side_length);
+    Float left = ceil((view_center[Dim::X]-radius_sum)/side_length);
+    Float right = floor((view_center[Dim::X]+radius_sum)/side_length);
+    FloatVector2 view_offset;
+
+    for (Float x = left; x <= right; x += 1.0f)
+    {
+        for (Float y = bottom; y <= top; y += 1.0f)
+        {
+            view_offset.SetComponents(side_length*x, side_length*y);
+            // this IF statement culls quadtree nodes that are outside of the
+            // circular view radius from the square grid of nodes to be drawn
+            if ((view_center - view_offset).LengthSquared() < Sqr(radius_sum))
+                view_offset_vector.push_back(view_offset);
+        }
+    }
+}
+
+void VisibilityQuadTree::RebuildStaticDrawCache (
+    RenderContext const &render_context,
+    FloatMatrix2 const &world_to_screen,
+    DrawObjectCollector &draw_object_collector,
+    ObjectLayer const &object_layer,
+    StaticDrawCache &static_draw_cache) const
+{
+    ASSERT1(draw_object_collector.m_render_context == &render_context);
+
+    static_draw_cache.Invalidate();
+
+    // collect everything in the (larger) cached region, at the same view scale.
+    FloatVector2 view_center(draw_object_collector.m_view_center);
+    Float view_radius = draw_object_collector.m_view_radius;
+    Float pixels_in_view_radius = draw_object_collector.m_pixels_in_view_radius;
+    Float region_radius = StaticDrawCache::ms_region_radius_factor * view_radius;
+    draw_object_collector.m_view_radius = region_radius;
+    draw_object_collector.m_pixels_in_view_radius = StaticDrawCache::ms_region_radius_factor * pixels_in_view_radius;
+
+    std::vector<FloatVector2> view_offset_vector;
+    if (object_layer.IsWrapped())
+        WrappedViewOffsets(view_center, region_radius, view_offset_vector);
+    else
+        view_offset_vector.push_back(FloatVector2::ms_zero);
+    draw_object_collector.Clear();
+    CollectWrappedDrawObjects(draw_object_collector, view_offset_vector);
+    draw_object_collector.Sort();
+
+    // record the objects just as DrawCollectedObjects would draw them,
+    // except into the retained sprite batch.
+    SpriteBatch &sprite_batch = static_draw_cache.m_sprite_batch;
+    Object::DrawData draw_data(render_context, world_to_screen);
+    draw_data.m_sprite_batch = &sprite_batch;
+    for (DrawObjectVector::const_iterator it = draw_object_collector.m_draw_object.begin(),
+                                          it_end = draw_object_collector.m_draw_object.end();
+         it != it_end;
+         ++it)
+    {
+        DrawObject const &draw_object = *it;
+        ASSERT3(draw_object.m_object != NULL);
+        // only plain sprites are guaranteed to draw the same way every
+        // frame (an AnimatedSprite's frame changes, for example).
+        if (draw_object.m_object->GetObjectType() != OT_SPRITE)
+        {
+            static_draw_cache.m_is_uncacheable = true;
+            break;
+        }
+        draw_data.m_color_bias = Color(draw_object.m_color_bias_rgba);
+        draw_data.m_color_mask = Color(draw_object.m_color_mask_rgba);
+        sprite_batch.SetTranslation(draw_object.m_translation);
+        draw_object.m_object->Draw(draw_data);
+        ++static_draw_cache.m_object_count;
+    }
+    sprite_batch.Flush();
+    sprite_batch.SetTranslation(FloatVector2::ms_zero);
+
+    draw_object_collector.Clear();
+    draw_object_collector.m_view_center = view_center;
+    draw_object_collector.m_view_radius = view_radius;
+    draw_object_collector.m_pixels_in_view_radius = pixels_in_view_radius;
+
+    if (static_draw_cache.m_is_uncacheable)
+    {
+        // keep m_is_uncacheable, so this isn't attempted every frame
+        static_draw_cache.m_sprite_batch.Clear();
+        static_draw_cache.m_object_count = 0;
+        return;
+    }
+
+    static_draw_cache.m_is_valid = true;
+    static_draw_cache.m_region_center = view_center;
+    static_draw_cache.m_region_radius = region_radius;
+    static_draw_cache.m_pixels_per_unit = pixels_in_view_radius / view_radius;
+    static_draw_cache.m_color_mask_rgba = render_context.ColorMask().Rgba();
+    static_draw_cache.m_color_bias_rgba = render_context.ColorBias().Rgba();
+}
+
 } // end of namespace Engine2
 } // end of namespace Xrb
@@ -14,6 +14,7 @@
 #include "xrb.hpp"
 
 #include <set>
+#include <vector>
 
 #include "xrb_color.hpp"
 #include "xrb_engine2_quadtree.hpp"
@@ -30,6 +31,7 @@ class Serializer;
 namespace Engine2 {
 
 struct DrawObjectCollector;
+struct StaticDrawCache;
 
 // The VisibilityQuadTree class implements a 2D space-organizing structure
 // known as a quad tree.  The idea is to improve visibility/collision by
@@ -41,13 +43,19 @@ class VisibilityQuadTree : public QuadTree
 {
 public:
 
+    // see QuadTree::BoundFactor for bound_factor, and the comment above
+    // QuadTree for split_threshold (a nonzero value makes the tree adaptive,
+    // with depth being the maximum depth).
     VisibilityQuadTree (
         FloatVector2 const &center,
         Float half_side_length,
-        Uint8 depth);
+        Uint8 depth,
+        Float bound_factor = 2.0f,
+        Uint32 split_threshold = 0);
     virtual ~VisibilityQuadTree () { }
 
-    static VisibilityQuadTree *Create (Serializer &serializer);
+    // the bound factor isn't part of the serialized structure
+    static VisibilityQuadTree *Create (Serializer &serializer, Float bound_factor = 2.0f);
 
     virtual void ReadStructure (Serializer &serializer);
     void WriteStructure (Serializer &serializer) const;
@@ -66,6 +74,15 @@ public:
         FloatMatrix2 const &world_to_screen,
         DrawObjectCollector &draw_object_collector,
         ObjectLayer const &object_layer) const;
+    // draws the given cache, first rebuilding it if it isn't valid for the
+    // view in draw_object_collector.  if the objects can't be cached, this
+    // just calls Draw or DrawWrapped.
+    Uint32 DrawStaticDrawCache (
+        RenderContext const &render_context,
+        FloatMatrix2 const &world_to_screen,
+        DrawObjectCollector &draw_object_collector,
+        ObjectLayer const &object_layer,
+        StaticDrawCache &static_draw_cache) const;
 
     // draw lines where the bounds of this quadtree node are
     void DrawBounds (RenderContext const &render_context, Color const &color) const;
@@ -74,12 +91,37 @@ public:
 
 protected:
 
-    // for use in Create
-    VisibilityQuadTree (VisibilityQuadTree *parent) : QuadTree(parent) { }
+    // for use in Create, and (with no parent) by QuadTree::Initialize to
+    // allocate its node pool
+    VisibilityQuadTree (VisibilityQuadTree *parent = NULL) : QuadTree(parent) { }
+
+    friend class QuadTree;
 
 private:
 
     void CollectDrawObjects (DrawObjectCollector &draw_object_collector) const;
+    // collects the objects of each wrapped copy of this (root) node, offset
+    // by the corresponding element of view_offset_vector.
+    void CollectWrappedDrawObjects (
+        DrawObjectCollector &draw_object_collector,
+        std::vector<FloatVector2> const &view_offset_vector) const;
+    // draws the collected (and sorted) objects in order
+    void DrawCollectedObjects (
+        RenderContext const &render_context,
+        FloatMatrix2 const &world_to_screen,
+        DrawObjectCollector &draw_object_collector) const;
+    // computes the offsets of the wrapped copies of this (root) node which
+    // are within view_radius of view_center.
+    void WrappedViewOffsets (
+        FloatVector2 const &view_center,
+        Float view_radius,
+        std::vector<FloatVector2> &view_offset_vector) const;
+    void RebuildStaticDrawCache (
+        RenderContext const &render_context,
+        FloatMatrix2 const &world_to_screen,
+        DrawObjectCollector &draw_object_collector,
+        ObjectLayer const &object_layer,
+        StaticDrawCache &static_draw_cache) const;
 }; // end of class Engine2::VisibilityQuadTree
 
 } // end of namespace Engine2
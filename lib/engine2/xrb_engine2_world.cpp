@@ -281,8 +281,9 @@ void World::RemoveDynamicObject (Object *dynamic_object)
     ASSERT1(m_entity_count > 0);
     --m_entity_count;
 
-    // schedule the entity's events to be deleted.
-    OwnerEventQueue()->ScheduleMatchingEventsForDeletion(MatchEntity, entity);
+    // schedule the entity's events (which are all enqueued for this world)
+    // to be deleted.
+    OwnerEventQueue()->ScheduleMatchingEventsForDeletion(*this, MatchEntity, entity);
 
     // remove the entity from the physics handler
     if (m_physics_handler != NULL)
@@ -325,6 +325,7 @@ void WorldView::Draw (RenderContext const &render_context)
     // resets the draw info so that it can be accumulated
     // during this execution of Draw()
     m_draw_info.Reset();
+    SpriteBatch::ResetCounts();
 
     // vars which are used in the while loop which should only be
     // initialized once, before the loop.
@@ -439,6 +440,8 @@ void WorldView::Draw (RenderContext const &render_context)
         }
     }
 
+    m_draw_info.m_sprite_batch_draw_call_count = SpriteBatch::DrawCallCount();
+
     // draw the main object layer's border above everything
     if (m_draw_border_grid_lines)
     {
@@ -52,10 +52,13 @@ public:
     {
         // number of Objects drawn this Draw()
         Uint32 m_drawn_object_count;
+        // number of draw calls used to draw the batched sprites this Draw()
+        Uint32 m_sprite_batch_draw_call_count;
 
         void Reset ()
         {
             m_drawn_object_count = 0;
+            m_sprite_batch_draw_call_count = 0;
         }
     }; // end of struct DrawInfo
 
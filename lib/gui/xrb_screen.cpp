@@ -137,6 +137,8 @@ void Screen::Draw (Time render_time)
 {
     // NOTE: this method encompasses all drawing.
 
+    Singleton::Gl().BeginFrame();
+
 #if !defined(WIN32)
     ASSERT1(Gl::Integer(GL_MODELVIEW_STACK_DEPTH)  == 1 && "mismatched push/pop for GL_MODELVIEW matrix stack");
     ASSERT1(Gl::Integer(GL_PROJECTION_STACK_DEPTH) == 1 && "mismatched push/pop for GL_PROJECTION matrix stack");
@@ -684,6 +684,15 @@ struct Aggregate<Vector<T,dimension> >
     }
 };
 
+// Vector<T,dimension> is just its array of components, so arrays of them
+// can be read/written by Serializer::ReadArray/WriteArray as a single block.
+template <typename T, Uint32 dimension>
+struct ArrayElement<Vector<T,dimension> >
+{
+    typedef T WordType;
+    enum { WORD_COUNT = dimension };
+};
+
 /// Convenience typedef for a 2-dimensional Float vector.
 typedef Vector<Float, 2> FloatVector2;
 
@@ -127,6 +127,13 @@ struct Aggregate<Color>
     }
 };
 
+template <>
+struct ArrayElement<Color>
+{
+    typedef ColorCoord WordType;
+    enum { WORD_COUNT = 4 };
+};
+
 } // end of namespace Xrb
 
 #endif // !defined(_XRB_COLOR_HPP_)
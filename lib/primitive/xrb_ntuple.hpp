@@ -606,6 +606,15 @@ struct Aggregate<NTuple<T,size> >
     }
 };
 
+// NTuple<T,size> is just its array of components, so arrays of them can be
+// read/written by Serializer::ReadArray/WriteArray as a single block.
+template <typename T, Uint32 size>
+struct ArrayElement<NTuple<T,size> >
+{
+    typedef T WordType;
+    enum { WORD_COUNT = size };
+};
+
 // ///////////////////////////////////////////////////////////////////////////
 // convenience typedefs for n-tuples of different types and dimensions,
 // and stream output functions for each typedef.
@@ -12,6 +12,12 @@
 
 #include <string.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "xrb_filesystem.hpp"
 #include "xrb_math.hpp"
 #include "xrb_pal.hpp"
@@ -20,6 +26,104 @@
 namespace Xrb
 {
 
+namespace {
+
+// averages each 2x2 block of source pixels (from rows row0 and row1, each
+// 2*target_width pixels long) down to one pixel of target, per component,
+// rounding down.  this is the plain version, used for whatever the vector
+// versions below don't cover.
+void BoxFilterRows_Scalar (Uint8 const *row0, Uint8 const *row1, Uint8 *target, ScreenCoord target_width)
+{
+    for (ScreenCoord x = 0; x < target_width; ++x)
+    {
+        for (Uint32 color = 0; color < 4; ++color)
+            target[color] = (Uint32(row0[color]) + row0[4+color] + row1[color] + row1[4+color]) / 4;
+        row0 += 8;
+        row1 += 8;
+        target += 4;
+    }
+}
+
+#if defined(__SSE2__)
+// sums the 2x2 blocks of 4 source pixels (16 bytes) from each row into 2
+// pixels' worth of 16-bit components, not yet divided by 4.
+inline __m128i BoxFilterSums_Sse2 (__m128i row0, __m128i row1)
+{
+    __m128i const zero = _mm_setzero_si128();
+    // pixels 0 and 1 of both rows, then pixels 2 and 3 of both rows
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero));
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero));
+    // (0 + 1), (2 + 3)
+    return _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+}
+
+// 4 target pixels per iteration
+ScreenCoord BoxFilterRows_Sse2 (Uint8 const *row0, Uint8 const *row1, Uint8 *target, ScreenCoord target_width)
+{
+    ScreenCoord x = 0;
+    for ( ; x + 4 <= target_width; x += 4)
+    {
+        __m128i sum01 = BoxFilterSums_Sse2(
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(row0)),
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(row1)));
+        __m128i sum23 = BoxFilterSums_Sse2(
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(row0 + 16)),
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(row1 + 16)));
+        // the sums are at most 4*255, so the shifted values fit in a byte
+        __m128i average = _mm_packus_epi16(_mm_srli_epi16(sum01, 2), _mm_srli_epi16(sum23, 2));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target), average);
+        row0 += 32;
+        row1 += 32;
+        target += 16;
+    }
+    return x;
+}
+#endif // defined(__SSE2__)
+
+#if defined(__AVX2__)
+// 8 target pixels per iteration.  same as the SSE2 version, except that the
+// AVX2 unpack/pack instructions work within each 128-bit half, so the
+// result's 64-bit quarters come out as 01 45 23 67, and are permuted back.
+ScreenCoord BoxFilterRows_Avx2 (Uint8 const *row0, Uint8 const *row1, Uint8 *target, ScreenCoord target_width)
+{
+    __m256i const zero = _mm256_setzero_si256();
+    ScreenCoord x = 0;
+    for ( ; x + 8 <= target_width; x += 8)
+    {
+        __m256i sum[2];
+        for (Uint32 i = 0; i < 2; ++i)
+        {
+            __m256i r0 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(row0 + 32*i));
+            __m256i r1 = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(row1 + 32*i));
+            __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(r0, zero), _mm256_unpacklo_epi8(r1, zero));
+            __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(r0, zero), _mm256_unpackhi_epi8(r1, zero));
+            sum[i] = _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+        }
+        __m256i average = _mm256_packus_epi16(_mm256_srli_epi16(sum[0], 2), _mm256_srli_epi16(sum[1], 2));
+        average = _mm256_permute4x64_epi64(average, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), average);
+        row0 += 64;
+        row1 += 64;
+        target += 32;
+    }
+    return x;
+}
+#endif // defined(__AVX2__)
+
+void BoxFilterRows (Uint8 const *row0, Uint8 const *row1, Uint8 *target, ScreenCoord target_width)
+{
+    ScreenCoord x = 0;
+#if defined(__AVX2__)
+    x = BoxFilterRows_Avx2(row0, row1, target, target_width);
+#endif
+#if defined(__SSE2__)
+    x += BoxFilterRows_Sse2(row0 + 8*x, row1 + 8*x, target + 4*x, target_width - x);
+#endif
+    BoxFilterRows_Scalar(row0 + 8*x, row1 + 8*x, target + 4*x, target_width - x);
+}
+
+} // end of anonymous namespace
+
 Texture::~Texture ()
 {
     DeleteArrayAndNullify(m_data);
@@ -71,32 +175,13 @@ Texture *Texture::CreateMipmap () const
     retval->m_data_length = size[Dim::X]*size[Dim::Y]*4;
     retval->m_data = new Uint8[retval->m_data_length];
 
-    // now filter the data using a simple box filter (4 pixels average down to 1)
+    // now filter the data using a simple box filter (4 pixels average down
+    // to 1, rounding down), a pair of source rows at a time.
+    Uint32 row_size = m_size[Dim::X] * 4;
     for (ScreenCoord y = 0; y < size[Dim::Y]; ++y)
     {
-        ScreenCoord this_y = 2*y;
-        for (ScreenCoord x = 0; x < size[Dim::X]; ++x)
-        {
-            ScreenCoord this_x = 2*x;
-            Uint32 v[4] = { 0, 0, 0, 0 };
-            for (ScreenCoord yoff = 0; yoff < 2; ++yoff)
-            {
-                for (ScreenCoord xoff = 0; xoff < 2; ++xoff)
-                {
-                    Uint8 *pixel = Pixel(this_x+xoff, this_y+yoff);
-                    for (Uint32 color = 0; color < 4; ++color)
-                    {
-                        v[color] += pixel[color];
-                    }
-                }
-            }
-            Uint8 *target_pixel = retval->Pixel(x, y);
-            for (Uint32 color = 0; color < 4; ++color)
-            {
-                ASSERT1(v[color] <= 4*255);
-                target_pixel[color] = v[color] / 4;
-            }
-        }
+        Uint8 const *row0 = m_data + 2*y*row_size;
+        BoxFilterRows(row0, row0 + row_size, retval->m_data + y*size[Dim::X]*4, size[Dim::X]);
     }
 
     return retval;
@@ -12,10 +12,11 @@
 
 #include <sstream>
 
-#include "xrb_binaryfileserializer.hpp"
+#include "xrb_bufferedfileserializer.hpp"
 #include "xrb_filesystem.hpp"
 #include "xrb_gl.hpp"
 #include "xrb_gltexture.hpp"
+#include "xrb_memorymappedserializer.hpp"
 #include "xrb_pal.hpp"
 #include "xrb_rendercontext.hpp"
 #include "xrb_texture.hpp"
@@ -88,7 +89,7 @@ AsciiFont *AsciiFont::CreateFromCache (std::string const &font_face_path, Screen
         std::string font_metadata_path(FORMAT(font_face_path << '.' << pixel_height << ".data"));
 
         // check for the appropriate font metadata file
-        BinaryFileSerializer serializer(font_metadata_path, IOD_READ);
+        MemoryMappedSerializer serializer(font_metadata_path);
 
         // now try to read the font metadata
         retval = new AsciiFont(font_face_path, pixel_height);
@@ -170,7 +171,7 @@ bool AsciiFont::CacheToDisk (Texture *font_texture) const
         std::cerr << "AsciiFont::CacheToDisk(); path = \"" << FontFacePath() << "\", pixel_height = " << PixelHeight() << " ... ";
         std::string font_metadata_path(FORMAT(FontFacePath() << '.' << PixelHeight() << ".data"));
 
-        BinaryFileSerializer serializer(font_metadata_path, IOD_WRITE);
+        BufferedFileSerializer serializer(font_metadata_path);
 
         serializer.Write<Uint32>(Hash());
         serializer.Write<bool>(m_has_kerning);
@@ -179,6 +180,7 @@ bool AsciiFont::CacheToDisk (Texture *font_texture) const
         for (Uint32 i = 0; i < ms_rendered_glyph_count; ++i)
             m_glyph_specification[i].Write(serializer);
         serializer.WriteArray<FontCoord>(m_kern_pair_26_6, LENGTHOF(m_kern_pair_26_6));
+        serializer.Flush();
 
         std::cerr << "cached font data" << std::endl;
     } catch (Exception const &e) {
@@ -431,10 +433,10 @@ void AsciiFont::DrawGlyph (
             glyph_vertex_coordinates_Sint16.TopRight()[Dim::X], glyph_vertex_coordinates_Sint16.TopRight()[Dim::Y]
         };
 
-        glVertexPointer(2, GL_SHORT, 0, glyph_vertex_coordinate_array);
-        glTexCoordPointer(2, GL_SHORT, 0, glyph_texture_coordinate_array);
+        Gl::VertexPointer(2, GL_SHORT, 4, glyph_vertex_coordinate_array);
+        Gl::TexCoordPointer(2, GL_SHORT, 4, glyph_texture_coordinate_array);
 
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        Gl::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
 }
 
@@ -11,6 +11,7 @@
 #include "xrb_gl.hpp"
 
 #include <iomanip>
+#include <sstream>
 
 #include "xrb_color.hpp"
 #include "xrb_filesystem.hpp"
@@ -37,10 +38,23 @@ namespace Xrb {
 
 // } // end of anonymous namespace
 
+Gl::VertexArrayMode Gl::ms_requested_vertex_array_mode = Gl::VAM_CLIENT_ARRAYS;
+// big enough for a frame's worth of sprites, so that it's usually
+// only orphaned once per frame (by BeginFrame).
+Uint32 const Gl::ms_stream_buffer_size = 1 << 20;
+
 Gl::Gl ()
     :
     m_gltexture_opaque_white(NULL),
-    m_atlas_bound_to_unit_0(NULL)
+    m_atlas_bound_to_unit_0(NULL),
+    m_has_unbaked_gltextures(false),
+    m_vertex_array_mode(VAM_CLIENT_ARRAYS),
+    m_pending_array_count(0),
+    m_stream_buffer(0),
+    m_stream_buffer_offset(0),
+    m_array_buffer_binding(0),
+    m_streamed_byte_count(0),
+    m_stream_buffer_orphan_count(0)
 {
     ResetBindTextureCallCounts();
 
@@ -102,6 +116,14 @@ Gl::~Gl ()
     // delete the utility textures (if necessary)
     DeleteAndNullify(m_gltexture_opaque_white);
 
+    // delete the streaming vertex buffer (if necessary)
+    if (m_stream_buffer != 0)
+    {
+        BindArrayBuffer(0);
+        glDeleteBuffers(1, &m_stream_buffer);
+        m_stream_buffer = 0;
+    }
+
     // shutdown both texture units
     Gl::ActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -109,7 +131,8 @@ Gl::~Gl ()
     Gl::ActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    // delete all texture atlases
+    // delete all texture atlases (including the baked ones)
+    m_baked_gltexture_map.clear();
     for (AtlasVector::iterator it = m_atlas.begin(), it_end = m_atlas.end();
          it != it_end;
          ++it)
@@ -227,6 +250,29 @@ void Gl::FinishInitialization ()
         // stay as this value for the entire execution.
         Gl::ClientActiveTexture(GL_TEXTURE0);
     }
+
+    // set up the streaming vertex buffer, if requested.  NOTE: this must
+    // happen after the texture unit 1 texture coordinate array setup above,
+    // which must keep pointing at client memory.
+    if (ms_requested_vertex_array_mode == VAM_STREAMING_BUFFER && AreVertexBufferObjectsSupported())
+    {
+        m_vertex_array_mode = VAM_STREAMING_BUFFER;
+        glGenBuffers(1, &m_stream_buffer);
+        ASSERT1(m_stream_buffer != 0);
+        BindArrayBuffer(m_stream_buffer);
+        OrphanStreamBuffer();
+        m_stream_buffer_orphan_count = 0;
+        BindArrayBuffer(0);
+    }
+    std::cerr << "\tVertex array mode: "
+              << (m_vertex_array_mode == VAM_STREAMING_BUFFER ? "streaming vertex buffer object" : "client arrays")
+              << std::endl;
+}
+
+void Gl::RequestVertexArrayMode (VertexArrayMode vertex_array_mode)
+{
+    ASSERT1(vertex_array_mode < VAM_COUNT);
+    ms_requested_vertex_array_mode = vertex_array_mode;
 }
 
 bool Gl::Boolean (GLenum name)
@@ -270,6 +316,17 @@ GLenum Gl::ClientActiveTexture () { return Integer(GL_CLIENT_ACTIVE_TEXTURE); }
 void Gl::ClientActiveTexture (GLenum texture) { glClientActiveTexture(texture); }
 #endif
 
+void Gl::BeginFrame ()
+{
+    if (m_vertex_array_mode == VAM_STREAMING_BUFFER)
+    {
+        BindArrayBuffer(m_stream_buffer);
+        OrphanStreamBuffer();
+    }
+    m_streamed_byte_count = 0;
+    m_stream_buffer_orphan_count = 0;
+}
+
 void Gl::UnregisterGlTexture (GlTexture &gltexture)
 {
     // deallocate the space in the appropriate atlas
@@ -278,7 +335,10 @@ void Gl::UnregisterGlTexture (GlTexture &gltexture)
     // we don't want some dumb little dinky atlas clogging shit up.
     // or
     // if the atlas is empty, delete it.
-    if (gltexture.UsesSeparateAtlas() || gltexture.Atlas().GlTextureCount() == 0)
+    // unless
+    // the atlas is baked, in which case it is kept so the texture can be
+    // recreated without uploading anything.
+    if (!gltexture.Atlas().IsBaked() && (gltexture.UsesSeparateAtlas() || gltexture.Atlas().GlTextureCount() == 0))
     {
         AtlasVector::iterator it = m_atlas.begin();
         AtlasVector::iterator it_end = m_atlas.end();
@@ -453,6 +513,66 @@ Uint32 Gl::UsedTextureByteCount () const
     return retval;
 }
 
+bool Gl::LoadGlTextureAtlasCache (std::string const &cache_path)
+{
+    GlTextureAtlasCache *cache = GlTextureAtlasCache::Open(cache_path);
+    if (cache == NULL)
+        return false;
+
+    // the shared atlases must be the size this Pal would make them, or the
+    // baked placement wouldn't match what CreateGlTexture would do.
+    ScreenCoordVector2 gltexture_atlas_size(Singleton::Pal().GlTextureAtlasSize());
+    for (Uint32 a = 0; a < cache->AtlasCount(); ++a)
+    {
+        GlTextureAtlasCache::Atlas const &baked_atlas = cache->GetAtlas(a);
+        if ((baked_atlas.m_flags & GlTexture::USES_SEPARATE_ATLAS) == 0 && baked_atlas.m_size != gltexture_atlas_size)
+        {
+            std::cerr << "Gl::LoadGlTextureAtlasCache(); path = \"" << cache_path << "\" ... baked with a different GlTextureAtlasSize -- ignoring it" << std::endl;
+            Delete(cache);
+            return false;
+        }
+    }
+
+    // upload the atlases straight from the cache file
+    std::vector<GlTextureAtlas *> atlas(cache->AtlasCount(), static_cast<GlTextureAtlas *>(NULL));
+    for (Uint32 a = 0; a < cache->AtlasCount(); ++a)
+    {
+        GlTextureAtlasCache::Atlas const &baked_atlas = cache->GetAtlas(a);
+        atlas[a] = new GlTextureAtlas(baked_atlas.m_size, baked_atlas.m_flags);
+        for (Uint32 level = 0; level < baked_atlas.m_mipmap_level_count; ++level)
+            atlas[a]->UploadBakedMipmapLevel(level, cache->MipmapLevelPixelData(a, level));
+        AddAtlas(atlas[a]);
+    }
+
+    for (Uint32 i = 0; i < cache->EntryCount(); ++i)
+    {
+        GlTextureAtlasCache::Entry const &entry = cache->GetEntry(i);
+        // if an earlier cache already had it, that one is used.
+        if (m_baked_gltexture_map.find(entry.m_source) != m_baked_gltexture_map.end())
+            continue;
+
+        BakedGlTexture baked_gltexture;
+        baked_gltexture.m_atlas = atlas[entry.m_atlas_index];
+        baked_gltexture.m_size = entry.m_size;
+        baked_gltexture.m_center = entry.m_center;
+        baked_gltexture.m_atlas->ReserveBakedTexture(entry.m_size, entry.m_center);
+        m_baked_gltexture_map[entry.m_source] = baked_gltexture;
+        // so that baking again includes it
+        m_loaded_gltexture_source_set.insert(entry.m_source);
+    }
+
+    std::cerr << "Gl::LoadGlTextureAtlasCache(); path = \"" << cache_path << "\" ... loaded "
+              << cache->EntryCount() << " textures in " << cache->AtlasCount() << " atlases" << std::endl;
+    // the pixel data has been uploaded, so the file can be unmapped.
+    Delete(cache);
+    return true;
+}
+
+bool Gl::BakeGlTextureAtlasCache (std::string const &cache_path) const
+{
+    return GlTextureAtlasCache::Bake(m_loaded_gltexture_source_set, Singleton::Pal().GlTextureAtlasSize(), cache_path);
+}
+
 void Gl::DumpAtlases (std::string const &path_prefix) const
 {
 #if XRB_PLATFORM == XRB_PLATFORM_IPHONE
@@ -549,6 +669,150 @@ void Gl::ClientActiveTexture_ (GLenum texture)
     }
 }
 
+void Gl::ArrayPointer_ (GLenum array, GLint size, GLenum type, Uint32 vertex_count, GLvoid const *pointer)
+{
+    ASSERT1(pointer != NULL);
+
+    if (m_vertex_array_mode != VAM_STREAMING_BUFFER)
+    {
+        SetArrayPointer(array, size, type, pointer);
+        return;
+    }
+
+    // replace the pending array of the same kind, if there is one.
+    Uint32 i = 0;
+    while (i < m_pending_array_count && m_pending_array[i].m_array != array)
+        ++i;
+    ASSERT1(i < LENGTHOF(m_pending_array));
+    if (i == m_pending_array_count)
+        ++m_pending_array_count;
+
+    PendingArray &pending_array = m_pending_array[i];
+    pending_array.m_array = array;
+    pending_array.m_size = size;
+    pending_array.m_type = type;
+    pending_array.m_byte_count = vertex_count * size * ComponentTypeSize(type);
+    pending_array.m_pointer = pointer;
+}
+
+void Gl::DrawArrays_ (GLenum mode, GLint first, GLsizei count)
+{
+    if (m_pending_array_count > 0)
+        StreamPendingArrays();
+    glDrawArrays(mode, first, count);
+}
+
+void Gl::StreamPendingArrays ()
+{
+    ASSERT1(m_vertex_array_mode == VAM_STREAMING_BUFFER);
+    ASSERT1(m_stream_buffer != 0);
+
+    // each array is kept 16-byte aligned
+    Uint32 total_byte_count = 0;
+    for (Uint32 i = 0; i < m_pending_array_count; ++i)
+        total_byte_count += (m_pending_array[i].m_byte_count + 15) & ~15;
+
+    if (total_byte_count > ms_stream_buffer_size)
+    {
+        // anything too big for the ring buffer is read out of client memory.
+        BindArrayBuffer(0);
+        for (Uint32 i = 0; i < m_pending_array_count; ++i)
+            SetArrayPointer(m_pending_array[i].m_array, m_pending_array[i].m_size, m_pending_array[i].m_type, m_pending_array[i].m_pointer);
+    }
+    else
+    {
+        BindArrayBuffer(m_stream_buffer);
+        Uint32 offset = (m_stream_buffer_offset + 15) & ~15;
+        // if the ring buffer is full, start over with fresh storage, instead
+        // of overwriting data the pending draw calls may still be reading.
+        // all of this draw call's arrays were copied after this point, so
+        // orphaning can't discard any of them.
+        if (offset + total_byte_count > ms_stream_buffer_size)
+        {
+            OrphanStreamBuffer();
+            offset = 0;
+        }
+        for (Uint32 i = 0; i < m_pending_array_count; ++i)
+        {
+            PendingArray const &pending_array = m_pending_array[i];
+            glBufferSubData(GL_ARRAY_BUFFER, offset, pending_array.m_byte_count, pending_array.m_pointer);
+            // with a buffer object bound, gl*Pointer takes an offset into it.
+            SetArrayPointer(pending_array.m_array, pending_array.m_size, pending_array.m_type, reinterpret_cast<GLvoid const *>(static_cast<size_t>(offset)));
+            offset += (pending_array.m_byte_count + 15) & ~15;
+            m_streamed_byte_count += pending_array.m_byte_count;
+        }
+        m_stream_buffer_offset = offset;
+    }
+    m_pending_array_count = 0;
+}
+
+void Gl::SetArrayPointer (GLenum array, GLint size, GLenum type, GLvoid const *pointer)
+{
+    switch (array)
+    {
+        case GL_VERTEX_ARRAY:        glVertexPointer(size, type, 0, pointer);   break;
+        case GL_TEXTURE_COORD_ARRAY: glTexCoordPointer(size, type, 0, pointer); break;
+        case GL_COLOR_ARRAY:         glColorPointer(size, type, 0, pointer);    break;
+        default: ASSERT1(false && "invalid array"); break;
+    }
+}
+
+void Gl::OrphanStreamBuffer ()
+{
+    ASSERT1(m_stream_buffer != 0);
+    ASSERT1(m_array_buffer_binding == m_stream_buffer);
+#if defined(__IPHONEOS__)
+    glBufferData(GL_ARRAY_BUFFER, ms_stream_buffer_size, NULL, GL_DYNAMIC_DRAW);
+#else
+    glBufferData(GL_ARRAY_BUFFER, ms_stream_buffer_size, NULL, GL_STREAM_DRAW);
+#endif
+    m_stream_buffer_offset = 0;
+    ++m_stream_buffer_orphan_count;
+}
+
+void Gl::BindArrayBuffer (GLuint buffer)
+{
+    if (m_array_buffer_binding != buffer)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        m_array_buffer_binding = buffer;
+    }
+}
+
+bool Gl::AreVertexBufferObjectsSupported ()
+{
+#if defined(__IPHONEOS__)
+    // vertex buffer objects are part of openGL ES 1.1
+    return true;
+#else
+    // vertex buffer objects are part of openGL 1.5
+    std::istringstream in(reinterpret_cast<char const *>(glGetString(GL_VERSION)));
+    Uint32 major = 0;
+    Uint32 minor = 0;
+    char dot = '\0';
+    in >> major >> dot >> minor;
+    return major > 1 || (major == 1 && dot == '.' && minor >= 5);
+#endif
+}
+
+Uint32 Gl::ComponentTypeSize (GLenum type)
+{
+    switch (type)
+    {
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:  return 1;
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT: return 2;
+        case GL_FLOAT:          return 4;
+#if !defined(__IPHONEOS__)
+        case GL_INT:
+        case GL_UNSIGNED_INT:   return 4;
+        case GL_DOUBLE:         return 8;
+#endif
+        default: ASSERT1(false && "invalid type"); return 0;
+    }
+}
+
 bool &Gl::EnableMapValue (GLenum cap)
 {
     // hacky way to multiplex the enabled-value of GL_TEXTURE_2D and other
@@ -656,6 +920,25 @@ GlTexture *Gl::CreateGlTexture (Texture const &texture, Uint32 gltexture_flags)
     }
 }
 
+GlTexture *Gl::CreateBakedGlTexture (std::string const &path, Uint32 gltexture_flags)
+{
+    BakedGlTextureMap::iterator it = m_baked_gltexture_map.find(GlTextureAtlasCache::Source(path, gltexture_flags));
+    if (it == m_baked_gltexture_map.end())
+        return NULL;
+
+    BakedGlTexture const &baked_gltexture = it->second;
+    ASSERT1(baked_gltexture.m_atlas != NULL);
+    return baked_gltexture.m_atlas->CreateBakedGlTexture(baked_gltexture.m_size, baked_gltexture.m_center);
+}
+
+void Gl::RecordLoadedGlTexture (std::string const &path, Uint32 gltexture_flags)
+{
+    m_loaded_gltexture_source_set.insert(GlTextureAtlasCache::Source(path, gltexture_flags));
+    // GlTextureAtlasCache::Bake can't bake these, so they don't count.
+    if (path.find("internal://") != 0)
+        m_has_unbaked_gltextures = true;
+}
+
 void Gl::AddAtlas (GlTextureAtlas *atlas)
 {
     ASSERT1(atlas != NULL);
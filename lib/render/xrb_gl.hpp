@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "xrb_color.hpp"
+#include "xrb_gltextureatlascache.hpp"
 #include "xrb_resourcelibrary.hpp"
 #include "xrb_screencoord.hpp"
 #include "xrb_singleton.hpp"
@@ -46,6 +47,16 @@ class Gl
 {
 public:
 
+    /// @brief Selects how the vertex, texture coordinate and color arrays are handed to openGL.
+    /// @details See RequestVertexArrayMode.
+    enum VertexArrayMode
+    {
+        VAM_CLIENT_ARRAYS = 0, ///< The arrays are read directly out of client memory by each draw call.
+        VAM_STREAMING_BUFFER,  ///< The arrays are copied into a vertex buffer object used as a per-frame ring buffer.
+
+        VAM_COUNT
+    }; // end of enum Gl::VertexArrayMode
+
     Gl ();
     ~Gl ();
 
@@ -69,6 +80,14 @@ public:
       */
     static GLint Integer (GLenum name);
 
+    /** VAM_STREAMING_BUFFER is only used if the openGL implementation supports
+      * vertex buffer objects (openGL 1.5); otherwise VAM_CLIENT_ARRAYS is used.
+      * The default is VAM_CLIENT_ARRAYS.
+      * @brief Selects the vertex array mode which the next FinishInitialization will use.
+      * @note Must be called before Singleton::InitializeGl (i.e. before Screen::Create).
+      */
+    static void RequestVertexArrayMode (VertexArrayMode vertex_array_mode);
+
     // ///////////////////////////////////////////////////////////////////////
     // non-static "actually public" methods
     // ///////////////////////////////////////////////////////////////////////
@@ -146,6 +165,31 @@ public:
 
 #endif
 
+    /** These should be used instead of glVertexPointer, glTexCoordPointer and
+      * glColorPointer (with a stride of 0), because they must know how many
+      * vertices' worth of data to copy in VAM_STREAMING_BUFFER mode.  In that
+      * mode, the data is copied by the next DrawArrays (so that all the arrays
+      * of a draw call are known when room is made for them in the streaming
+      * vertex buffer), so it must stay valid until then.
+      * @brief Frontend for glVertexPointer which goes through the streaming vertex buffer when it's in use.
+      */
+    static void VertexPointer (GLint size, GLenum type, Uint32 vertex_count, GLvoid const *pointer)
+    {
+        Singleton::Gl().ArrayPointer_(GL_VERTEX_ARRAY, size, type, vertex_count, pointer);
+    }
+    /// Frontend for glTexCoordPointer which goes through the streaming vertex buffer when it's in use.
+    static void TexCoordPointer (GLint size, GLenum type, Uint32 vertex_count, GLvoid const *pointer)
+    {
+        Singleton::Gl().ArrayPointer_(GL_TEXTURE_COORD_ARRAY, size, type, vertex_count, pointer);
+    }
+    /// Frontend for glColorPointer which goes through the streaming vertex buffer when it's in use.
+    static void ColorPointer (GLint size, GLenum type, Uint32 vertex_count, GLvoid const *pointer)
+    {
+        Singleton::Gl().ArrayPointer_(GL_COLOR_ARRAY, size, type, vertex_count, pointer);
+    }
+    /// Frontend for glDrawArrays, which must be used when the arrays were specified using the frontends above.
+    static void DrawArrays (GLenum mode, GLint first, GLsizei count) { Singleton::Gl().DrawArrays_(mode, first, count); }
+
     // ///////////////////////////////////////////////////////////////////////
     // non-static "public but not for general use" methods
     // ///////////////////////////////////////////////////////////////////////
@@ -205,6 +249,21 @@ public:
     Uint32 BindTextureCallCount () const { return m_bind_texture_call_hit_count + m_bind_texture_call_miss_count; }
     void ResetBindTextureCallCounts ();
 
+    /// The vertex array mode chosen by FinishInitialization.
+    VertexArrayMode GetVertexArrayMode () const { return m_vertex_array_mode; }
+    /** In VAM_STREAMING_BUFFER mode, this orphans the streaming vertex buffer
+      * (so that the driver can hand out fresh storage instead of waiting
+      * for the previous frame's draw calls to finish with it) and resets the
+      * streaming counts.  Called by Screen::Draw.
+      * @brief Indicates the start of a frame.
+      */
+    void BeginFrame ();
+    // these are useful for profiling the vertex uploads -- the number of
+    // bytes copied into the streaming vertex buffer, and the number of times
+    // its storage was orphaned because it filled up, since the last BeginFrame.
+    Uint32 StreamedByteCount () const { return m_streamed_byte_count; }
+    Uint32 StreamBufferOrphanCount () const { return m_stream_buffer_orphan_count; }
+
     // these are useful for checking how efficiently packed the texture atlases are.
     Uint32 AllocatedTextureByteCount () const;
     Uint32 UsedTextureByteCount () const;
@@ -213,6 +272,31 @@ public:
     // seeing how well your atlases are packed.
     void DumpAtlases (std::string const &path_prefix) const;
 
+    /** The baked atlases are uploaded immediately, and from then on, GlTextures
+      * created (via the ResourceLibrary) from the baked paths and flags use them
+      * instead of loading, mipmapping and uploading the images.  The baked atlases
+      * are kept even when they have no GlTextures.  Nothing happens if the file
+      * doesn't exist, isn't valid, was baked with a different
+      * Pal::GlTextureAtlasSize, or any of its images has changed since it was
+      * baked.  See GlTextureAtlasCache.
+      * @brief Loads a cache file of baked texture atlases, returning true upon success.
+      */
+    bool LoadGlTextureAtlasCache (std::string const &cache_path);
+    /** This is the case when no cache was loaded (or it was stale), or when a
+      * texture was loaded that the cache doesn't have, i.e. when baking again
+      * would produce a cache with more in it.
+      * @brief Returns true iff a texture has been loaded from a path without using a baked atlas.
+      */
+    bool HasUnbakedGlTextures () const { return m_has_unbaked_gltextures; }
+    /** Bakes every texture that has been loaded from a path so far (with the
+      * flags it was loaded with), using the current Pal::GlTextureAtlasSize.
+      * Call this after loading the game's textures (e.g. on the way out, if
+      * HasUnbakedGlTextures) to produce the file to give to
+      * LoadGlTextureAtlasCache the next time.
+      * @brief Bakes a cache file of texture atlases, returning true upon success.
+      */
+    bool BakeGlTextureAtlasCache (std::string const &cache_path) const;
+
 private:
 
     /// Backend for the static IsEnabled method.
@@ -234,6 +318,24 @@ private:
     /// Backend for the static ClientActiveTexture method.
     void ClientActiveTexture_ (GLenum texture);
 
+    /// Backend for the static VertexPointer, TexCoordPointer and ColorPointer methods.
+    void ArrayPointer_ (GLenum array, GLint size, GLenum type, Uint32 vertex_count, GLvoid const *pointer);
+    /// Backend for the static DrawArrays method.
+    void DrawArrays_ (GLenum mode, GLint first, GLsizei count);
+
+    /// Copies the pending arrays into the streaming vertex buffer and points openGL at them.
+    void StreamPendingArrays ();
+    /// Calls glVertexPointer, glTexCoordPointer or glColorPointer, depending on array.
+    static void SetArrayPointer (GLenum array, GLint size, GLenum type, GLvoid const *pointer);
+    /// Replaces the storage of the (bound) streaming vertex buffer with fresh, undefined storage.
+    void OrphanStreamBuffer ();
+    /// Frontend for glBindBuffer(GL_ARRAY_BUFFER, ...) (used to avoid unnecessary changes of GL state)
+    void BindArrayBuffer (GLuint buffer);
+    /// Returns true iff the openGL implementation supports vertex buffer objects.
+    static bool AreVertexBufferObjectsSupported ();
+    /// Returns the size in bytes of the given gl*Pointer component type.
+    static Uint32 ComponentTypeSize (GLenum type);
+
     /// Ensures m_enable_map[cap] exists and contains the correct value.
     bool &EnableMapValue (GLenum cap);
     /// Allows access to the enabled state of GL_TEXTURE_2D for each texture unit
@@ -242,11 +344,24 @@ private:
     static bool IsClientTextureUnitCapability (GLenum cap);
     /// Creates a texture-atlased GlTexture instance.  For use only by GlTexture.
     GlTexture *CreateGlTexture (Texture const &texture, Uint32 gltexture_flags);
+    /// Creates a GlTexture in a baked atlas (see LoadGlTextureAtlasCache), or returns NULL if the path and flags weren't baked.  For use only by GlTexture.
+    GlTexture *CreateBakedGlTexture (std::string const &path, Uint32 gltexture_flags);
+    /// Records a path and flags that a GlTexture was loaded from, for BakeGlTextureAtlasCache.  For use only by GlTexture.
+    void RecordLoadedGlTexture (std::string const &path, Uint32 gltexture_flags);
 
     void AddAtlas (GlTextureAtlas *atlas);
 
+    // where a baked texture is (see LoadGlTextureAtlasCache)
+    struct BakedGlTexture
+    {
+        GlTextureAtlas *m_atlas;
+        ScreenCoordVector2 m_size;
+        ScreenCoordVector2 m_center;
+    }; // end of struct Gl::BakedGlTexture
+
     typedef std::map<GLenum, bool> EnableMap;
     typedef std::vector<GlTextureAtlas *> AtlasVector;
+    typedef std::map<GlTextureAtlasCache::Source, BakedGlTexture> BakedGlTextureMap;
 
     EnableMap m_enable_map;
     GLenum m_active_texture;
@@ -258,6 +373,37 @@ private:
     GlTextureAtlas const *m_atlas_bound_to_unit_0;
     Uint32 m_bind_texture_call_hit_count;
     Uint32 m_bind_texture_call_miss_count;
+    BakedGlTextureMap m_baked_gltexture_map;
+    GlTextureAtlasCache::SourceSet m_loaded_gltexture_source_set;
+    bool m_has_unbaked_gltextures;
+
+    // an array specified using one of the gl*Pointer frontends in
+    // VAM_STREAMING_BUFFER mode, which hasn't been copied yet.
+    struct PendingArray
+    {
+        GLenum m_array;
+        GLint m_size;
+        GLenum m_type;
+        Uint32 m_byte_count;
+        GLvoid const *m_pointer;
+    }; // end of struct Gl::PendingArray
+
+    VertexArrayMode m_vertex_array_mode;
+    // there's at most one pending array of each kind (vertex, texture coordinate, color)
+    PendingArray m_pending_array[3];
+    Uint32 m_pending_array_count;
+    // the streaming vertex buffer object (0 if not in VAM_STREAMING_BUFFER mode)
+    GLuint m_stream_buffer;
+    // the byte offset in m_stream_buffer at which the next data will be copied
+    Uint32 m_stream_buffer_offset;
+    // the buffer object currently bound to GL_ARRAY_BUFFER
+    GLuint m_array_buffer_binding;
+    Uint32 m_streamed_byte_count;
+    Uint32 m_stream_buffer_orphan_count;
+
+    static VertexArrayMode ms_requested_vertex_array_mode;
+    // the size in bytes of the streaming vertex buffer
+    static Uint32 const ms_stream_buffer_size;
 
     friend class GlTexture;
 };
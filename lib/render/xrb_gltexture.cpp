@@ -146,6 +146,11 @@ GlTexture *GlTexture::Create (ResourceLoadParameters const &p)
         return gltexture_hex_code_colored;
     }
 
+    // if it was baked into a texture atlas cache, it's already uploaded.
+    GlTexture *baked = Singleton::Gl().CreateBakedGlTexture(load_parameters.Path(), load_parameters.Flags());
+    if (baked != NULL)
+        return baked;
+
     // otherwise try to load the given path
     Texture *texture = Texture::Create(load_parameters.Path());
     if (texture == NULL)
@@ -155,6 +160,9 @@ GlTexture *GlTexture::Create (ResourceLoadParameters const &p)
     // retval could be NULL at this point (e.g. if the texture was non-square,
     // non-power-of-2-sized and did not use USES_SEPARATE_ATLAS).
     delete texture;
+    // remember it, in case a texture atlas cache is baked later.
+    if (retval != NULL)
+        Singleton::Gl().RecordLoadedGlTexture(load_parameters.Path(), load_parameters.Flags());
     return retval;
 }
 
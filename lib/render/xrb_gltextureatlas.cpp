@@ -10,7 +10,16 @@
 
 #include "xrb_gltextureatlas.hpp"
 
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "xrb_gltexture.hpp"
+#include "xrb_gltextureatlasallocator.hpp"
 #include "xrb_math.hpp"
 #include "xrb_resourcelibrary.hpp"
 #include "xrb_texture.hpp"
@@ -82,17 +91,88 @@ my guess is that loading the larger textures first will give the best
 spatial efficiency, as the smaller textures will filter down into the
 large holes.
 
+the placement itself (CenterBegin, CenterEnd, MinimumSpaceBetween and the
+search for the first free center) is done by GlTextureAtlasAllocator, which
+doesn't touch openGL.
+
 */
 
 namespace Xrb
 {
 
+class GlTextureAtlas::GlPixelDestination : public GlTextureAtlas::PixelDestination
+{
+public:
+
+    GlPixelDestination (GlTextureAtlas const &atlas) : m_atlas(atlas) { }
+
+    virtual void Write (Uint32 mipmap_level, ScreenCoordVector2 const &location, Texture const &pixels)
+    {
+        Singleton::Gl().BindAtlas(m_atlas);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,      // target (must be GL_TEXTURE_2D)
+            mipmap_level,       // mipmap level
+            location[Dim::X],   // x offset
+            location[Dim::Y],   // y offset
+            pixels.Width(),     // width
+            pixels.Height(),    // height
+            GL_RGBA,            // format of the input pixel data
+            GL_UNSIGNED_BYTE,   // data type of the input pixel data
+            pixels.Data());     // pixel data
+    }
+
+private:
+
+    GlTextureAtlas const &m_atlas;
+}; // end of class GlTextureAtlas::GlPixelDestination
+
+namespace {
+
+// copies count pixels, each source_stride pixels apart (i.e. a column of a
+// texture), into contiguous pixels at target.
+void CopyPixelColumn (Uint8 const *source, ScreenCoord source_stride, Uint8 *target, ScreenCoord count)
+{
+    ScreenCoord y = 0;
+#if defined(__AVX2__)
+    // gather 8 pixels at a time
+    __m256i const offset = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(source_stride));
+    for ( ; y + 8 <= count; y += 8)
+    {
+        __m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<int const *>(source), offset, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), pixels);
+        source += 8*4*source_stride;
+        target += 8*4;
+    }
+#elif defined(__SSE2__)
+    // 4 pixels at a time (there's no gather, but it's one store instead of 4)
+    for ( ; y + 4 <= count; y += 4)
+    {
+        int pixel[4];
+        for (Uint32 i = 0; i < 4; ++i)
+            memcpy(&pixel[i], source + i*4*source_stride, 4);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_setr_epi32(pixel[0], pixel[1], pixel[2], pixel[3]));
+        source += 4*4*source_stride;
+        target += 4*4;
+    }
+#endif
+    for ( ; y < count; ++y)
+    {
+        memcpy(target, source, 4);
+        source += 4*source_stride;
+        target += 4;
+    }
+}
+
+} // end of anonymous namespace
+
 GlTextureAtlas::GlTextureAtlas (ScreenCoordVector2 const &size, Uint32 gltexture_flags)
     :
     m_size(size),
     m_flags(gltexture_flags),
+    m_allocator(NULL),
     m_allocated_texture_byte_count(0),
-    m_used_texture_byte_count(0)
+    m_used_texture_byte_count(0),
+    m_is_baked(false)
 {
     if (UsesSeparateAtlas())
     {
@@ -103,6 +183,7 @@ GlTextureAtlas::GlTextureAtlas (ScreenCoordVector2 const &size, Uint32 gltexture
         // require that "real" atlases be power-of-2-sized.
         ASSERT1(Math::IsAPowerOf2(m_size[Dim::X]));
         ASSERT1(Math::IsAPowerOf2(m_size[Dim::Y]));
+        m_allocator = new GlTextureAtlasAllocator(m_size);
     }
 
     glGenTextures(1, &m_handle);
@@ -189,6 +270,8 @@ GlTextureAtlas::~GlTextureAtlas ()
 
     Singleton::Gl().EnsureAtlasIsNotBound(*this);
 
+    Delete(m_allocator);
+
     ASSERT1(m_handle > 0);
     glDeleteTextures(1, &m_handle);
 }
@@ -242,27 +325,15 @@ GlTexture *GlTextureAtlas::AttemptToPlaceTexture (Texture const &texture, Uint32
         return retval;
     }
 
-    ScreenCoordVector2 center_begin(CenterBegin(texture.Size()));
-    ScreenCoordVector2 center_end(CenterEnd(texture.Size()));
-    ScreenCoordVector2 center_stride(2*texture.Size());
+    ASSERT1(m_allocator != NULL);
     ScreenCoordVector2 center;
-    for (center[Dim::Y] = center_begin[Dim::Y];
-         center[Dim::Y] <= center_end[Dim::Y];
-         center[Dim::Y] += center_stride[Dim::Y])
+    if (m_allocator->Allocate(texture.Width(), center))
     {
-        for (center[Dim::X] = center_begin[Dim::X];
-             center[Dim::X] <= center_end[Dim::X];
-             center[Dim::X] += center_stride[Dim::X])
-        {
-            if (ThereIsEnoughSpaceFor(texture, center))
-            {
-                GlTexture *retval = ActuallyPlaceTexture(texture, center);
-                ASSERT1(retval != NULL);
-                m_placed_gltexture_set.insert(retval);
-                m_used_texture_byte_count += CountTextureBytes(texture.Size());
-                return retval;
-            }
-        }
+        GlTexture *retval = ActuallyPlaceTexture(texture, center);
+        ASSERT1(retval != NULL);
+        m_placed_gltexture_set.insert(retval);
+        m_used_texture_byte_count += CountTextureBytes(texture.Size());
+        return retval;
     }
 
     // SORRY, there wasn't space
@@ -274,6 +345,9 @@ void GlTextureAtlas::UnplaceTexture (GlTexture const &gltexture)
     ASSERT1(&gltexture.Atlas() == this);
     ASSERT1(m_placed_gltexture_set.find(&gltexture) != m_placed_gltexture_set.end());
     m_placed_gltexture_set.erase(&gltexture);
+    // free the space (1x1 textures have 0x0 texture coordinate boxes)
+    if (m_allocator != NULL)
+        m_allocator->Free(Max(gltexture.Width(), 1), gltexture.TextureCoordinateCenter());
     // update the used texture byte count
     ASSERT1(m_used_texture_byte_count >= CountTextureBytes(gltexture.Size()));
     m_used_texture_byte_count -= CountTextureBytes(gltexture.Size());
@@ -281,6 +355,59 @@ void GlTextureAtlas::UnplaceTexture (GlTexture const &gltexture)
     // TODO: it would be nice to blank it all out
 }
 
+void GlTextureAtlas::UploadBakedMipmapLevel (Uint32 mipmap_level, Uint8 const *pixel_data)
+{
+    ASSERT1(pixel_data != NULL);
+    ASSERT1(mipmap_level == 0 || (!UsesSeparateAtlas() && !MipmapsDisabled()));
+
+    ScreenCoordVector2 level_size(UsesSeparateAtlas() ? m_size : MipmapLevelSize(m_size, mipmap_level));
+    Singleton::Gl().BindAtlas(*this);
+    // this comes straight from the (memory-mapped) cache file.  separate
+    // atlases have their mipmaps generated by openGL, as usual.
+    glTexSubImage2D(
+        GL_TEXTURE_2D,          // target (must be GL_TEXTURE_2D)
+        mipmap_level,           // mipmap level
+        0,                      // x offset
+        0,                      // y offset
+        level_size[Dim::X],     // width
+        level_size[Dim::Y],     // height
+        GL_RGBA,                // format of the input pixel data
+        GL_UNSIGNED_BYTE,       // data type of the input pixel data
+        pixel_data);            // pixel data
+    m_is_baked = true;
+}
+
+void GlTextureAtlas::ReserveBakedTexture (ScreenCoordVector2 const &texture_size, ScreenCoordVector2 const &center)
+{
+    ASSERT1(m_is_baked);
+    // separate atlases only ever hold their one texture anyway
+    if (m_allocator != NULL)
+    {
+        ASSERT1(texture_size[Dim::X] == texture_size[Dim::Y]);
+        m_allocator->Reserve(texture_size[Dim::X], center);
+    }
+}
+
+GlTexture *GlTextureAtlas::CreateBakedGlTexture (ScreenCoordVector2 const &texture_size, ScreenCoordVector2 const &center)
+{
+    ASSERT1(m_is_baked);
+
+    GlTexture *retval;
+    if (UsesSeparateAtlas())
+    {
+        ASSERT1(m_placed_gltexture_set.empty());
+        ASSERT1(texture_size == m_size);
+        retval = new GlTexture(*this, texture_size, ScreenCoordRect(texture_size), m_flags);
+    }
+    else
+        retval = CreatePlacedGlTexture(texture_size, center);
+
+    ASSERT1(m_placed_gltexture_set.find(retval) == m_placed_gltexture_set.end());
+    m_placed_gltexture_set.insert(retval);
+    m_used_texture_byte_count += CountTextureBytes(texture_size);
+    return retval;
+}
+
 #if XRB_PLATFORM != XRB_PLATFORM_IPHONE
 Texture *GlTextureAtlas::Dump (Uint32 mipmap_level) const
 {
@@ -315,133 +442,56 @@ void GlTextureAtlas::AssertThatTextureJives (Texture const &texture) const
     }
 }
 
-ScreenCoordVector2 GlTextureAtlas::CenterBegin (ScreenCoordVector2 const &texture_size) const
-{
-    ASSERT1(Math::IsAPowerOf2(texture_size[Dim::X]));
-    ASSERT1(Math::IsAPowerOf2(texture_size[Dim::Y]));
-    ASSERT1(texture_size[Dim::X] == texture_size[Dim::Y]);
-
-    // if the texture size is 0, then always start at 0.  it is a special case
-    // if the texture is exactly as wide/tall as the atlas -- then it will not
-    // be centered at size*(2*k+1), but rather size/2.  otherwise, the center
-    // starts at size.
-
-    ScreenCoordVector2 retval;
-    for (Uint32 i = 0; i < 2; ++i)
-    {
-        if (texture_size[i] == 1)
-            retval[i] = 0;
-        else if (texture_size[i] == m_size[i])
-            retval[i] = texture_size[i] / 2;
-        else
-            retval[i] = texture_size[i];
-    }
-    return retval;
-}
-
-ScreenCoordVector2 GlTextureAtlas::CenterEnd (ScreenCoordVector2 const &texture_size) const
-{
-    ASSERT1(Math::IsAPowerOf2(texture_size[Dim::X]));
-    ASSERT1(Math::IsAPowerOf2(texture_size[Dim::Y]));
-    ASSERT1(texture_size[Dim::X] == texture_size[Dim::Y]);
-
-    // if the texture size is 0, then always end at atlas_size.  it is a special
-    // case if the texture is exactly as wide/tall as the atlas -- then it ends at
-    // size/2, since there's only one texture width/height in the size.  otherwise,
-    // the center ends where it ends (see below)
-
-    ScreenCoordVector2 retval;
-    for (Uint32 i = 0; i < 2; ++i)
-    {
-        if (texture_size[i] == 1)
-            retval[i] = m_size[i];
-        else if (texture_size[i] == m_size[i])
-            retval[i] = texture_size[i] / 2;
-        else
-            retval[i] = texture_size[i] + 2*texture_size[i] * (m_size[i] / (2*texture_size[i]) - 1);
-    }
-    return retval;
-}
-
-ScreenCoordVector2 GlTextureAtlas::MinimumSpaceBetween (GlTexture const &gltexture, Texture const &texture) const
+GlTexture *GlTextureAtlas::ActuallyPlaceTexture (Texture const &texture, ScreenCoordVector2 const &center)
 {
-    ASSERT1(Math::IsAPowerOf2(texture.Width()));
-    ASSERT1(Math::IsAPowerOf2(texture.Height()));
-    ASSERT1(texture.Width() == texture.Height());
-
-    ScreenCoordVector2 retval;
-    for (Uint32 i = 0; i < 2; ++i)
-    {
-        ScreenCoord big = Max(gltexture.Size()[i], 1); // because a 1x1 is actually 0x0
-        ScreenCoord small = texture.Size()[i];
-        if (big < small)
-        {
-            ScreenCoord temp = big;
-            big = small;
-            small = temp;
-        }
+    AssertThatTextureJives(texture);
 
-        if (big == small)
-            retval[i] = 2*big;
-        else
-            retval[i] = big/2 + small*2;
-    }
+    GlTexture *retval = CreatePlacedGlTexture(texture.Size(), center);
+    // there's no point in writing mipmap levels that weren't allocated
+    GlPixelDestination destination(*this);
+    WriteMipmapsAndBorders(m_size, texture, center, MipmapsDisabled() ? 1 : MipmapLevelCount(m_size), destination);
     return retval;
 }
 
-bool GlTextureAtlas::ThereIsEnoughSpaceFor (Texture const &texture, ScreenCoordVector2 const &center) const
-{
-    ASSERT1(Math::IsAPowerOf2(texture.Width()));
-    ASSERT1(Math::IsAPowerOf2(texture.Height()));
-    ASSERT1(texture.Width() == texture.Height());
-
-    for (PlacedGlTextureSet::const_iterator it = m_placed_gltexture_set.begin(),
-                                            it_end = m_placed_gltexture_set.end();
-         it != it_end;
-         ++it)
-    {
-        ASSERT1(*it != NULL);
-        GlTexture const &gltexture = **it;
-        ScreenCoordVector2 minimum_space_between(MinimumSpaceBetween(gltexture, texture));
-        if (Abs(gltexture.TextureCoordinateCenter()[Dim::X] - center[Dim::X]) < minimum_space_between[Dim::X] &&
-            Abs(gltexture.TextureCoordinateCenter()[Dim::Y] - center[Dim::Y]) < minimum_space_between[Dim::Y])
-        {
-            return false; // it was too close to some existing gltexture
-        }
-    }
-    // it was far enough away from all existing gltextures
-    return true;
-}
-
-GlTexture *GlTextureAtlas::ActuallyPlaceTexture (Texture const &texture, ScreenCoordVector2 center)
+GlTexture *GlTextureAtlas::CreatePlacedGlTexture (ScreenCoordVector2 const &texture_size, ScreenCoordVector2 const &center)
 {
-    AssertThatTextureJives(texture);
-
     // 1xN (Nx1) textures will have "0-width" ("0-height") texture coord boxes,
     // since their texels are essentially split in half in the coordinates, so
     // basically round down to the nearest multiple of 2.  this is a way to
     // avoid having to scale the texture matrix by 2 which effectively would
     // give texture coordinate addressing resolution of 1/2 unit.
-    ASSERT1(texture.Width() == 1 || Math::IsEven(texture.Width()));
-    ASSERT1(texture.Height() == 1 || Math::IsEven(texture.Height()));
+    ASSERT1(texture_size[Dim::X] == 1 || Math::IsEven(texture_size[Dim::X]));
+    ASSERT1(texture_size[Dim::Y] == 1 || Math::IsEven(texture_size[Dim::Y]));
     ScreenCoordVector2 adjusted_texture_size(
-        texture.Width() > 1 ? texture.Width() : 0,
-        texture.Height() > 1 ? texture.Height() : 0);
+        texture_size[Dim::X] > 1 ? texture_size[Dim::X] : 0,
+        texture_size[Dim::Y] > 1 ? texture_size[Dim::Y] : 0);
     ScreenCoordRect texture_coordinate_rect(
         center-adjusted_texture_size/2,
         center+adjusted_texture_size/2);
-    GlTexture *retval = new GlTexture(*this, adjusted_texture_size, texture_coordinate_rect, m_flags);
+    return new GlTexture(*this, adjusted_texture_size, texture_coordinate_rect, m_flags);
+}
+
+void GlTextureAtlas::WriteMipmapsAndBorders (
+    ScreenCoordVector2 const &atlas_size,
+    Texture const &texture,
+    ScreenCoordVector2 center,
+    Uint32 mipmap_level_count,
+    PixelDestination &destination)
+{
+    ASSERT1(mipmap_level_count > 0);
 
     // mipmap level 0
-    PlaceMipmapAndBorder(0, texture, center);
+    WriteMipmapAndBorder(atlas_size, 0, texture, center, destination);
 
     // higher mipmap levels
     Uint32 mipmap_level = 1;
+    if (mipmap_level >= mipmap_level_count)
+        return;
     Texture *mipmap = texture.CreateMipmap();
     center /= 2;
-    while (mipmap->Width() > 0 && mipmap->Height() > 0)
+    while (mipmap->Width() > 0 && mipmap->Height() > 0 && mipmap_level < mipmap_level_count)
     {
-        PlaceMipmapAndBorder(mipmap_level, *mipmap, center);
+        WriteMipmapAndBorder(atlas_size, mipmap_level, *mipmap, center, destination);
 
         ++mipmap_level;
         Texture *next_mipmap = mipmap->CreateMipmap();
@@ -450,14 +500,31 @@ GlTexture *GlTextureAtlas::ActuallyPlaceTexture (Texture const &texture, ScreenC
         center /= 2;
     }
     delete mipmap;
+}
 
-    return retval;
+Uint32 GlTextureAtlas::MipmapLevelCount (ScreenCoordVector2 const &atlas_size)
+{
+    ASSERT1(Math::IsAPowerOf2(atlas_size[Dim::X]));
+    ASSERT1(Math::IsAPowerOf2(atlas_size[Dim::Y]));
+    // the levels go all the way down to 1x1 (see the constructor)
+    return 1 + Math::HighestBitIndex(Max(atlas_size[Dim::X], atlas_size[Dim::Y]));
 }
 
-void GlTextureAtlas::PlaceMipmapAndBorder (Uint32 mipmap_level, Texture const &mipmap, ScreenCoordVector2 const &mipmap_center)
+ScreenCoordVector2 GlTextureAtlas::MipmapLevelSize (ScreenCoordVector2 const &atlas_size, Uint32 mipmap_level)
 {
-    Singleton::Gl().BindAtlas(*this);
+    ASSERT1(mipmap_level < MipmapLevelCount(atlas_size));
+    return ScreenCoordVector2(
+        Max(atlas_size[Dim::X] >> mipmap_level, 1),
+        Max(atlas_size[Dim::Y] >> mipmap_level, 1));
+}
 
+void GlTextureAtlas::WriteMipmapAndBorder (
+    ScreenCoordVector2 const &atlas_size,
+    Uint32 mipmap_level,
+    Texture const &mipmap,
+    ScreenCoordVector2 const &mipmap_center,
+    PixelDestination &destination)
+{
     // place the pixel data (the body of the mipmap)
     if (mipmap.Width() == 1 || mipmap.Height() == 1)
     {
@@ -469,21 +536,12 @@ void GlTextureAtlas::PlaceMipmapAndBorder (Uint32 mipmap_level, Texture const &m
         ASSERT1(Math::IsEven(mipmap.Height()));
         ASSERT1(mipmap_center[Dim::X] - mipmap.Width()/2 >= 0);
         ASSERT1(mipmap_center[Dim::Y] - mipmap.Height()/2 >= 0);
-        glTexSubImage2D(
-            GL_TEXTURE_2D,                              // target (must be GL_TEXTURE_2D)
-            mipmap_level,                               // mipmap level
-            mipmap_center[Dim::X] - mipmap.Width()/2,   // x offset
-            mipmap_center[Dim::Y] - mipmap.Height()/2,  // y offset
-            mipmap.Width(),                             // width
-            mipmap.Height(),                            // height
-            GL_RGBA,                                    // format of the input pixel data
-            GL_UNSIGNED_BYTE,                           // data type of the input pixel data
-            mipmap.Data());                             // pixel data
+        destination.Write(mipmap_level, mipmap_center - mipmap.Size()/2, mipmap);
     }
 
     // place the border data
     {
-        ScreenCoordVector2 atlas_mipmap_size(m_size[Dim::X] >> mipmap_level, m_size[Dim::Y] >> mipmap_level);
+        ScreenCoordVector2 atlas_mipmap_size(atlas_size[Dim::X] >> mipmap_level, atlas_size[Dim::Y] >> mipmap_level);
         ASSERT1(atlas_mipmap_size[Dim::X] > 0 && atlas_mipmap_size[Dim::Y] > 0);
 
         // determine which borders lie within the atlas mipmap
@@ -511,16 +569,7 @@ void GlTextureAtlas::PlaceMipmapAndBorder (Uint32 mipmap_level, Texture const &m
                 ASSERT1(border_location[Dim::X]+border->Width() <= atlas_mipmap_size[Dim::X]);
                 ASSERT1(border_location[Dim::Y] >= 0);
                 ASSERT1(border_location[Dim::Y]+border->Height() <= atlas_mipmap_size[Dim::Y]);
-                glTexSubImage2D(
-                    GL_TEXTURE_2D,              // target (must be GL_TEXTURE_2D)
-                    mipmap_level,               // mipmap level
-                    border_location[Dim::X],    // x offset
-                    border_location[Dim::Y],    // y offset
-                    border->Width(),            // width
-                    border->Height(),           // height
-                    GL_RGBA,                    // format of the input pixel data
-                    GL_UNSIGNED_BYTE,           // data type of the input pixel data
-                    border->Data());            // pixel data
+                destination.Write(mipmap_level, border_location, *border);
                 delete border;
             }
         }
@@ -532,7 +581,7 @@ ScreenCoordVector2 GlTextureAtlas::CalculateBorderLocation (
     Uint32 border_mask,
     ScreenCoordVector2 const &atlas_mipmap_size,
     ScreenCoordVector2 const &mipmap_size,
-    ScreenCoordVector2 const &mipmap_center) const
+    ScreenCoordVector2 const &mipmap_center)
 {
     ASSERT1(which_border & border_mask);
     ASSERT1(which_border == LEFT || which_border == RIGHT || which_border == TOP || which_border == BOTTOM);
@@ -603,8 +652,7 @@ Texture *GlTextureAtlas::CreateBorderTexture (Texture const &texture, Uint32 whi
         // be a single memcpy because the pixel data isn't contiguous.  only do
         // this if the texture height is not 1 (because this is a special case)
         if (texture.Height() != 1)
-            for (ScreenCoord y = 0; y < texture.Height(); ++y)
-                memcpy(retval->Pixel(0, y + (border_mask & BOTTOM ? 1 : 0)), texture.Pixel(x, y), 4);
+            CopyPixelColumn(texture.Pixel(x, 0), texture.Width(), retval->Pixel(0, border_mask & BOTTOM ? 1 : 0), texture.Height());
     }
     else
     {
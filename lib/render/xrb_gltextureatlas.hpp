@@ -22,6 +22,7 @@ namespace Xrb
 {
 
 class GlTexture;
+class GlTextureAtlasAllocator;
 class Texture;
 
 // you (the game developer) shouldn't need to use this class
@@ -30,6 +31,17 @@ class GlTextureAtlas
 {
 public:
 
+    /// Receives the pixel data that placing a texture writes into an atlas (see WriteMipmapsAndBorders).
+    class PixelDestination
+    {
+    public:
+
+        virtual ~PixelDestination () { }
+
+        /// Writes the given pixels into the given mipmap level with their bottom left corner at location.
+        virtual void Write (Uint32 mipmap_level, ScreenCoordVector2 const &location, Texture const &pixels) = 0;
+    }; // end of class GlTextureAtlas::PixelDestination
+
     GlTextureAtlas (ScreenCoordVector2 const &size, Uint32 gltexture_flags);
     ~GlTextureAtlas ();
 
@@ -42,6 +54,9 @@ public:
     Uint32 GlTextureCount () const { return m_placed_gltexture_set.size(); }
     Uint32 AllocatedTextureByteCount () const { return m_allocated_texture_byte_count; }
     Uint32 UsedTextureByteCount () const { return m_used_texture_byte_count; }
+    /// Baked atlases (see GlTextureAtlasCache) stay around when they have no GlTextures,
+    /// since their GlTextures can be recreated without uploading anything.
+    bool IsBaked () const { return m_is_baked; }
 
     // attempts to find space for the given texture.  if space is found, the
     // texture is placed, and an appropriate GlTexture is returned.  otherwise
@@ -50,6 +65,30 @@ public:
     // deallocates space in the allocation bitmap (freeing the space)
     void UnplaceTexture (GlTexture const &gltexture);
 
+    /// Uploads a whole mipmap level of baked pixel data (in the format written by
+    /// GlTextureAtlasCache::Bake) and marks this atlas as baked.
+    void UploadBakedMipmapLevel (Uint32 mipmap_level, Uint8 const *pixel_data);
+    /// Permanently reserves the space of a texture whose pixel data is in the uploaded
+    /// baked mipmap levels, so that CreateBakedGlTexture can be used for it at any time.
+    void ReserveBakedTexture (ScreenCoordVector2 const &texture_size, ScreenCoordVector2 const &center);
+    /// Returns a GlTexture for a texture whose pixel data is already in this atlas.
+    GlTexture *CreateBakedGlTexture (ScreenCoordVector2 const &texture_size, ScreenCoordVector2 const &center);
+
+    /// The number of mipmap levels a (non-separate) atlas of the given size has.
+    static Uint32 MipmapLevelCount (ScreenCoordVector2 const &atlas_size);
+    /// The size of the given mipmap level of a (non-separate) atlas of the given size.
+    static ScreenCoordVector2 MipmapLevelSize (ScreenCoordVector2 const &atlas_size, Uint32 mipmap_level);
+    /// @brief Writes the pixel data of a square, power-of-2-sized texture centered at center in
+    /// a (non-separate) atlas of the given size, along with its border pixels.
+    /// @details Mipmap levels 0 through mipmap_level_count-1 are written.  AttemptToPlaceTexture
+    /// uses this to upload textures, and GlTextureAtlasCache uses it to bake atlases offline.
+    static void WriteMipmapsAndBorders (
+        ScreenCoordVector2 const &atlas_size,
+        Texture const &texture,
+        ScreenCoordVector2 center,
+        Uint32 mipmap_level_count,
+        PixelDestination &destination);
+
 #if XRB_PLATFORM != XRB_PLATFORM_IPHONE
     /** This method is only supported on non-iphone platforms -- openGL ES does
       * not support the operations necessary to easily retrieve texture data
@@ -65,20 +104,26 @@ public:
 private:
 
     void AssertThatTextureJives (Texture const &texture) const;
-    ScreenCoordVector2 CenterBegin (ScreenCoordVector2 const &texture_size) const;
-    ScreenCoordVector2 CenterEnd (ScreenCoordVector2 const &texture_size) const;
-    ScreenCoordVector2 MinimumSpaceBetween (GlTexture const &gltexture, Texture const &texture) const;
-    bool ThereIsEnoughSpaceFor (Texture const &texture, ScreenCoordVector2 const &center) const;
-    GlTexture *ActuallyPlaceTexture (Texture const &texture, ScreenCoordVector2 center);
-    void PlaceMipmapAndBorder (Uint32 mipmap_level, Texture const &mipmap, ScreenCoordVector2 const &mipmap_center);
-    ScreenCoordVector2 CalculateBorderLocation (
+    GlTexture *ActuallyPlaceTexture (Texture const &texture, ScreenCoordVector2 const &center);
+    GlTexture *CreatePlacedGlTexture (ScreenCoordVector2 const &texture_size, ScreenCoordVector2 const &center);
+
+    // writes into the atlas itself, via glTexSubImage2D
+    class GlPixelDestination;
+
+    enum { LEFT = (1 << 0), RIGHT = (1 << 1), BOTTOM = (1 << 2), TOP = (1 << 3) };
+
+    static void WriteMipmapAndBorder (
+        ScreenCoordVector2 const &atlas_size,
+        Uint32 mipmap_level,
+        Texture const &mipmap,
+        ScreenCoordVector2 const &mipmap_center,
+        PixelDestination &destination);
+    static ScreenCoordVector2 CalculateBorderLocation (
         Uint32 which_border,
         Uint32 border_mask,
         ScreenCoordVector2 const &atlas_mipmap_size,
         ScreenCoordVector2 const &mipmap_size,
-        ScreenCoordVector2 const &mipmap_center) const;
-
-    enum { LEFT = (1 << 0), RIGHT = (1 << 1), BOTTOM = (1 << 2), TOP = (1 << 3) };
+        ScreenCoordVector2 const &mipmap_center);
 
     static Texture *CreateBorderTexture (Texture const &texture, Uint32 which_border, Uint32 border_mask);
     static Uint32 CountTextureBytes (ScreenCoordVector2 level_0_mipmap_size);
@@ -94,6 +139,8 @@ private:
     Uint32 const m_flags;
     GLuint m_handle;
     PlacedGlTextureSet m_placed_gltexture_set;
+    // decides where the textures go (NULL if UsesSeparateAtlas()).
+    GlTextureAtlasAllocator *m_allocator;
     // the number of bytes of texture memory used by this atlas, including
     // all mipmap levels.  might be inaccurate for non-power-of-2-sized
     // textures, size i don't really know how opengl implements those mipmaps.
@@ -101,6 +148,8 @@ private:
     // the number of actually used bytes on all mipmap levels (this
     // doesn't include border or spacing pixels).
     Uint32 m_used_texture_byte_count;
+    // see IsBaked
+    bool m_is_baked;
 }; // end of class GlTextureAtlas
 
 } // end of namespace Xrb
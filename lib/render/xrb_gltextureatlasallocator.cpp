@@ -0,0 +1,191 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_gltextureatlasallocator.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "xrb_gltextureatlasallocator.hpp"
+
+#include "xrb_math.hpp"
+
+namespace Xrb
+{
+
+GlTextureAtlasAllocator::GlTextureAtlasAllocator (ScreenCoordVector2 const &atlas_size)
+    :
+    m_atlas_size(atlas_size),
+    m_candidate_test_count(0)
+{
+    ASSERT1(m_atlas_size[Dim::X] > 0 && Math::IsAPowerOf2(m_atlas_size[Dim::X]));
+    ASSERT1(m_atlas_size[Dim::Y] > 0 && Math::IsAPowerOf2(m_atlas_size[Dim::Y]));
+    ResetFirstCandidates();
+}
+
+bool GlTextureAtlasAllocator::Allocate (ScreenCoord texture_size, ScreenCoordVector2 &center)
+{
+    ASSERT1(texture_size > 0 && Math::IsAPowerOf2(texture_size));
+
+    if (texture_size > m_atlas_size[Dim::X] || texture_size > m_atlas_size[Dim::Y])
+        return false;
+
+    Uint32 level = Math::HighestBitIndex(texture_size);
+    ASSERT1(level < SIZE_LEVEL_COUNT);
+    ScreenCoordVector2 center_begin(CenterBegin(texture_size));
+    ScreenCoordVector2 center_end(CenterEnd(texture_size));
+    ScreenCoord center_stride = 2*texture_size;
+
+    // every center before this one (in row-major order) was already found to
+    // be occupied, and nothing has been freed since.
+    ScreenCoordVector2 candidate(m_first_candidate[level]);
+    while (candidate[Dim::Y] <= center_end[Dim::Y])
+    {
+        while (candidate[Dim::X] <= center_end[Dim::X])
+        {
+            ++m_candidate_test_count;
+            Allocation const *blocking_allocation = FindBlockingAllocation(texture_size, candidate);
+            if (blocking_allocation == NULL)
+            {
+                m_allocation_vector.push_back(Allocation(candidate, texture_size, false));
+                // the next search for this size starts here (and immediately
+                // skips past the texture that was just placed).
+                m_first_candidate[level] = candidate;
+                center = candidate;
+                return true;
+            }
+
+            // all the candidates in this row which are too close to the
+            // blocking texture can be skipped -- the next one to test is the
+            // first one at least the minimum space to its right.
+            ScreenCoord clear_x =
+                blocking_allocation->m_center[Dim::X] +
+                MinimumSpaceBetween(blocking_allocation->m_size, texture_size);
+            ASSERT1(clear_x > candidate[Dim::X]);
+            candidate[Dim::X] += center_stride * ((clear_x - candidate[Dim::X] + center_stride - 1) / center_stride);
+        }
+        candidate[Dim::X] = center_begin[Dim::X];
+        candidate[Dim::Y] += center_stride;
+    }
+
+    // SORRY, there wasn't space (and there won't be until something is freed)
+    m_first_candidate[level] = candidate;
+    return false;
+}
+
+void GlTextureAtlasAllocator::Free (ScreenCoord texture_size, ScreenCoordVector2 const &center)
+{
+    for (AllocationVector::iterator it = m_allocation_vector.begin(), it_end = m_allocation_vector.end(); it != it_end; ++it)
+    {
+        if (it->m_size == texture_size && it->m_center == center)
+        {
+            if (it->m_is_reserved)
+                return;
+            *it = m_allocation_vector.back();
+            m_allocation_vector.pop_back();
+            // previously occupied centers may be free now
+            ResetFirstCandidates();
+            return;
+        }
+    }
+    ASSERT1(false && "no such allocation");
+}
+
+void GlTextureAtlasAllocator::Reserve (ScreenCoord texture_size, ScreenCoordVector2 const &center)
+{
+    ASSERT1(texture_size > 0 && Math::IsAPowerOf2(texture_size));
+    ASSERT1(texture_size <= m_atlas_size[Dim::X] && texture_size <= m_atlas_size[Dim::Y]);
+    ASSERT1(FindBlockingAllocation(texture_size, center) == NULL && "the space is already allocated");
+    m_allocation_vector.push_back(Allocation(center, texture_size, true));
+    // the first candidates for each size are still correct, since this only
+    // makes more space occupied (though they may now be occupied themselves).
+}
+
+ScreenCoordVector2 GlTextureAtlasAllocator::CenterBegin (ScreenCoord texture_size) const
+{
+    ASSERT1(Math::IsAPowerOf2(texture_size));
+
+    // if the texture size is 1, then always start at 0.  it is a special case
+    // if the texture is exactly as wide/tall as the atlas -- then it will not
+    // be centered at size*(2*k+1), but rather size/2.  otherwise, the center
+    // starts at size.
+
+    ScreenCoordVector2 retval;
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        if (texture_size == 1)
+            retval[i] = 0;
+        else if (texture_size == m_atlas_size[i])
+            retval[i] = texture_size / 2;
+        else
+            retval[i] = texture_size;
+    }
+    return retval;
+}
+
+ScreenCoordVector2 GlTextureAtlasAllocator::CenterEnd (ScreenCoord texture_size) const
+{
+    ASSERT1(Math::IsAPowerOf2(texture_size));
+
+    // if the texture size is 1, then always end at atlas_size.  it is a special
+    // case if the texture is exactly as wide/tall as the atlas -- then it ends at
+    // size/2, since there's only one texture width/height in the size.  otherwise,
+    // the center ends where it ends (see below)
+
+    ScreenCoordVector2 retval;
+    for (Uint32 i = 0; i < 2; ++i)
+    {
+        if (texture_size == 1)
+            retval[i] = m_atlas_size[i];
+        else if (texture_size == m_atlas_size[i])
+            retval[i] = texture_size / 2;
+        else
+            retval[i] = texture_size + 2*texture_size * (m_atlas_size[i] / (2*texture_size) - 1);
+    }
+    return retval;
+}
+
+ScreenCoord GlTextureAtlasAllocator::MinimumSpaceBetween (ScreenCoord texture_size_0, ScreenCoord texture_size_1)
+{
+    ASSERT1(Math::IsAPowerOf2(texture_size_0));
+    ASSERT1(Math::IsAPowerOf2(texture_size_1));
+
+    ScreenCoord big = Max(texture_size_0, texture_size_1);
+    ScreenCoord small = Min(texture_size_0, texture_size_1);
+    if (big == small)
+        return 2*big;
+    else
+        return big/2 + small*2;
+}
+
+GlTextureAtlasAllocator::Allocation const *GlTextureAtlasAllocator::FindBlockingAllocation (
+    ScreenCoord texture_size,
+    ScreenCoordVector2 const &center) const
+{
+    for (AllocationVector::const_iterator it = m_allocation_vector.begin(), it_end = m_allocation_vector.end(); it != it_end; ++it)
+    {
+        ScreenCoord minimum_space_between = MinimumSpaceBetween(it->m_size, texture_size);
+        if (Abs(it->m_center[Dim::X] - center[Dim::X]) < minimum_space_between &&
+            Abs(it->m_center[Dim::Y] - center[Dim::Y]) < minimum_space_between)
+        {
+            return &*it; // it was too close to this one
+        }
+    }
+    // it was far enough away from all of them
+    return NULL;
+}
+
+void GlTextureAtlasAllocator::ResetFirstCandidates ()
+{
+    for (Uint32 level = 0; level < SIZE_LEVEL_COUNT; ++level)
+    {
+        ScreenCoord texture_size = ScreenCoord(1) << level;
+        if (texture_size > m_atlas_size[Dim::X] || texture_size > m_atlas_size[Dim::Y])
+            break;
+        m_first_candidate[level] = CenterBegin(texture_size);
+    }
+}
+
+} // end of namespace Xrb
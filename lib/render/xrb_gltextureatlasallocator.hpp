@@ -0,0 +1,98 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_gltextureatlasallocator.hpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#if !defined(_XRB_GLTEXTUREATLASALLOCATOR_HPP_)
+#define _XRB_GLTEXTUREATLASALLOCATOR_HPP_
+
+#include "xrb.hpp"
+
+#include <vector>
+
+#include "xrb_screencoord.hpp"
+
+namespace Xrb
+{
+
+/// @brief Decides where the square, power-of-2-sized textures of a (non-separate) GlTextureAtlas go.
+/// @details Uses the placement rules described in xrb_gltextureatlas.cpp -- a texture of size
+/// s is centered at s*(2*k+1) (so that its mipmaps stay aligned on every level) and must be at
+/// least MinimumSpaceBetween away from every other texture (so that the border pixels and the
+/// lower mipmap levels don't overlap).  Allocate returns the first free center in row-major order,
+/// exactly as the original exhaustive scan did, but a candidate center which is too close to some
+/// texture skips all the following candidates in that row which are too close to the same texture,
+/// and the search for each texture size resumes where the previous one for that size left off
+/// (everything before it is still occupied until something is freed).
+///
+/// This class doesn't touch openGL, so it can be used (e.g. benchmarked) without a Screen.
+class GlTextureAtlasAllocator
+{
+public:
+
+    GlTextureAtlasAllocator (ScreenCoordVector2 const &atlas_size);
+
+    ScreenCoordVector2 const &AtlasSize () const { return m_atlas_size; }
+    Uint32 AllocationCount () const { return m_allocation_vector.size(); }
+    /// The number of candidate centers tested by all calls to Allocate so far (for benchmarking).
+    Uint32 CandidateTestCount () const { return m_candidate_test_count; }
+
+    /// Attempts to find space for a texture_size x texture_size texture.  If there is space,
+    /// it is allocated, its center is stored in center, and true is returned.
+    bool Allocate (ScreenCoord texture_size, ScreenCoordVector2 &center);
+    /// Frees the space allocated for the texture of the given size at the given center.
+    /// Reserved space (see Reserve) stays allocated.
+    void Free (ScreenCoord texture_size, ScreenCoordVector2 const &center);
+    /// Permanently allocates the space for a texture which was placed ahead of time
+    /// (see GlTextureAtlasCache).  The space must be free.
+    void Reserve (ScreenCoord texture_size, ScreenCoordVector2 const &center);
+
+    ScreenCoordVector2 CenterBegin (ScreenCoord texture_size) const;
+    ScreenCoordVector2 CenterEnd (ScreenCoord texture_size) const;
+    static ScreenCoord MinimumSpaceBetween (ScreenCoord texture_size_0, ScreenCoord texture_size_1);
+
+private:
+
+    struct Allocation
+    {
+        ScreenCoordVector2 m_center;
+        ScreenCoord m_size;
+        bool m_is_reserved;
+
+        Allocation (ScreenCoordVector2 const &center, ScreenCoord size, bool is_reserved)
+            :
+            m_center(center),
+            m_size(size),
+            m_is_reserved(is_reserved)
+        { }
+    }; // end of struct GlTextureAtlasAllocator::Allocation
+
+    typedef std::vector<Allocation> AllocationVector;
+
+    enum { SIZE_LEVEL_COUNT = 32 };
+
+    // returns the allocation which is too close to a texture_size texture
+    // centered at center, or NULL if there is enough space there.
+    Allocation const *FindBlockingAllocation (ScreenCoord texture_size, ScreenCoordVector2 const &center) const;
+    void ResetFirstCandidates ();
+
+    ScreenCoordVector2 const m_atlas_size;
+    // in no particular order (the largest textures are placed first in
+    // practice, so they tend to be found as blockers first anyway).
+    AllocationVector m_allocation_vector;
+    // element n is the first center (in row-major order) a texture of size
+    // 2^n could possibly go.  a Y coordinate past CenterEnd means the atlas
+    // is full for that size.  reset by Free.
+    ScreenCoordVector2 m_first_candidate[SIZE_LEVEL_COUNT];
+    Uint32 m_candidate_test_count;
+}; // end of class GlTextureAtlasAllocator
+
+} // end of namespace Xrb
+
+#endif // !defined(_XRB_GLTEXTUREATLASALLOCATOR_HPP_)
+
@@ -0,0 +1,392 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_gltextureatlascache.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "xrb_gltextureatlascache.hpp"
+
+#include <algorithm>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "xrb_bufferedfileserializer.hpp"
+#include "xrb_filesystem.hpp"
+#include "xrb_gltexture.hpp"
+#include "xrb_gltextureatlas.hpp"
+#include "xrb_gltextureatlasallocator.hpp"
+#include "xrb_math.hpp"
+#include "xrb_memorymappedserializer.hpp"
+#include "xrb_pal.hpp"
+#include "xrb_singleton.hpp"
+#include "xrb_texture.hpp"
+
+namespace Xrb
+{
+
+Uint32 const GlTextureAtlasCache::ms_magic_number = 0x41425258; // "XRBA" in little endian
+Uint32 const GlTextureAtlasCache::ms_version = 2;
+
+namespace {
+
+// sanity limits, so that a corrupt file can't cause giant allocations
+Uint32 const gs_max_atlas_count = 0x1000;
+Uint32 const gs_max_entry_count = 0x10000;
+
+// the pixel data starts on a multiple of this many bytes
+Uint32 const gs_pixel_data_alignment = 16;
+
+// a texture loaded for baking
+struct LoadedTexture
+{
+    GlTextureAtlasCache::Source const *m_source;
+    Texture *m_texture;
+    Uint32 m_file_size;
+    Uint32 m_file_modification_time;
+
+    LoadedTexture (GlTextureAtlasCache::Source const &source, Texture *texture, Uint32 file_size, Uint32 file_modification_time)
+        :
+        m_source(&source),
+        m_texture(texture),
+        m_file_size(file_size),
+        m_file_modification_time(file_modification_time)
+    { }
+}; // end of struct LoadedTexture
+
+// the shared textures are placed largest-first (see xrb_gltextureatlas.cpp)
+bool IsLarger (LoadedTexture const &left, LoadedTexture const &right)
+{
+    return left.m_texture->Width() > right.m_texture->Width();
+}
+
+// writes into the mipmap levels of an atlas being baked
+class MipmapLevelDestination : public GlTextureAtlas::PixelDestination
+{
+public:
+
+    MipmapLevelDestination (std::vector<Texture *> const &mipmap_level) : m_mipmap_level(mipmap_level) { }
+
+    virtual void Write (Uint32 mipmap_level, ScreenCoordVector2 const &location, Texture const &pixels)
+    {
+        ASSERT1(mipmap_level < m_mipmap_level.size());
+        if (pixels.Width() == 0 || pixels.Height() == 0)
+            return;
+
+        Texture &destination = *m_mipmap_level[mipmap_level];
+        ASSERT1(location[Dim::X] >= 0 && location[Dim::X] + pixels.Width() <= destination.Width());
+        ASSERT1(location[Dim::Y] >= 0 && location[Dim::Y] + pixels.Height() <= destination.Height());
+        for (ScreenCoord y = 0; y < pixels.Height(); ++y)
+            memcpy(destination.Pixel(location[Dim::X], location[Dim::Y] + y), pixels.Pixel(0, y), 4*pixels.Width());
+    }
+
+private:
+
+    std::vector<Texture *> const &m_mipmap_level;
+}; // end of class MipmapLevelDestination
+
+Uint32 MipmapLevelByteCount (ScreenCoordVector2 const &mipmap_level_size)
+{
+    return 4 * mipmap_level_size[Dim::X] * mipmap_level_size[Dim::Y];
+}
+
+// gets the size and modification time of the given image file (as an OS
+// path, or a FS path beginning with "fs://"), returning false if it can't
+// be found.  these are what the cache is checked against, instead of the
+// contents, so that checking doesn't mean reading every image.
+bool GetFileStamp (std::string const &path, Uint32 &file_size, Uint32 &file_modification_time)
+{
+    std::string os_path;
+    try {
+        os_path = Singleton::FileSystem().OsPath(path, FileSystem::READ_ONLY);
+    } catch (FileSystemException const &e) {
+        return false;
+    }
+
+    struct stat file_status;
+    if (stat(os_path.c_str(), &file_status) != 0)
+        return false;
+
+    file_size = Uint32(file_status.st_size);
+    file_modification_time = Uint32(file_status.st_mtime);
+    return true;
+}
+
+} // end of anonymous namespace
+
+bool GlTextureAtlasCache::Bake (SourceSet const &source_set, ScreenCoordVector2 const &atlas_size, std::string const &cache_path)
+{
+    bool uses_shared_atlases = atlas_size[Dim::X] > 0 && atlas_size[Dim::Y] > 0;
+    ASSERT1(!uses_shared_atlases || (Math::IsAPowerOf2(atlas_size[Dim::X]) && Math::IsAPowerOf2(atlas_size[Dim::Y])));
+
+    std::cerr << "GlTextureAtlasCache::Bake(); path = \"" << cache_path << "\" ... ";
+
+    // load all the images first, so that the shared ones can be placed largest-first.
+    std::vector<LoadedTexture> loaded_texture_vector;
+    for (SourceSet::const_iterator it = source_set.begin(), it_end = source_set.end(); it != it_end; ++it)
+    {
+        if (it->m_path.find("internal://") == 0)
+            continue;
+
+        // this is done before loading, so that if the file changes in
+        // between, the cache is stale instead of silently wrong.
+        Uint32 file_size;
+        Uint32 file_modification_time;
+        if (!GetFileStamp(it->m_path, file_size, file_modification_time))
+            continue;
+
+        Texture *texture = Singleton::Pal().LoadImage(it->m_path.c_str());
+        if (texture == NULL)
+            continue;
+
+        // this is the same check that Gl::CreateGlTexture does
+        if ((it->m_flags & GlTexture::USES_SEPARATE_ATLAS) == 0 &&
+            (!Math::IsAPowerOf2(texture->Width()) || texture->Width() != texture->Height()))
+        {
+            Delete(texture);
+            continue;
+        }
+
+        loaded_texture_vector.push_back(LoadedTexture(*it, texture, file_size, file_modification_time));
+    }
+    std::stable_sort(loaded_texture_vector.begin(), loaded_texture_vector.end(), IsLarger);
+
+    // place the textures the same way Gl::CreateGlTexture would, and render
+    // the shared atlases' mipmap levels.
+    AtlasVector atlas_vector;
+    EntryVector entry_vector;
+    std::vector<std::vector<Texture *> > mipmap_level_vector;
+    std::vector<GlTextureAtlasAllocator *> allocator_vector;
+    for (Uint32 i = 0; i < loaded_texture_vector.size(); ++i)
+    {
+        Source const &source = *loaded_texture_vector[i].m_source;
+        Texture *texture = loaded_texture_vector[i].m_texture;
+
+        Entry entry;
+        entry.m_source = source;
+        entry.m_size = texture->Size();
+        entry.m_file_size = loaded_texture_vector[i].m_file_size;
+        entry.m_file_modification_time = loaded_texture_vector[i].m_file_modification_time;
+
+        if ((source.m_flags & GlTexture::USES_SEPARATE_ATLAS) != 0 || !uses_shared_atlases || texture->Width() > atlas_size[Dim::X])
+        {
+            // the texture gets its own atlas, and its pixels are the only mipmap level.
+            Atlas atlas;
+            atlas.m_size = texture->Size();
+            atlas.m_flags = source.m_flags | GlTexture::USES_SEPARATE_ATLAS;
+            atlas.m_mipmap_level_count = 1;
+            entry.m_atlas_index = atlas_vector.size();
+            entry.m_center = texture->Size() / 2;
+            atlas_vector.push_back(atlas);
+            mipmap_level_vector.push_back(std::vector<Texture *>(1, texture));
+            allocator_vector.push_back(NULL);
+            loaded_texture_vector[i].m_texture = NULL; // owned by mipmap_level_vector now
+        }
+        else
+        {
+            Uint32 a;
+            for (a = 0; a < atlas_vector.size(); ++a)
+                if (allocator_vector[a] != NULL &&
+                    atlas_vector[a].m_flags == source.m_flags &&
+                    allocator_vector[a]->Allocate(texture->Width(), entry.m_center))
+                {
+                    break;
+                }
+            if (a == atlas_vector.size())
+            {
+                Atlas atlas;
+                atlas.m_size = atlas_size;
+                atlas.m_flags = source.m_flags;
+                atlas.m_mipmap_level_count = (source.m_flags & GlTexture::MIPMAPS_DISABLED) != 0 ? 1 : GlTextureAtlas::MipmapLevelCount(atlas_size);
+                atlas_vector.push_back(atlas);
+                mipmap_level_vector.push_back(std::vector<Texture *>());
+                for (Uint32 level = 0; level < atlas.m_mipmap_level_count; ++level)
+                    mipmap_level_vector.back().push_back(Texture::Create(GlTextureAtlas::MipmapLevelSize(atlas_size, level), Texture::CLEAR));
+                allocator_vector.push_back(new GlTextureAtlasAllocator(atlas_size));
+                DEBUG1_CODE(bool allocated =)
+                allocator_vector.back()->Allocate(texture->Width(), entry.m_center);
+                ASSERT1(allocated);
+            }
+            entry.m_atlas_index = a;
+
+            MipmapLevelDestination destination(mipmap_level_vector[a]);
+            GlTextureAtlas::WriteMipmapsAndBorders(atlas_size, *texture, entry.m_center, atlas_vector[a].m_mipmap_level_count, destination);
+        }
+
+        entry_vector.push_back(entry);
+    }
+
+    // figure out where the pixel data goes
+    Uint32 metadata_byte_count = 1 + 5*sizeof(Uint32) + 4*sizeof(Uint32)*atlas_vector.size();
+    for (Uint32 i = 0; i < entry_vector.size(); ++i)
+        metadata_byte_count += sizeof(Uint32) + entry_vector[i].m_source.m_path.length() + 8*sizeof(Uint32);
+    Uint32 pixel_data_offset = gs_pixel_data_alignment * ((metadata_byte_count + gs_pixel_data_alignment - 1) / gs_pixel_data_alignment);
+
+    bool success = true;
+    try {
+        BufferedFileSerializer serializer(cache_path);
+
+        serializer.Write<Uint32>(ms_magic_number);
+        serializer.Write<Uint32>(ms_version);
+        serializer.Write<Uint32>(atlas_vector.size());
+        serializer.Write<Uint32>(entry_vector.size());
+        serializer.Write<Uint32>(pixel_data_offset);
+        for (Uint32 i = 0; i < atlas_vector.size(); ++i)
+        {
+            serializer.Write<Sint32>(atlas_vector[i].m_size[Dim::X]);
+            serializer.Write<Sint32>(atlas_vector[i].m_size[Dim::Y]);
+            serializer.Write<Uint32>(atlas_vector[i].m_flags);
+            serializer.Write<Uint32>(atlas_vector[i].m_mipmap_level_count);
+        }
+        for (Uint32 i = 0; i < entry_vector.size(); ++i)
+        {
+            serializer.WriteAggregate<std::string>(entry_vector[i].m_source.m_path);
+            serializer.Write<Uint32>(entry_vector[i].m_source.m_flags);
+            serializer.Write<Uint32>(entry_vector[i].m_atlas_index);
+            serializer.Write<Sint32>(entry_vector[i].m_size[Dim::X]);
+            serializer.Write<Sint32>(entry_vector[i].m_size[Dim::Y]);
+            serializer.Write<Sint32>(entry_vector[i].m_center[Dim::X]);
+            serializer.Write<Sint32>(entry_vector[i].m_center[Dim::Y]);
+            serializer.Write<Uint32>(entry_vector[i].m_file_size);
+            serializer.Write<Uint32>(entry_vector[i].m_file_modification_time);
+        }
+        for (Uint32 i = metadata_byte_count; i < pixel_data_offset; ++i)
+            serializer.Write<Uint8>(0);
+        for (Uint32 a = 0; a < mipmap_level_vector.size(); ++a)
+            for (Uint32 level = 0; level < mipmap_level_vector[a].size(); ++level)
+                serializer.WriteArray<Uint8>(mipmap_level_vector[a][level]->Data(), mipmap_level_vector[a][level]->DataLength());
+        serializer.Flush();
+
+        std::cerr << "baked " << entry_vector.size() << " textures into " << atlas_vector.size() << " atlases" << std::endl;
+    } catch (Exception const &e) {
+        std::cerr << "error baking gltexture atlas cache: " << e.what() << std::endl;
+        success = false;
+    }
+
+    for (Uint32 i = 0; i < loaded_texture_vector.size(); ++i)
+        Delete(loaded_texture_vector[i].m_texture);
+    for (Uint32 a = 0; a < mipmap_level_vector.size(); ++a)
+        for (Uint32 level = 0; level < mipmap_level_vector[a].size(); ++level)
+            Delete(mipmap_level_vector[a][level]);
+    for (Uint32 a = 0; a < allocator_vector.size(); ++a)
+        Delete(allocator_vector[a]);
+
+    return success;
+}
+
+GlTextureAtlasCache *GlTextureAtlasCache::Open (std::string const &cache_path)
+{
+    GlTextureAtlasCache *retval = new GlTextureAtlasCache();
+    try {
+        retval->m_file = new MemoryMappedSerializer(cache_path);
+        MemoryMappedSerializer &serializer = *retval->m_file;
+
+        if (serializer.Read<Uint32>() != ms_magic_number)
+            throw Exception("not a gltexture atlas cache file");
+        if (serializer.Read<Uint32>() != ms_version)
+            throw Exception("unsupported gltexture atlas cache version");
+
+        Uint32 atlas_count = serializer.Read<Uint32>();
+        Uint32 entry_count = serializer.Read<Uint32>();
+        retval->m_pixel_data_offset = serializer.Read<Uint32>();
+        if (atlas_count > gs_max_atlas_count || entry_count > gs_max_entry_count)
+            throw Exception("corrupt gltexture atlas cache file (invalid counts)");
+
+        Uint32 pixel_data_byte_count = 0;
+        retval->m_atlas_vector.resize(atlas_count);
+        for (Uint32 i = 0; i < atlas_count; ++i)
+        {
+            Atlas &atlas = retval->m_atlas_vector[i];
+            atlas.m_size[Dim::X] = serializer.Read<Sint32>();
+            atlas.m_size[Dim::Y] = serializer.Read<Sint32>();
+            atlas.m_flags = serializer.Read<Uint32>();
+            atlas.m_mipmap_level_count = serializer.Read<Uint32>();
+            atlas.m_pixel_data_offset = pixel_data_byte_count;
+            if (atlas.m_size[Dim::X] <= 0 || atlas.m_size[Dim::Y] <= 0 || atlas.m_size[Dim::X] > 0x8000 || atlas.m_size[Dim::Y] > 0x8000 ||
+                atlas.m_mipmap_level_count == 0 ||
+                (atlas.m_mipmap_level_count > 1 &&
+                 ((atlas.m_flags & GlTexture::USES_SEPARATE_ATLAS) != 0 ||
+                  !Math::IsAPowerOf2(atlas.m_size[Dim::X]) || !Math::IsAPowerOf2(atlas.m_size[Dim::Y]) ||
+                  atlas.m_mipmap_level_count > GlTextureAtlas::MipmapLevelCount(atlas.m_size))))
+            {
+                throw Exception("corrupt gltexture atlas cache file (invalid atlas)");
+            }
+            for (Uint32 level = 0; level < atlas.m_mipmap_level_count; ++level)
+                pixel_data_byte_count += MipmapLevelByteCount(MipmapLevelSize(atlas, level));
+        }
+
+        retval->m_entry_vector.resize(entry_count);
+        for (Uint32 i = 0; i < entry_count; ++i)
+        {
+            Entry &entry = retval->m_entry_vector[i];
+            serializer.ReadAggregate<std::string>(entry.m_source.m_path);
+            entry.m_source.m_flags = serializer.Read<Uint32>();
+            entry.m_atlas_index = serializer.Read<Uint32>();
+            entry.m_size[Dim::X] = serializer.Read<Sint32>();
+            entry.m_size[Dim::Y] = serializer.Read<Sint32>();
+            entry.m_center[Dim::X] = serializer.Read<Sint32>();
+            entry.m_center[Dim::Y] = serializer.Read<Sint32>();
+            entry.m_file_size = serializer.Read<Uint32>();
+            entry.m_file_modification_time = serializer.Read<Uint32>();
+            if (entry.m_atlas_index >= atlas_count)
+                throw Exception("corrupt gltexture atlas cache file (invalid atlas index)");
+
+            Uint32 file_size;
+            Uint32 file_modification_time;
+            if (!GetFileStamp(entry.m_source.m_path, file_size, file_modification_time) ||
+                file_size != entry.m_file_size ||
+                file_modification_time != entry.m_file_modification_time)
+            {
+                throw Exception(FORMAT("stale gltexture atlas cache file (\"" << entry.m_source.m_path << "\" has changed since it was baked)"));
+            }
+        }
+
+        if (serializer.ReaderPosition() > retval->m_pixel_data_offset ||
+            serializer.Size() != retval->m_pixel_data_offset + pixel_data_byte_count)
+            throw Exception("gltexture atlas cache file is the wrong size");
+    } catch (Exception const &e) {
+        std::cerr << "GlTextureAtlasCache::Open(); path = \"" << cache_path << "\" ... " << e.what() << std::endl;
+        Delete(retval);
+        return NULL;
+    }
+
+    return retval;
+}
+
+GlTextureAtlasCache::~GlTextureAtlasCache ()
+{
+    Delete(m_file);
+}
+
+Uint8 const *GlTextureAtlasCache::MipmapLevelPixelData (Uint32 atlas_index, Uint32 mipmap_level) const
+{
+    ASSERT1(m_file != NULL);
+    Atlas const &atlas = GetAtlas(atlas_index);
+    ASSERT1(mipmap_level < atlas.m_mipmap_level_count);
+
+    Uint32 offset = m_pixel_data_offset + atlas.m_pixel_data_offset;
+    for (Uint32 level = 0; level < mipmap_level; ++level)
+        offset += MipmapLevelByteCount(MipmapLevelSize(atlas, level));
+    ASSERT1(offset + MipmapLevelByteCount(MipmapLevelSize(atlas, mipmap_level)) <= m_file->Size());
+    return m_file->Data() + offset;
+}
+
+ScreenCoordVector2 GlTextureAtlasCache::MipmapLevelSize (Atlas const &atlas, Uint32 mipmap_level)
+{
+    ASSERT1(mipmap_level < atlas.m_mipmap_level_count);
+    if (atlas.m_mipmap_level_count == 1)
+        return atlas.m_size;
+    else
+        return GlTextureAtlas::MipmapLevelSize(atlas.m_size, mipmap_level);
+}
+
+GlTextureAtlasCache::GlTextureAtlasCache ()
+    :
+    m_pixel_data_offset(0),
+    m_file(NULL)
+{ }
+
+} // end of namespace Xrb
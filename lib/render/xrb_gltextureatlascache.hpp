@@ -0,0 +1,146 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_gltextureatlascache.hpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#if !defined(_XRB_GLTEXTUREATLASCACHE_HPP_)
+#define _XRB_GLTEXTUREATLASCACHE_HPP_
+
+#include "xrb.hpp"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "xrb_screencoord.hpp"
+
+namespace Xrb
+{
+
+class MemoryMappedSerializer;
+
+/// @brief A file of finished texture atlases -- the pixel data of every mipmap level, and where each texture is.
+/// @details Bake loads the images, places them with GlTextureAtlasAllocator and renders their mipmaps
+/// and borders into the atlas mipmap levels (exactly as GlTextureAtlas would), all without openGL, and
+/// writes the result.  Open memory-maps the file, so that Gl::LoadGlTextureAtlasCache can upload each
+/// mipmap level straight from it, and GlTexture::Create can then create the baked textures without
+/// decoding, mipmapping or uploading anything.
+///
+/// The file layout (everything before the pixel data is written with BufferedFileSerializer):
+///
+///     the endianness byte written by BufferedFileSerializer
+///     Uint32 magic number, Uint32 version
+///     Uint32 atlas count, Uint32 entry count, Uint32 pixel data offset (from the beginning of the file)
+///     for each atlas: Sint32 width, Sint32 height, Uint32 gltexture flags, Uint32 mipmap level count
+///     for each entry: std::string path, Uint32 gltexture flags, Uint32 atlas index,
+///                     Sint32 width, Sint32 height, Sint32 center x, Sint32 center y,
+///                     Uint32 image file size, Uint32 image file modification time
+///     zero padding up to the pixel data offset
+///     for each atlas, for each mipmap level: the RGBA pixels of the whole level
+///
+/// Open rejects the file if any of the image files has changed size or modification time
+/// since it was baked (or can't be found anymore), so that edited images are never served
+/// from a stale cache.
+class GlTextureAtlasCache
+{
+public:
+
+    /// One texture to bake -- the path and flags of its GlTexture::LoadParameters.
+    struct Source
+    {
+        std::string m_path;
+        Uint32 m_flags;
+
+        Source (std::string const &path, Uint32 flags) : m_path(path), m_flags(flags) { }
+
+        bool operator < (Source const &source) const
+        {
+            return m_path < source.m_path || (m_path == source.m_path && m_flags < source.m_flags);
+        }
+    }; // end of struct GlTextureAtlasCache::Source
+
+    typedef std::set<Source> SourceSet;
+
+    struct Atlas
+    {
+        ScreenCoordVector2 m_size;
+        Uint32 m_flags;
+        Uint32 m_mipmap_level_count;
+        // the offset of mipmap level 0 within the pixel data (the other
+        // levels follow it immediately).
+        Uint32 m_pixel_data_offset;
+
+        Atlas () : m_flags(0), m_mipmap_level_count(0), m_pixel_data_offset(0) { }
+    }; // end of struct GlTextureAtlasCache::Atlas
+
+    struct Entry
+    {
+        Source m_source;
+        Uint32 m_atlas_index;
+        // the size of the original image
+        ScreenCoordVector2 m_size;
+        // the center of the texture in its atlas (for non-separate atlases)
+        ScreenCoordVector2 m_center;
+        // the size and modification time of the image file when it was baked
+        Uint32 m_file_size;
+        Uint32 m_file_modification_time;
+
+        Entry () : m_source("", 0), m_atlas_index(0), m_file_size(0), m_file_modification_time(0) { }
+    }; // end of struct GlTextureAtlasCache::Entry
+
+    /// @brief Bakes the given textures into a cache file, returning true upon success.
+    /// @details Doesn't use openGL (the images are loaded with Pal::LoadImage), so this can be
+    /// done offline.  atlas_size should be the same as Pal::GlTextureAtlasSize at runtime.
+    /// Textures which can't be loaded (including "internal://" ones, and any whose file can't
+    /// be found by FileSystem) are skipped.
+    static bool Bake (SourceSet const &source_set, ScreenCoordVector2 const &atlas_size, std::string const &cache_path);
+    /// @brief Opens (memory-maps, with MemoryMappedSerializer) the given cache file, returning NULL if it doesn't exist or isn't valid.
+    /// @details The file isn't valid if any of the baked image files has changed since it was baked.
+    static GlTextureAtlasCache *Open (std::string const &cache_path);
+
+    ~GlTextureAtlasCache ();
+
+    Uint32 AtlasCount () const { return m_atlas_vector.size(); }
+    Atlas const &GetAtlas (Uint32 atlas_index) const
+    {
+        ASSERT1(atlas_index < m_atlas_vector.size());
+        return m_atlas_vector[atlas_index];
+    }
+    Uint32 EntryCount () const { return m_entry_vector.size(); }
+    Entry const &GetEntry (Uint32 entry_index) const
+    {
+        ASSERT1(entry_index < m_entry_vector.size());
+        return m_entry_vector[entry_index];
+    }
+    /// Returns the RGBA pixels of the given mipmap level of the given atlas (in the mapped file).
+    Uint8 const *MipmapLevelPixelData (Uint32 atlas_index, Uint32 mipmap_level) const;
+
+    /// The size of the given mipmap level of the given baked atlas.
+    static ScreenCoordVector2 MipmapLevelSize (Atlas const &atlas, Uint32 mipmap_level);
+
+private:
+
+    typedef std::vector<Atlas> AtlasVector;
+    typedef std::vector<Entry> EntryVector;
+
+    GlTextureAtlasCache ();
+
+    AtlasVector m_atlas_vector;
+    EntryVector m_entry_vector;
+    Uint32 m_pixel_data_offset;
+    // the mapped file, which the pixel data is read directly out of
+    MemoryMappedSerializer *m_file;
+
+    static Uint32 const ms_magic_number;
+    static Uint32 const ms_version;
+}; // end of class GlTextureAtlasCache
+
+} // end of namespace Xrb
+
+#endif // !defined(_XRB_GLTEXTUREATLASCACHE_HPP_)
+
@@ -17,6 +17,90 @@
 namespace Xrb
 {
 
+namespace {
+
+// element f is the unit circle vertex table for f facets (empty until used).
+std::vector<std::vector<FloatVector2> > gs_unit_circle_table;
+// reused by the functions below, so they don't allocate on every call.
+std::vector<FloatVector2> gs_vertex_array;
+std::vector<Uint32> gs_color_array;
+
+// returns the vertices (cos(2*pi*i/facet_count), sin(2*pi*i/facet_count))
+// for i = 0 through facet_count-1, computing them only the first time.
+FloatVector2 const *UnitCircleTable (Uint32 facet_count)
+{
+    ASSERT1(facet_count >= 3);
+    if (facet_count >= gs_unit_circle_table.size())
+        gs_unit_circle_table.resize(facet_count + 1);
+
+    std::vector<FloatVector2> &table = gs_unit_circle_table[facet_count];
+    if (table.empty())
+    {
+        table.resize(facet_count);
+        for (Uint32 i = 0; i < facet_count; ++i)
+        {
+            Float angle = 2.0f * static_cast<Float>(M_PI) * static_cast<Float>(i) / static_cast<Float>(facet_count);
+            table[i].SetComponents(cos(angle), sin(angle));
+        }
+    }
+    return &table[0];
+}
+
+// returns v rotated counterclockwise by the angle whose cosine and sine
+// are the components of rotation.
+inline FloatVector2 Rotated (FloatVector2 const &v, FloatVector2 const &rotation)
+{
+    return FloatVector2(v[Dim::X]*rotation[Dim::X] - v[Dim::Y]*rotation[Dim::Y],
+                        v[Dim::X]*rotation[Dim::Y] + v[Dim::Y]*rotation[Dim::X]);
+}
+
+// the number of facets DrawCircle uses for a circle of the given radius
+Uint32 CircleFacetCount (FloatMatrix2 const &transformation, Float radius)
+{
+    // find out how large the radius is in pixels
+    Float pixel_radius =
+        Max((transformation * FloatVector2(radius, 0.0f) -
+             transformation * FloatVector2::ms_zero).Length(),
+            (transformation * FloatVector2(0.0f, radius) -
+             transformation * FloatVector2::ms_zero).Length());
+    // figure out how many lines there should be
+    Float const radius_limit_upper = 100.0f;
+    Float const radius_limit_lower = 2.0f;
+    Float const tesselation_limit_upper = 30.0f;
+    Float const tesselation_limit_lower = 6.0f;
+
+    Uint32 facet_count;
+    if (pixel_radius <= radius_limit_lower)
+        facet_count = static_cast<Uint32>(tesselation_limit_lower);
+    else if (pixel_radius >= radius_limit_upper)
+        facet_count = static_cast<Uint32>(tesselation_limit_upper);
+    else
+    {
+        Float x =
+            (pixel_radius - radius_limit_lower) /
+            (radius_limit_upper - radius_limit_lower);
+        facet_count =
+            static_cast<Uint32>(
+                tesselation_limit_upper * x +
+                tesselation_limit_lower * (1.0f - x));
+    }
+
+    ASSERT1(facet_count >= 6);
+    ASSERT2(facet_count <= 30);
+    return facet_count;
+}
+
+// the color which the color-only version of Gl::SetupTextureUnits would
+// use for the given color mask and bias (the two must match exactly).
+Color MaskedAndBiasedColor (Color const &color_mask, Color const &color_bias)
+{
+    Color color(color_mask * (1.0f - color_bias[Dim::A]) + color_bias * color_bias[Dim::A]);
+    color[Dim::A] = color_mask[Dim::A];
+    return color;
+}
+
+} // end of anonymous namespace
+
 void Render::DrawLine (
     RenderContext const &render_context,
     FloatVector2 const &from,
@@ -43,8 +127,8 @@ void Render::DrawLine (
     {
         FloatVector2 vertex_array[2] = { from, to };
 
-        glVertexPointer(2, GL_FLOAT, 0, vertex_array);
-        glDrawArrays(GL_LINES, 0, 2);
+        Gl::VertexPointer(2, GL_FLOAT, 2, vertex_array);
+        Gl::DrawArrays(GL_LINES, 0, 2);
     }
 
     glMatrixMode(GL_MODELVIEW);
@@ -82,15 +166,15 @@ void Render::DrawArrow (
     {
         FloatVector2 vertex_array[3] = { from, to, to+0.25f*(basis_y-basis_x) };
 
-        glVertexPointer(2, GL_FLOAT, 0, vertex_array);
-        glDrawArrays(GL_LINE_STRIP, 0, 3);
+        Gl::VertexPointer(2, GL_FLOAT, 3, vertex_array);
+        Gl::DrawArrays(GL_LINE_STRIP, 0, 3);
     }
 
     {
         FloatVector2 vertex_array[2] = { to-0.25f*(basis_y+basis_x), to };
 
-        glVertexPointer(2, GL_FLOAT, 0, vertex_array);
-        glDrawArrays(GL_LINE_STRIP, 0, 2);
+        Gl::VertexPointer(2, GL_FLOAT, 2, vertex_array);
+        Gl::DrawArrays(GL_LINE_STRIP, 0, 2);
     }
 
     glMatrixMode(GL_MODELVIEW);
@@ -128,21 +212,17 @@ void Render::DrawPolygon (
     // computation in cos/sin's native units.
     angle = Math::Radians(angle);
 
-    // draw each line
-    FloatVector2 vertex = center + radius * FloatVector2(cos(angle), sin(angle));
-    Float const angle_delta = 2.0f * static_cast<Float>(M_PI) / static_cast<Float>(vertex_count);
-
-    // TODO: limit vertex_count to 32 (or so) and use a static array instead of new'ing.
-    // or we could use a small static array and just call glDrawArrays multiple times.
+    // rotate the cached unit circle vertices, instead of computing
+    // cos and sin for every vertex.
     {
-        FloatVector2 *vertex_array = new FloatVector2[vertex_count];
-        for (Uint32 i = 0; i < vertex_count; ++i, angle += angle_delta)
-            vertex_array[i] = center + radius * FloatVector2(cos(angle), sin(angle));
-
-        glVertexPointer(2, GL_FLOAT, 0, vertex_array);
-        glDrawArrays(fill ? GL_TRIANGLE_FAN : GL_LINE_LOOP, 0, vertex_count);
-
-        delete[] vertex_array;
+        FloatVector2 const *unit_circle = UnitCircleTable(vertex_count);
+        FloatVector2 rotation(cos(angle), sin(angle));
+        gs_vertex_array.resize(vertex_count);
+        for (Uint32 i = 0; i < vertex_count; ++i)
+            gs_vertex_array[i] = center + radius * Rotated(unit_circle[i], rotation);
+
+        Gl::VertexPointer(2, GL_FLOAT, vertex_count, &gs_vertex_array[0]);
+        Gl::DrawArrays(fill ? GL_TRIANGLE_FAN : GL_LINE_LOOP, 0, vertex_count);
     }
 
     glMatrixMode(GL_MODELVIEW);
@@ -160,38 +240,69 @@ void Render::DrawCircle (
     if (render_context.MaskAndBiasWouldResultInNoOp(color[Dim::A]))
         return;
 
-    // find out how large the radius is in pixels
-    Float pixel_radius =
-        Max((transformation * FloatVector2(radius, 0.0f) -
-             transformation * FloatVector2::ms_zero).Length(),
-            (transformation * FloatVector2(0.0f, radius) -
-             transformation * FloatVector2::ms_zero).Length());
-    // figure out how many lines there should be
-    Float const radius_limit_upper = 100.0f;
-    Float const radius_limit_lower = 2.0f;
-    Float const tesselation_limit_upper = 30.0f;
-    Float const tesselation_limit_lower = 6.0f;
+    DrawPolygon(render_context, center, radius, 0.0f, color, fill, CircleFacetCount(transformation, radius));
+}
 
-    Uint32 facet_count;
-    if (pixel_radius <= radius_limit_lower)
-        facet_count = static_cast<Uint32>(tesselation_limit_lower);
-    else if (pixel_radius >= radius_limit_upper)
-        facet_count = static_cast<Uint32>(tesselation_limit_upper);
-    else
+void Render::DrawCircleBatch (
+    RenderContext const &render_context,
+    FloatMatrix2 const &transformation,
+    CircleBatch const &circle_batch,
+    bool fill)
+{
+    // filled circles are drawn as separate triangles (a fan each), and
+    // outlines as separate lines, so that all circles go in one draw call.
+    gs_vertex_array.clear();
+    gs_color_array.clear();
+    for (CircleBatch::const_iterator it = circle_batch.begin(), it_end = circle_batch.end();
+         it != it_end;
+         ++it)
     {
-        Float x =
-            (pixel_radius - radius_limit_lower) /
-            (radius_limit_upper - radius_limit_lower);
-        facet_count =
-            static_cast<Uint32>(
-                tesselation_limit_upper * x +
-                tesselation_limit_lower * (1.0f - x));
+        CircleBatchEntry const &entry = *it;
+        if (render_context.MaskAndBiasWouldResultInNoOp(entry.m_color[Dim::A]))
+            continue;
+
+        Uint32 color_rgba = MaskedAndBiasedColor(render_context.MaskedColor(entry.m_color), render_context.ColorBias()).Rgba();
+        Uint32 facet_count = CircleFacetCount(transformation, entry.m_radius);
+        FloatVector2 const *unit_circle = UnitCircleTable(facet_count);
+        for (Uint32 i = 0; i < facet_count; ++i)
+        {
+            FloatVector2 vertex0(entry.m_center + entry.m_radius * unit_circle[i]);
+            FloatVector2 vertex1(entry.m_center + entry.m_radius * unit_circle[(i+1 == facet_count) ? 0 : i+1]);
+            if (fill)
+                gs_vertex_array.push_back(entry.m_center);
+            gs_vertex_array.push_back(vertex0);
+            gs_vertex_array.push_back(vertex1);
+        }
+        gs_color_array.resize(gs_vertex_array.size(), color_rgba);
     }
 
-    ASSERT1(facet_count >= 6);
-    ASSERT2(facet_count <= 30);
+    if (gs_vertex_array.empty())
+        return;
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
 
-    DrawPolygon(render_context, center, radius, 0.0f, color, fill, facet_count);
+    // this disables texturing.  the colors come from the color array (which
+    // already has the color mask and bias applied), not from glColor.
+    Singleton::Gl().SetupTextureUnits(
+        Color::ms_identity_color_mask,
+        Color::ms_identity_color_bias);
+
+    Gl::EnableClientState(GL_VERTEX_ARRAY);
+    ASSERT1(Gl::ClientActiveTexture() == GL_TEXTURE0);
+    Gl::DisableClientState(GL_TEXTURE_COORD_ARRAY);
+    Gl::EnableClientState(GL_COLOR_ARRAY);
+
+    Gl::VertexPointer(2, GL_FLOAT, gs_vertex_array.size(), &gs_vertex_array[0]);
+    Gl::ColorPointer(4, GL_UNSIGNED_BYTE, gs_color_array.size(), &gs_color_array[0]);
+    Gl::DrawArrays(fill ? GL_TRIANGLES : GL_LINES, 0, gs_vertex_array.size());
+
+    // everything else uses glColor for the color
+    Gl::DisableClientState(GL_COLOR_ARRAY);
+
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
 }
 
 void Render::DrawCircularArc (
@@ -269,23 +380,23 @@ void Render::DrawCircularArc (
     ASSERT1(Gl::ClientActiveTexture() == GL_TEXTURE0);
     Gl::DisableClientState(GL_TEXTURE_COORD_ARRAY);
 
-    // TODO: is it possible to bound facet_count and use a static array?  (maybe not,
-    // since the arc can be through a really high angle).  or we could use a small static
-    // array and just call glDrawArrays multiple times.
+    // each vertex is the previous one rotated by angle_delta, so only the
+    // first vertex and the rotation need cos and sin.
     {
         Float const angle_delta = (end_angle - start_angle) / facet_count;
-        Float angle = start_angle + angle_delta;
+        FloatVector2 const rotation(cos(angle_delta), sin(angle_delta));
+        FloatVector2 offset(radius * FloatVector2(cos(start_angle), sin(start_angle)));
 
-        FloatVector2 *vertex_array = new FloatVector2[facet_count+1];
-        for (Uint32 i = 0; i < facet_count; ++i, angle += angle_delta)
-            vertex_array[i] = center + radius * FloatVector2(cos(angle), sin(angle));
-        // one more (there is 1 more vertex than facet)
-        vertex_array[facet_count] = center + radius * FloatVector2(cos(angle), sin(angle));
-
-        glVertexPointer(2, GL_FLOAT, 0, vertex_array);
-        glDrawArrays(GL_LINE_STRIP, 0, facet_count+1);
+        // there is 1 more vertex than facet
+        gs_vertex_array.resize(facet_count+1);
+        for (Uint32 i = 0; i <= facet_count; ++i)
+        {
+            gs_vertex_array[i] = center + offset;
+            offset = Rotated(offset, rotation);
+        }
 
-        delete[] vertex_array;
+        Gl::VertexPointer(2, GL_FLOAT, facet_count+1, &gs_vertex_array[0]);
+        Gl::DrawArrays(GL_LINE_STRIP, 0, facet_count+1);
     }
 
     glMatrixMode(GL_MODELVIEW);
@@ -331,9 +442,9 @@ void Render::DrawScreenRect (
         };
 */
 
-        glVertexPointer(2, GL_SHORT, 0, vertex_coordinate_array);
+        Gl::VertexPointer(2, GL_SHORT, 4, vertex_coordinate_array);
 //         glVertexPointer(2, GL_INT, 0, vertex_coordinate_array);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        Gl::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
 
     glMatrixMode(GL_MODELVIEW);
@@ -389,9 +500,9 @@ void Render::DrawScreenRectTexture (
         ASSERT1(Gl::ClientActiveTexture() == GL_TEXTURE0);
         Gl::EnableClientState(GL_TEXTURE_COORD_ARRAY);
 
-        glVertexPointer(2, GL_SHORT, 0, vertex_coordinate_array);
-        glTexCoordPointer(2, GL_SHORT, 0, texture_coordinate_array);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        Gl::VertexPointer(2, GL_SHORT, 4, vertex_coordinate_array);
+        Gl::TexCoordPointer(2, GL_SHORT, 4, texture_coordinate_array);
+        Gl::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     }
 
     glMatrixMode(GL_MODELVIEW);
@@ -13,6 +13,8 @@
 
 #include "xrb.hpp"
 
+#include <vector>
+
 #include "xrb_color.hpp"
 #include "xrb_matrix2.hpp"
 #include "xrb_rect.hpp"
@@ -31,6 +33,7 @@ class GlTexture;
   *     <li>Drawing a line.</li>
   *     <li>Drawing an arrow, with arrow's head size proportional to the arrow's length.</li>
   *     <li>Drawing a circle.</li>
+  *     <li>Drawing many circles at once.</li>
   *     <li>Drawing a circular arc.</li>
   *     <li>Filling a rectangle with a solid color.</li>
   *     <li>Mapping a texture to a rectangle.</li>
@@ -56,6 +59,23 @@ class GlTexture;
   */
 namespace Render
 {
+    /// @brief One of the circles drawn by DrawCircleBatch.
+    struct CircleBatchEntry
+    {
+        FloatVector2 m_center;
+        Float m_radius;
+        Color m_color;
+
+        CircleBatchEntry (FloatVector2 const &center, Float radius, Color const &color)
+            :
+            m_center(center),
+            m_radius(radius),
+            m_color(color)
+        { }
+    }; // end of struct Render::CircleBatchEntry
+
+    typedef std::vector<CircleBatchEntry> CircleBatch;
+
     // ///////////////////////////////////////////////////////////////////////
     // in-WorldView rendering functions
     // ///////////////////////////////////////////////////////////////////////
@@ -138,6 +158,25 @@ namespace Render
         Float radius,
         Color const &color,
         bool fill);
+    /** Each circle is tesselated exactly as DrawCircle would, but all of
+      * them are drawn with a single draw call (the colors are specified per
+      * vertex), so this is much faster than calling DrawCircle for each one.
+      *
+      * Obliterates the modelview matrix.
+      *
+      * @brief Draws all the circles in the given batch.
+      * @param render_context The required RenderContext.
+      * @param transformation The world-to-screen transformation matrix
+      *                       which is used to calculate the necessary number
+      *                       of lines to use to draw each circle.
+      * @param circle_batch The circles to draw, in modelspace.
+      * @param fill Specify true iff the circles should be filled with their colors.
+      */
+    void DrawCircleBatch (
+        RenderContext const &render_context,
+        FloatMatrix2 const &transformation,
+        CircleBatch const &circle_batch,
+        bool fill);
     /** The number of lines used to draw the arc is dependent on
       * @c transformation.  The larger the arc appears, the more
       * lines will be used to draw it.  No more than 30 lines per full
@@ -0,0 +1,125 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_bufferedfileserializer.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "xrb_bufferedfileserializer.hpp"
+
+#include <string.h>
+
+#include "xrb_endian.hpp"
+#include "xrb_filesystem.hpp"
+#include "xrb_math.hpp"
+#include "xrb_singleton.hpp"
+
+namespace Xrb {
+
+BufferedFileSerializer::BufferedFileSerializer (std::string const &path, Uint32 buffer_size)
+    :
+    Serializer(),
+    m_path(path),
+    m_file(NULL),
+    m_buffer(new Uint8[Max(buffer_size, Uint32(1))]),
+    m_buffer_size(Max(buffer_size, Uint32(1))),
+    m_buffered_byte_count(0)
+{
+    try {
+        std::string os_path(Singleton::FileSystem().OsPath(path, FileSystem::WRITABLE));
+        m_file = std::fopen(os_path.c_str(), "wb");
+    } catch (Exception const &e) {
+        // throwing during construction means the destructor won't be called
+        delete[] m_buffer;
+        throw;
+    }
+    if (m_file == NULL)
+    {
+        delete[] m_buffer;
+        throw Exception(FORMAT("error while opening file for writing"));
+    }
+    // m_buffer does the buffering
+    std::setvbuf(m_file, NULL, _IONBF, 0);
+
+    Write<bool>(Endianness::OF_TARGET == Endianness::LITTLE);
+}
+
+BufferedFileSerializer::~BufferedFileSerializer () throw()
+{
+    try {
+        Flush();
+    } catch (Exception const &e) {
+        std::cerr << "BufferedFileSerializer::~BufferedFileSerializer(); path = \"" << m_path << "\" ... " << e.what() << std::endl;
+    }
+    std::fclose(m_file);
+    delete[] m_buffer;
+}
+
+void BufferedFileSerializer::Flush ()
+{
+    if (m_buffered_byte_count == 0)
+        return;
+
+    // empty the buffer first, so that a failed write isn't retried forever
+    Uint32 byte_count = m_buffered_byte_count;
+    m_buffered_byte_count = 0;
+    WriteToFile(m_buffer, byte_count);
+}
+
+void BufferedFileSerializer::ReaderSeek (Sint32 offset, SeekRelativeTo relative_to)
+{
+    throw Exception("this Serializer is not readable");
+}
+
+void BufferedFileSerializer::WriterSeek (Sint32 offset, SeekRelativeTo relative_to)
+{
+    Flush();
+
+    int whence = SEEK_SET;
+    switch (relative_to)
+    {
+        case FROM_BEGINNING:        whence = SEEK_SET; break;
+        case FROM_CURRENT_POSITION: whence = SEEK_CUR; break;
+        case FROM_END:              whence = SEEK_END; break;
+        default: ASSERT1(false && "this should never happen");
+    }
+    if (std::fseek(m_file, offset, whence) != 0)
+        throw Exception(FORMAT("error during call to WriterSeek"));
+}
+
+void BufferedFileSerializer::ReadRawWords (Uint8 *dest, Uint32 word_size, Uint32 word_count)
+{
+    throw Exception("this Serializer is not readable");
+}
+
+void BufferedFileSerializer::WriteRawWords (Uint8 const *source, Uint32 word_size, Uint32 word_count)
+{
+    ASSERT1(word_size > 0 && "you silly human!");
+    ASSERT1(Math::IsAPowerOf2(word_size) && "you're probably trying to read/write a struct, aren't you?");
+
+    Uint32 byte_count = word_size*word_count;
+    if (byte_count > m_buffer_size - m_buffered_byte_count)
+    {
+        Flush();
+        // if it still won't fit, don't bother copying it
+        if (byte_count >= m_buffer_size)
+        {
+            WriteToFile(source, byte_count);
+            return;
+        }
+    }
+    memcpy(m_buffer + m_buffered_byte_count, source, byte_count);
+    m_buffered_byte_count += byte_count;
+}
+
+void BufferedFileSerializer::WriteToFile (Uint8 const *source, Uint32 byte_count)
+{
+    ASSERT1(m_buffered_byte_count == 0);
+    if (std::fwrite(source, 1, byte_count, m_file) != byte_count)
+        throw Exception(FORMAT("could not write " << byte_count << " bytes"));
+}
+
+} // end of namespace Xrb
@@ -0,0 +1,78 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_bufferedfileserializer.hpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#if !defined(_XRB_BUFFEREDFILESERIALIZER_HPP_)
+#define _XRB_BUFFEREDFILESERIALIZER_HPP_
+
+#include "xrb.hpp"
+
+#include <cstdio>
+
+#include "xrb_serializer.hpp"
+
+namespace Xrb {
+
+/// @brief Write-only Serializer implementation for binary files, which collects the writes in a large buffer.
+/// @details Construction opens (and truncates) the file, destruction flushes the buffer and closes it.
+/// Each write is just a copy into the buffer, and the buffer is written to the file only when it fills
+/// up (writes larger than the buffer go straight to the file), instead of a stream call per word.
+///
+/// The file format is exactly that of BinaryFileSerializer (the first byte indicates the endianness,
+/// and everything is written in the endianness of the target), so the files can be read by
+/// BinaryFileSerializer or MemoryMappedSerializer.
+///
+/// The destructor can't throw, so call Flush before destruction in order to find out if all the
+/// writes succeeded.  Exceptions are thrown to indicate error (see @ref Serializer ).
+class BufferedFileSerializer : public Serializer
+{
+public:
+
+    enum { DEFAULT_BUFFER_SIZE = 0x10000 };
+
+    /// Attempts to open the given file (as an OS path, or a FS path beginning with "fs://") for writing.
+    BufferedFileSerializer (std::string const &path, Uint32 buffer_size = DEFAULT_BUFFER_SIZE);
+    virtual ~BufferedFileSerializer () throw();
+
+    std::string const &Path () const { return m_path; }
+
+    /// Writes the buffered data to the file, throwing an exception upon error.
+    void Flush ();
+
+    // Serializer interface methods
+    virtual bool IsReadable () const throw() { return false; }
+    virtual bool IsWritable () const throw() { return true; }
+    virtual bool IsReaderSeekable () const throw() { return false; }
+    virtual bool IsWriterSeekable () const throw() { return true; }
+    virtual bool IsAtEnd () const { return false; }
+    virtual void ReaderSeek (Sint32 offset, SeekRelativeTo relative_to = FROM_BEGINNING);
+    virtual void WriterSeek (Sint32 offset, SeekRelativeTo relative_to = FROM_BEGINNING);
+
+protected:
+
+    // Serializer interface methods
+    virtual void ReadRawWords (Uint8 *dest, Uint32 word_size, Uint32 word_count);
+    virtual void WriteRawWords (Uint8 const *source, Uint32 word_size, Uint32 word_count);
+
+private:
+
+    // writes directly to the file (the buffer must be flushed first)
+    void WriteToFile (Uint8 const *source, Uint32 byte_count);
+
+    std::string const m_path;
+    std::FILE *m_file;
+    Uint8 *const m_buffer;
+    Uint32 const m_buffer_size;
+    Uint32 m_buffered_byte_count;
+}; // end of class BufferedFileSerializer
+
+} // end of namespace Xrb
+
+#endif // !defined(_XRB_BUFFEREDFILESERIALIZER_HPP_)
+
@@ -0,0 +1,166 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_memorymappedserializer.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "xrb_memorymappedserializer.hpp"
+
+#include <string.h>
+
+#if !defined(WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else // defined(WIN32)
+#include <fstream>
+#endif // defined(WIN32)
+
+#include "xrb_filesystem.hpp"
+#include "xrb_math.hpp"
+#include "xrb_singleton.hpp"
+
+namespace Xrb {
+
+MemoryMappedSerializer::MemoryMappedSerializer (std::string const &path)
+    :
+    Serializer(),
+    m_path(path),
+    m_data(NULL),
+    m_size(0),
+    m_position(0),
+    m_data_is_buffered(false),
+    m_file_endianness(Endianness::OF_TARGET)
+{
+    if (!Map(Singleton::FileSystem().OsPath(path, FileSystem::READ_ONLY)))
+        throw Exception(FORMAT("error while opening file for reading"));
+    // the endianness byte is written by Write<bool>, so it's read by Read<bool>
+    // (which doesn't need to know the endianness).
+    m_file_endianness = (Read<bool>() ? Endianness::LITTLE : Endianness::BIG);
+}
+
+MemoryMappedSerializer::~MemoryMappedSerializer () throw()
+{
+    Unmap();
+}
+
+void MemoryMappedSerializer::ReaderSeek (Sint32 offset, SeekRelativeTo relative_to)
+{
+    Sint32 base = 0;
+    switch (relative_to)
+    {
+        case FROM_BEGINNING:        base = 0;                   break;
+        case FROM_CURRENT_POSITION: base = Sint32(m_position);  break;
+        case FROM_END:              base = Sint32(m_size);      break;
+        default: ASSERT1(false && "this should never happen");
+    }
+    if (offset < -base || offset > Sint32(m_size) - base)
+        throw Exception(FORMAT("error during call to ReaderSeek (seeking outside of the file)"));
+    m_position = Uint32(base + offset);
+}
+
+void MemoryMappedSerializer::WriterSeek (Sint32 offset, SeekRelativeTo relative_to)
+{
+    throw Exception("this Serializer is not writable");
+}
+
+void MemoryMappedSerializer::ReadRawWords (Uint8 *dest, Uint32 word_size, Uint32 word_count)
+{
+    ASSERT1(word_size > 0 && "you silly human!");
+    ASSERT1(Math::IsAPowerOf2(word_size) && "you're probably trying to read/write a struct, aren't you?");
+    ASSERT1(m_position <= m_size);
+
+    if (word_count > (m_size - m_position) / word_size)
+        throw Exception(FORMAT("could not read " << word_count << " words each of size " << word_size << " (hit EOF prematurely)"));
+
+    Uint32 byte_count = word_size*word_count;
+    memcpy(dest, m_data + m_position, byte_count);
+    m_position += byte_count;
+
+    if (m_file_endianness != Endianness::OF_TARGET)
+        SwitchByteOrder(dest, word_size, word_count);
+}
+
+void MemoryMappedSerializer::WriteRawWords (Uint8 const *source, Uint32 word_size, Uint32 word_count)
+{
+    throw Exception("this Serializer is not writable");
+}
+
+bool MemoryMappedSerializer::Map (std::string const &os_path)
+{
+    ASSERT1(m_data == NULL);
+
+#if !defined(WIN32)
+    int fd = open(os_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    // an empty file can't be mapped (and has no endianness byte anyway)
+    struct stat file_status;
+    if (fstat(fd, &file_status) != 0 || file_status.st_size <= 0 || file_status.st_size > Sint32(SINT32_UPPER_BOUND))
+    {
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after the file is closed
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<Uint8 const *>(data);
+    m_size = file_status.st_size;
+    m_data_is_buffered = false;
+    return true;
+#else // defined(WIN32)
+    // no mmap, so just read the whole thing in
+    std::ifstream stream(os_path.c_str(), std::ios_base::in|std::ios_base::binary);
+    if (!stream.is_open())
+        return false;
+
+    stream.seekg(0, std::ios_base::end);
+    std::streamoff file_size = stream.tellg();
+    stream.seekg(0, std::ios_base::beg);
+    if (file_size <= 0 || file_size > std::streamoff(SINT32_UPPER_BOUND))
+        return false;
+
+    Uint8 *data = new Uint8[file_size];
+    stream.read(reinterpret_cast<char *>(data), file_size);
+    if (!stream)
+    {
+        delete[] data;
+        return false;
+    }
+
+    m_data = data;
+    m_size = file_size;
+    m_data_is_buffered = true;
+    return true;
+#endif // defined(WIN32)
+}
+
+void MemoryMappedSerializer::Unmap ()
+{
+    if (m_data == NULL)
+        return;
+
+#if !defined(WIN32)
+    if (!m_data_is_buffered)
+    {
+        munmap(const_cast<Uint8 *>(m_data), m_size);
+        m_data = NULL;
+        return;
+    }
+#endif // !defined(WIN32)
+    ASSERT1(m_data_is_buffered);
+    delete[] m_data;
+    m_data = NULL;
+}
+
+} // end of namespace Xrb
@@ -0,0 +1,81 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_memorymappedserializer.hpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#if !defined(_XRB_MEMORYMAPPEDSERIALIZER_HPP_)
+#define _XRB_MEMORYMAPPEDSERIALIZER_HPP_
+
+#include "xrb.hpp"
+
+#include "xrb_endian.hpp"
+#include "xrb_serializer.hpp"
+
+namespace Xrb {
+
+/// @brief Read-only Serializer implementation for files written by BinaryFileSerializer or BufferedFileSerializer.
+/// @details Construction memory-maps the whole file (on WIN32, it's read into a buffer instead),
+/// and destruction unmaps it.  Reading is then just copying out of the mapped file, instead of
+/// a stream call per word.  As with BinaryFileSerializer, the first byte of the file indicates
+/// its endianness, and the words read are byte-order switched (all of the words of each read
+/// at once) only if that differs from the endianness of the target.
+///
+/// The file contents are also directly accessible through Data, e.g. for handing large blocks
+/// of data to openGL without copying them.  Exceptions are thrown to indicate error (see
+/// @ref Serializer ).
+class MemoryMappedSerializer : public Serializer
+{
+public:
+
+    /// Attempts to map the given file (as an OS path, or a FS path beginning with "fs://").
+    MemoryMappedSerializer (std::string const &path);
+    virtual ~MemoryMappedSerializer () throw();
+
+    std::string const &Path () const { return m_path; }
+    Endianness::Value FileEndianness () const { return m_file_endianness; }
+    /// Returns the contents of the whole file (including the endianness byte).
+    Uint8 const *Data () const { return m_data; }
+    /// Returns the size of the whole file in bytes.
+    Uint32 Size () const { return m_size; }
+    /// Returns the offset (from the beginning of the file) of the next byte to be read.
+    Uint32 ReaderPosition () const { return m_position; }
+
+    // Serializer interface methods
+    virtual bool IsReadable () const throw() { return true; }
+    virtual bool IsWritable () const throw() { return false; }
+    virtual bool IsReaderSeekable () const throw() { return true; }
+    virtual bool IsWriterSeekable () const throw() { return false; }
+    virtual bool IsAtEnd () const { return m_position >= m_size; }
+    virtual void ReaderSeek (Sint32 offset, SeekRelativeTo relative_to = FROM_BEGINNING);
+    virtual void WriterSeek (Sint32 offset, SeekRelativeTo relative_to = FROM_BEGINNING);
+
+protected:
+
+    // Serializer interface methods
+    virtual void ReadRawWords (Uint8 *dest, Uint32 word_size, Uint32 word_count);
+    virtual void WriteRawWords (Uint8 const *source, Uint32 word_size, Uint32 word_count);
+
+private:
+
+    // returns false if the file couldn't be mapped
+    bool Map (std::string const &os_path);
+    void Unmap ();
+
+    std::string const m_path;
+    Uint8 const *m_data;
+    Uint32 m_size;
+    Uint32 m_position;
+    // true iff m_data was read into a buffer (instead of memory-mapped)
+    bool m_data_is_buffered;
+    Endianness::Value m_file_endianness;
+}; // end of class MemoryMappedSerializer
+
+} // end of namespace Xrb
+
+#endif // !defined(_XRB_MEMORYMAPPEDSERIALIZER_HPP_)
+
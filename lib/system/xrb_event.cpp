@@ -17,7 +17,10 @@
 namespace Xrb
 {
 
-Event::~Event () { }
+Event::~Event ()
+{
+    ASSERT1(m_handler_link.m_prev_next == NULL && "a pending event must be scheduled for deletion before it's deleted");
+}
 
 std::string const &Event::Name (EventType const event_type)
 {
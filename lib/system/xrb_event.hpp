@@ -13,6 +13,7 @@
 
 #include "xrb.hpp"
 
+#include "xrb_eventpool.hpp"
 #include "xrb_key.hpp"
 #include "xrb_screencoord.hpp"
 
@@ -47,6 +48,8 @@ namespace Xrb {
 /// will handle all tracking of the "current time", and all necessary queries
 /// for the current time will be made to the GameLoop class, so that it doesn't
 /// need to be derived from some other object (like a FrameHandler).
+///
+/// Events (of every subclass) are allocated from EventPool instead of the global heap.
 class Event
 {
 public:
@@ -103,6 +106,11 @@ public:
     /// pure virtual in order to make Event pure virtual.  A non-subclassed Event cannot be created.
     virtual ~Event () = 0;
 
+    /// Allocates events from EventPool.
+    static void *operator new (std::size_t size) { return EventPool::Allocate(size); }
+    /// Returns events to EventPool (size is that of the event's actual subclass, since the destructor is virtual).
+    static void operator delete (void *event, std::size_t size) { EventPool::Deallocate(event, size); }
+
     /// Returns the textual representation of the event type.
     static std::string const &Name (EventType event_type);
     /// Returns the event's timestamp.
@@ -150,12 +158,58 @@ private:
 
     void SetID (Uint32 id) const { m_id = id; }
 
-    void ScheduleForDeletion () const { m_is_scheduled_for_deletion = true; }
+    // an event which is scheduled for deletion will never be processed, so
+    // it's also taken out of its EventHandler's pending events.
+    void ScheduleForDeletion () const
+    {
+        m_is_scheduled_for_deletion = true;
+        UnlinkFromEventHandler();
+    }
+
+    // puts this event at the front of an EventHandler's list of pending
+    // events (the list's head is first_pending_event).
+    void LinkToEventHandler (Event const *&first_pending_event) const
+    {
+        ASSERT1(m_handler_link.m_prev_next == NULL && "already linked");
+        m_handler_link.m_next = first_pending_event;
+        m_handler_link.m_prev_next = &first_pending_event;
+        if (first_pending_event != NULL)
+            first_pending_event->m_handler_link.m_prev_next = &m_handler_link.m_next;
+        first_pending_event = this;
+    }
+    // takes this event out of its EventHandler's list (if it's in one)
+    void UnlinkFromEventHandler () const
+    {
+        if (m_handler_link.m_prev_next == NULL)
+            return;
+        *m_handler_link.m_prev_next = m_handler_link.m_next;
+        if (m_handler_link.m_next != NULL)
+            m_handler_link.m_next->m_handler_link.m_prev_next = m_handler_link.m_prev_next;
+        m_handler_link.m_next = NULL;
+        m_handler_link.m_prev_next = NULL;
+    }
+
+    // the links of an EventHandler's intrusive, doubly-linked list of pending
+    // events, which EventQueue uses so that deleting an EventHandler's events
+    // doesn't have to search the whole queue.  copies of an event are never
+    // in the list.
+    struct HandlerLink
+    {
+        Event const *m_next;
+        // the pointer which points to this event (the previous event's m_next
+        // or the head of the list).  NULL iff this event isn't in a list.
+        Event const **m_prev_next;
+
+        HandlerLink () : m_next(NULL), m_prev_next(NULL) { }
+        HandlerLink (HandlerLink const &) : m_next(NULL), m_prev_next(NULL) { }
+        void operator = (HandlerLink const &) { }
+    }; // end of struct Event::HandlerLink
 
     Time m_time;
     EventType m_event_type;
     mutable Uint32 m_id;
     mutable bool m_is_scheduled_for_deletion;
+    mutable HandlerLink m_handler_link;
 
     friend class EventQueue;
 }; // end of class Event
@@ -22,6 +22,7 @@ EventHandler::EventHandler (EventQueue *owner_event_queue)
     m_most_recent_event_time = Time::ms_negative_infinity;
     m_current_event_time = Time::ms_negative_infinity;
     m_allow_event_time_access = false;
+    m_first_pending_event = NULL;
 }
 
 EventHandler::~EventHandler ()
@@ -31,6 +32,8 @@ EventHandler::~EventHandler ()
         m_owner_event_queue->DeleteEventsBelongingToHandler(*this);
         m_owner_event_queue = NULL;
     }
+    // otherwise the pending events would be processed by a deleted EventHandler
+    ASSERT1(m_first_pending_event == NULL && "events are pending for an EventHandler with no owner EventQueue");
 
     m_is_blocking_events = true;
 }
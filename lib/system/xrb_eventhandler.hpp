@@ -85,6 +85,11 @@ private:
     Time m_current_event_time;
     // indicates if EventTime() can be called or not.
     bool m_allow_event_time_access;
+    // the head of the list of this EventHandler's events which are pending in
+    // an EventQueue (see Event::LinkToEventHandler).
+    Event const *m_first_pending_event;
+
+    friend class EventQueue;
 }; // end of class EventHandler
 
 } // end of namespace Xrb
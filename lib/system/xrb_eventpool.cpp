@@ -0,0 +1,93 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_eventpool.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "xrb_eventpool.hpp"
+
+#include <cstring>
+#include <new>
+
+namespace Xrb
+{
+
+EventPool::FreeBlock *EventPool::ms_free_list[SIZE_CLASS_COUNT];
+EventPool::FreeBlock *EventPool::ms_chunk_list;
+EventPool::Statistics EventPool::ms_statistics;
+
+void *EventPool::Allocate (std::size_t size)
+{
+    ASSERT1(size > 0);
+    if (size > MAX_BLOCK_SIZE)
+    {
+        ++ms_statistics.m_oversize_allocation_count;
+        return ::operator new(size);
+    }
+
+    Uint32 size_class = SizeClass(size);
+    ASSERT1(size_class < SIZE_CLASS_COUNT);
+    if (ms_free_list[size_class] == NULL)
+        AllocateChunk(size_class);
+
+    FreeBlock *block = ms_free_list[size_class];
+    ASSERT1(block != NULL);
+    ms_free_list[size_class] = block->m_next;
+
+    ++ms_statistics.m_pooled_allocation_count;
+    ++ms_statistics.m_blocks_in_use;
+    if (ms_statistics.m_peak_blocks_in_use < ms_statistics.m_blocks_in_use)
+        ms_statistics.m_peak_blocks_in_use = ms_statistics.m_blocks_in_use;
+    return block;
+}
+
+void EventPool::Deallocate (void *block, std::size_t size)
+{
+    if (block == NULL)
+        return;
+
+    if (size > MAX_BLOCK_SIZE)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    Uint32 size_class = SizeClass(size);
+    ASSERT1(size_class < SIZE_CLASS_COUNT);
+    ASSERT1(ms_statistics.m_blocks_in_use > 0);
+    // scribble over the freed event so that using it after deletion is
+    // more likely to be noticed.
+    DEBUG2_CODE(memset(block, 0xDD, (size_class + 1) * GRANULARITY));
+
+    FreeBlock *free_block = static_cast<FreeBlock *>(block);
+    free_block->m_next = ms_free_list[size_class];
+    ms_free_list[size_class] = free_block;
+    --ms_statistics.m_blocks_in_use;
+}
+
+void EventPool::AllocateChunk (Uint32 size_class)
+{
+    ASSERT1(size_class < SIZE_CLASS_COUNT);
+    ASSERT1(ms_free_list[size_class] == NULL);
+
+    // the first GRANULARITY bytes of the chunk link it into ms_chunk_list,
+    // and the rest is BLOCKS_PER_CHUNK blocks.
+    std::size_t block_size = (size_class + 1) * GRANULARITY;
+    Uint8 *chunk = static_cast<Uint8 *>(::operator new(GRANULARITY + BLOCKS_PER_CHUNK * block_size));
+    reinterpret_cast<FreeBlock *>(chunk)->m_next = ms_chunk_list;
+    ms_chunk_list = reinterpret_cast<FreeBlock *>(chunk);
+    ++ms_statistics.m_chunk_allocation_count;
+
+    // link the blocks in address order
+    Uint8 *block = chunk + GRANULARITY;
+    for (Uint32 i = 0; i < BLOCKS_PER_CHUNK - 1; ++i, block += block_size)
+        reinterpret_cast<FreeBlock *>(block)->m_next = reinterpret_cast<FreeBlock *>(block + block_size);
+    reinterpret_cast<FreeBlock *>(block)->m_next = NULL;
+    ms_free_list[size_class] = reinterpret_cast<FreeBlock *>(chunk + GRANULARITY);
+}
+
+} // end of namespace Xrb
@@ -0,0 +1,94 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_eventpool.hpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#if !defined(_XRB_EVENTPOOL_HPP_)
+#define _XRB_EVENTPOOL_HPP_
+
+#include "xrb.hpp"
+
+#include <cstddef>
+
+namespace Xrb
+{
+
+/// @brief The allocator used by Event's operator new and operator delete.
+/// @details Events are small, short-lived and (during mouse motion and joystick floods) created
+/// by the thousand every second, so instead of using the global heap, each Event subclass's
+/// objects are allocated from a free list of blocks of its size (rounded up to a multiple of
+/// GRANULARITY).  Freed blocks go back on their free list, and the free lists are refilled a
+/// chunk of BLOCKS_PER_CHUNK blocks at a time, so once the pool has grown to cover the most
+/// events that are ever alive at once, creating and deleting events doesn't touch the heap.
+/// The chunks are kept for the life of the program.  Events larger than MAX_BLOCK_SIZE are
+/// allocated from the heap as usual.
+///
+/// EventPool isn't thread-safe -- events must only be created and deleted in the main thread
+/// (which is already the case, since EventQueue and EventHandler aren't thread-safe either).
+class EventPool
+{
+public:
+
+    enum
+    {
+        /// Block sizes are multiples of this (which is also the alignment of every block).
+        GRANULARITY = 8,
+        /// The largest block size (larger objects are allocated from the heap).
+        MAX_BLOCK_SIZE = 256,
+        /// The number of blocks each heap allocation for a free list provides.
+        BLOCKS_PER_CHUNK = 64
+    };
+
+    /// Allocation counters, for profiling.  All counts are since the program began.
+    struct Statistics
+    {
+        /// The number of allocations served from the free lists.
+        Uint32 m_pooled_allocation_count;
+        /// The number of chunks allocated from the heap for the free lists.
+        Uint32 m_chunk_allocation_count;
+        /// The number of allocations too large for the pool (which go to the heap).
+        Uint32 m_oversize_allocation_count;
+        /// The number of pooled blocks currently in use.
+        Uint32 m_blocks_in_use;
+        /// The largest m_blocks_in_use has been.
+        Uint32 m_peak_blocks_in_use;
+    }; // end of struct EventPool::Statistics
+
+    /// Returns a block of at least the given size.  Never returns NULL.
+    static void *Allocate (std::size_t size);
+    /// Returns a block from Allocate to the pool.  size must be the size it was allocated with.
+    static void Deallocate (void *block, std::size_t size);
+
+    static Statistics const &GetStatistics () { return ms_statistics; }
+
+private:
+
+    enum { SIZE_CLASS_COUNT = MAX_BLOCK_SIZE / GRANULARITY };
+
+    // blocks on a free list are used to store the free list link
+    struct FreeBlock
+    {
+        FreeBlock *m_next;
+    }; // end of struct EventPool::FreeBlock
+
+    static Uint32 SizeClass (std::size_t size) { return (size + GRANULARITY - 1) / GRANULARITY - 1; }
+    // allocates a chunk for the given size class and puts its blocks on the free list
+    static void AllocateChunk (Uint32 size_class);
+
+    // these are zero-initialized before any static constructors run, so
+    // events may be created during static initialization.
+    static FreeBlock *ms_free_list[SIZE_CLASS_COUNT];
+    // the chunks (linked through their first block) so they stay reachable
+    static FreeBlock *ms_chunk_list;
+    static Statistics ms_statistics;
+}; // end of class EventPool
+
+} // end of namespace Xrb
+
+#endif // !defined(_XRB_EVENTPOOL_HPP_)
+
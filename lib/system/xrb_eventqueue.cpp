@@ -10,6 +10,8 @@
 
 #include "xrb_eventqueue.hpp"
 
+#include <algorithm>
+
 #include "xrb_event.hpp"
 #include "xrb_eventhandler.hpp"
 
@@ -19,36 +21,51 @@ namespace Xrb {
 // EventQueue
 // ///////////////////////////////////////////////////////////////////////////
 
+Float const EventQueue::ms_ticks_per_second = 64.0f;
+
 EventQueue::EventQueue ()
     :
     FrameHandler()
 {
+    m_current_tick = 0;
+    m_wheel_event_count = 0;
     m_current_event_id = 0;
 }
 
 EventQueue::~EventQueue ()
 {
-    // make sure the buffered events are added into the main queue
-    EnqueueBufferedEvents();
+    ASSERT1(m_due.empty());
 
-    // delete all unprocessed events
-    for (TimeOrderedEventBindingSet::iterator it = m_time_ordered_event_queue.begin(), it_end = m_time_ordered_event_queue.end();
-         it != it_end;
-         ++it)
+    // delete all unprocessed events (scheduling them for deletion takes them
+    // out of their EventHandlers' lists of pending events).
+    for (Uint32 i = 0; i < SLOT_COUNT; ++i)
     {
-        Event const *event = it->GetEvent();
-        ASSERT1(event != NULL);
-        Delete(event);
+        for (EventBindingVector::iterator it = m_slot[i].m_binding.begin(), it_end = m_slot[i].m_binding.end(); it != it_end; ++it)
+        {
+            it->GetEvent()->ScheduleForDeletion();
+            delete it->GetEvent();
+        }
+        m_slot[i].m_binding.clear();
     }
-
-    // clear the time-ordered event queue
-    m_time_ordered_event_queue.clear();
+    for (EventBindingVector::iterator it = m_overflow.begin(), it_end = m_overflow.end(); it != it_end; ++it)
+    {
+        it->GetEvent()->ScheduleForDeletion();
+        delete it->GetEvent();
+    }
+    m_overflow.clear();
+    for (EventBindingVector::iterator it = m_buffered.begin(), it_end = m_buffered.end(); it != it_end; ++it)
+    {
+        it->GetEvent()->ScheduleForDeletion();
+        delete it->GetEvent();
+    }
+    m_buffered.clear();
 }
 
 void EventQueue::EnqueueEvent (EventHandler &event_handler, Event const *event)
 {
     ASSERT1(event != NULL);
     ASSERT1(event_handler.MostRecentEventTime() <= event->GetTime());
+    ASSERT1(event->GetTime().IsValid());
 
     // this call makes sure that we don't overflow the IDs, which is essential
     // for proper ordering of events inside the queue.
@@ -57,44 +74,37 @@ void EventQueue::EnqueueEvent (EventHandler &event_handler, Event const *event)
     // set the given event's ID to the current ID and increment the current ID
     event->SetID(m_current_event_id++);
 
-    // insert the bound event and eventhandler into the secondary queue, which
-    // will be inserted into the main queues before processing events
-    EventBinding event_binding(&event_handler, event);
-    m_buffered_time_ordered_event_queue.insert(event_binding);
+    // add the bound event and eventhandler to the buffered events, which
+    // will be put in the wheel before processing events
+    m_buffered.push_back(EventBinding(&event_handler, event));
+    // and to the event handler's list of pending events
+    event->LinkToEventHandler(event_handler.m_first_pending_event);
 }
 
 void EventQueue::DeleteEventsBelongingToHandler (EventHandler &event_handler)
 {
-    for (TimeOrderedEventBindingSet::iterator it = m_time_ordered_event_queue.begin(), it_end = m_time_ordered_event_queue.end();
-         it != it_end;
-         ++it)
-    {
-        if (!it->GetEvent()->IsScheduledForDeletion())
-            if (it->GetEventHandler() == &event_handler)
-                it->GetEvent()->ScheduleForDeletion();
-    }
+    // scheduling an event for deletion takes it out of the list
+    while (event_handler.m_first_pending_event != NULL)
+        event_handler.m_first_pending_event->ScheduleForDeletion();
 }
 
 void EventQueue::ScheduleMatchingEventsForDeletion (bool (*EventMatchingFunction)(Event const &))
 {
-    // check all enqueued events against the given event-matching function.
-    for (TimeOrderedEventBindingSet::iterator it = m_time_ordered_event_queue.begin(), it_end = m_time_ordered_event_queue.end();
-         it != it_end;
-         ++it)
-    {
-        ASSERT1(it->GetEvent() != NULL);
-        Event const &event = *it->GetEvent();
-        // only check events that aren't already scheduled for deletion
-        if (!event.IsScheduledForDeletion())
-            // if the function indicates a match, schedule the event for deletion
-            if (EventMatchingFunction(event))
-                event.ScheduleForDeletion();
-    }
+    MatchEvent matching = { EventMatchingFunction };
+    ScheduleMatchingEventBindingsForDeletion(matching);
+}
+
+void EventQueue::ScheduleMatchingEventsForDeletion (
+    EventHandler &event_handler,
+    bool (*EventMatchingFunction)(Event const &))
+{
+    MatchEvent matching = { EventMatchingFunction };
+    ScheduleMatchingHandlerEventsForDeletion(event_handler, matching);
 }
 
 void EventQueue::HandleFrame ()
 {
-    // make sure the buffered events are added into the main queue
+    // make sure the buffered events are in the wheel
     EnqueueBufferedEvents();
 
     // this event is used to get the last event which should be processed
@@ -102,49 +112,85 @@ void EventQueue::HandleFrame ()
     event_limit.SetID(MaxEventID());
     EventBinding binding_limit(NULL, &event_limit);
 
-    // get the range of events to be processed, and loop through,
-    // processing them and scheduling each for deletion
+    // move the events to be processed (in order) into m_due.  every slot
+    // before the frame time's tick is processed entirely.
+    ASSERT1(m_due.empty());
+    Uint32 frame_tick = Tick(FrameTime());
+    while (true)
     {
-        TimeOrderedEventBindingSet::iterator it_begin = m_time_ordered_event_queue.begin();
-        TimeOrderedEventBindingSet::iterator it_end = m_time_ordered_event_queue.upper_bound(binding_limit);
+        Slot &slot = m_slot[m_current_tick % SLOT_COUNT];
+        if (!slot.m_is_sorted)
+        {
+            std::sort(slot.m_binding.begin(), slot.m_binding.end(), OrderEventBindingsByEventTime());
+            slot.m_is_sorted = true;
+        }
 
-        // process each event and schedule it for deletion.
-        for (TimeOrderedEventBindingSet::iterator it = it_begin; it != it_end; ++it)
+        if (m_current_tick < frame_tick)
+        {
+            m_due.insert(m_due.end(), slot.m_binding.begin(), slot.m_binding.end());
+            ASSERT1(m_wheel_event_count >= slot.m_binding.size());
+            m_wheel_event_count -= slot.m_binding.size();
+            slot.m_binding.clear();
+            // if the wheel is empty, skip straight to the frame's tick.
+            AdvanceCurrentTick(m_wheel_event_count == 0 ? frame_tick : m_current_tick + 1);
+        }
+        else
         {
-            ASSERT1(it->GetEvent() != NULL);
-            // don't process the event if it's already scheduled for deletion
-            if (!it->GetEvent()->IsScheduledForDeletion())
-            {
-                // schedule the event for deletion first, so if it ever checks
-                // for scheduled-to-be-deleted events during its processing,
-                // it won't end up in a recursive hell.
-                it->GetEventHandler()->ProcessEvent(*it->GetEvent());
-                it->GetEvent()->ScheduleForDeletion();
-            }
+            // only the events up to and including the frame time
+            EventBindingVector::iterator it_end = std::upper_bound(slot.m_binding.begin(), slot.m_binding.end(), binding_limit, OrderEventBindingsByEventTime());
+            m_due.insert(m_due.end(), slot.m_binding.begin(), it_end);
+            ASSERT1(m_wheel_event_count >= Uint32(it_end - slot.m_binding.begin()));
+            m_wheel_event_count -= it_end - slot.m_binding.begin();
+            slot.m_binding.erase(slot.m_binding.begin(), it_end);
+            break;
         }
+    }
 
-        // delete each event.  this must be done separately from the above
-        // for-loop, otherwise calls to ScheduleMatchingEventsForDeletion
-        // during processing of each event will potentially make invalid reads
-        // to the deleted events.
-        for (TimeOrderedEventBindingSet::iterator it = it_begin; it != it_end; ++it)
+    // process each event and schedule it for deletion.  the events stay in
+    // m_due until they're all processed, so that ScheduleMatchingEventsForDeletion
+    // and DeleteEventsBelongingToHandler (called during processing) can
+    // prevent the rest from being processed.
+    for (Uint32 i = 0; i < m_due.size(); ++i)
+    {
+        EventBinding const &binding = m_due[i];
+        ASSERT1(binding.GetEvent() != NULL);
+        // don't process the event if it's already scheduled for deletion
+        if (!binding.GetEvent()->IsScheduledForDeletion())
         {
-            ASSERT1(it->GetEvent()->IsScheduledForDeletion());
-            delete it->GetEvent();            
+            binding.GetEventHandler()->ProcessEvent(*binding.GetEvent());
+            binding.GetEvent()->ScheduleForDeletion();
         }
-        
-        // clear the range of processed events from the time-ordered event queue
-        m_time_ordered_event_queue.erase(it_begin, it_end);
     }
+
+    // delete each event.  this must be done separately from the above
+    // for-loop, otherwise calls to ScheduleMatchingEventsForDeletion
+    // during processing of each event will potentially make invalid reads
+    // to the deleted events.
+    for (EventBindingVector::iterator it = m_due.begin(), it_end = m_due.end(); it != it_end; ++it)
+    {
+        ASSERT1(it->GetEvent()->IsScheduledForDeletion());
+        delete it->GetEvent();
+    }
+    m_due.clear();
+}
+
+Uint32 EventQueue::Tick (Time time)
+{
+    ASSERT1(time.IsValid());
+    double tick = time.AsDouble() * ms_ticks_per_second;
+    if (tick <= 0.0)
+        return 0;
+    else if (tick >= double(UINT32_UPPER_BOUND))
+        return UINT32_UPPER_BOUND; // this includes positive infinity
+    else
+        return Uint32(tick);
 }
 
 void EventQueue::EnqueueBufferedEvents ()
 {
-    // insert the secondary queue into the main queue, so we only
-    // have to worry about the main queue
-    m_time_ordered_event_queue.insert(m_buffered_time_ordered_event_queue.begin(), m_buffered_time_ordered_event_queue.end());
-    // clear the buffered event queue
-    m_buffered_time_ordered_event_queue.clear();
+    for (EventBindingVector::iterator it = m_buffered.begin(), it_end = m_buffered.end(); it != it_end; ++it)
+        InsertIntoWheel(*it);
+    m_buffered.clear();
 }
 
 void EventQueue::CompactEventIDs ()
@@ -153,16 +199,16 @@ void EventQueue::CompactEventIDs ()
     // the current ID is at the maximum number
     if (m_current_event_id == MaxEventID())
     {
-        // make sure the buffered events are added to the main queue
+        // make sure the buffered events are in the wheel
         EnqueueBufferedEvents();
-        // at this point, the events in the main event queue are perfectly
-        // ordered, which means that we can assign incremental IDs to the
-        // events in order and the queue's ordering won't change.  set
-        // the current ID to zero and start assigning
+        // put all the pending events in order, and then assign incremental
+        // IDs to them in that order, so that the ordering won't change.
+        EventBindingVector pending(m_overflow);
+        for (Uint32 i = 0; i < SLOT_COUNT; ++i)
+            pending.insert(pending.end(), m_slot[i].m_binding.begin(), m_slot[i].m_binding.end());
+        std::sort(pending.begin(), pending.end(), OrderEventBindingsByEventTime());
         m_current_event_id = 0;
-        for (TimeOrderedEventBindingSet::iterator it = m_time_ordered_event_queue.begin(), it_end = m_time_ordered_event_queue.end();
-             it != it_end;
-             ++it)
+        for (EventBindingVector::iterator it = pending.begin(), it_end = pending.end(); it != it_end; ++it)
         {
             // set the event's ID
             it->GetEvent()->SetID(m_current_event_id++);
@@ -172,6 +218,40 @@ void EventQueue::CompactEventIDs ()
     }
 }
 
+void EventQueue::InsertIntoWheel (EventBinding const &binding)
+{
+    // events from before the current tick go in the current tick's slot
+    Uint32 tick = Max(Tick(binding.GetEvent()->GetTime()), m_current_tick);
+    if (tick - m_current_tick >= SLOT_COUNT)
+    {
+        m_overflow.push_back(binding);
+        return;
+    }
+
+    Slot &slot = m_slot[tick % SLOT_COUNT];
+    if (!slot.m_binding.empty() && OrderEventBindingsByEventTime()(binding, slot.m_binding.back()))
+        slot.m_is_sorted = false;
+    slot.m_binding.push_back(binding);
+    ++m_wheel_event_count;
+}
+
+void EventQueue::AdvanceCurrentTick (Uint32 tick)
+{
+    ASSERT1(tick >= m_current_tick);
+    bool wheel_has_come_around = tick / SLOT_COUNT != m_current_tick / SLOT_COUNT;
+    m_current_tick = tick;
+    // every overflow event is at least SLOT_COUNT ticks after the tick at
+    // which the wheel last came around, so the overflow only needs to be
+    // checked each time it comes around.
+    if (wheel_has_come_around && !m_overflow.empty())
+    {
+        EventBindingVector overflow;
+        overflow.swap(m_overflow);
+        for (EventBindingVector::iterator it = overflow.begin(), it_end = overflow.end(); it != it_end; ++it)
+            InsertIntoWheel(*it);
+    }
+}
+
 // ///////////////////////////////////////////////////////////////////////////
 // EventQueue::OrderEventBindingsByEventTime
 // ///////////////////////////////////////////////////////////////////////////
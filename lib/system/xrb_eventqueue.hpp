@@ -13,15 +13,14 @@
 
 #include "xrb.hpp"
 
-#include <set>
+#include <vector>
 
 #include "xrb_event.hpp"
+#include "xrb_eventhandler.hpp"
 #include "xrb_framehandler.hpp"
 
 namespace Xrb {
 
-class EventHandler;
-
 /// @brief Controls chronological queueing and processing of asynchronous events.
 /// @details Many EventHandler instances are "owned" by a single EventQueue.  The EventQueue receives orders to
 /// enqueue events for a particular EventHandler.  All events from all EventHandlers are enqueued chronologically
@@ -29,6 +28,12 @@ class EventHandler;
 /// passed to the EventQueue) is greater or equal to the event's scheduled processing time.
 ///
 /// When an EventHandler is deleted, all events that are enqueued for it are taken out of the queue and deleted.
+///
+/// The queue is a timing wheel -- time is divided into ticks (see ms_ticks_per_second), and each of the next
+/// SLOT_COUNT ticks has a slot holding the events which occur during it, so enqueueing an event is just appending
+/// it to its slot (events further in the future wait in an overflow list and are moved into the wheel as it comes
+/// around).  Each slot is sorted by event time and ID only when it is processed, so the events are still processed
+/// in exactly the same order as they would be in a single time-ordered queue.
 class EventQueue : public FrameHandler
 {
 public:
@@ -42,16 +47,20 @@ public:
     /// @note You shouldn't have to call this directly.  Use @ref Xrb::EventHandler::EnqueueEvent instead.
     void EnqueueEvent (EventHandler &event_handler, Event const *event);
     /// @brief Deletes events which belong to the given EventHandler
+    /// @details Each EventHandler keeps a list of its pending events, so this only takes as long as
+    /// the number of events pending for event_handler.
     /// @note You shouldn't have to call this directly.  It will be called automatically by EventHandler's destructor.
     void DeleteEventsBelongingToHandler (EventHandler &event_handler);
     /// @brief Deletes all queued events that return true when passed to the given event matching function.
     /// @param EventMatchingFunction A pointer to the matching function to use.
-    /// @details This is used to remove situation-specific sets of events.
+    /// @details This is used to remove situation-specific sets of events.  This includes events which were
+    /// enqueued earlier in the same frame (and so are still buffered) -- these used to be missed, and processed anyway.
     void ScheduleMatchingEventsForDeletion (bool (*EventMatchingFunction)(Event const &));
     /// @brief Deletes all queued events that return true when passed to the given event matching function.
     /// @param EventMatchingFunction A pointer to the matching function to use.
     /// @param parameter The parameter to pass to the matching function.
-    /// @details This is used to remove situation-specific sets of events.
+    /// @details This is used to remove situation-specific sets of events.  As with the above, this includes
+    /// events which were enqueued earlier in the same frame.
     ///
     /// The template parameter specifies the type of the single extra
     /// parameter of the event matching function (besides the Event itself).
@@ -63,14 +72,36 @@ public:
     /// @param EventMatchingFunction A pointer to the matching function to use.
     /// @param parameter1 The first parameter (of type Parameter1Type) to pass to the matching function.
     /// @param parameter2 The first parameter (of type Parameter2Type) to pass to the matching function.
-    /// @details This is used to remove situation-specific sets of events.  The template parameter specifies
-    /// the type of the two extra parameters of the event matching function (besides the Event itself).
+    /// @details This is used to remove situation-specific sets of events.  As with the above, this includes
+    /// events which were enqueued earlier in the same frame.  The template parameter specifies the type of
+    /// the two extra parameters of the event matching function (besides the Event itself).
+    template <typename Parameter1Type, typename Parameter2Type>
+    void ScheduleMatchingEventsForDeletion (
+        bool (*EventMatchingFunction)(Event const &, Parameter1Type, Parameter2Type),
+        Parameter1Type parameter1,
+        Parameter2Type parameter2);
+    /// @brief Deletes the given EventHandler's queued events that return true when passed to the given event matching function.
+    /// @details Like the above, except that only the events pending for event_handler are checked, so this only takes
+    /// as long as the number of them.  This is the one to use for cancelling an EventHandler's own events.
+    void ScheduleMatchingEventsForDeletion (
+        EventHandler &event_handler,
+        bool (*EventMatchingFunction)(Event const &));
+    /// @brief Deletes the given EventHandler's queued events that return true when passed to the given event matching function.
+    /// @details Like the above, except that only the events pending for event_handler are checked.
+    template <typename ParameterType>
+    void ScheduleMatchingEventsForDeletion (
+        EventHandler &event_handler,
+        bool (*EventMatchingFunction)(Event const &, ParameterType),
+        ParameterType parameter);
+    /// @brief Deletes the given EventHandler's queued events that return true when passed to the given event matching function.
+    /// @details Like the above, except that only the events pending for event_handler are checked.
     template <typename Parameter1Type, typename Parameter2Type>
     void ScheduleMatchingEventsForDeletion (
+        EventHandler &event_handler,
         bool (*EventMatchingFunction)(Event const &, Parameter1Type, Parameter2Type),
         Parameter1Type parameter1,
         Parameter2Type parameter2);
-        
+
 protected:
 
     /// Processes all events in the event queue with time less than or equal to the current frame time.
@@ -81,11 +112,6 @@ private:
     // the maximum ID number
     static Uint32 MaxEventID () { return UINT32_UPPER_BOUND; }
 
-    // stick the buffered event queue into the main event queue
-    void EnqueueBufferedEvents ();
-    // when m_current_id is
-    void CompactEventIDs ();
-
     // the EventBinding class is used to pair events with event handlers
     class EventBinding
     {
@@ -109,22 +135,93 @@ private:
         bool operator () (EventBinding const &left_operand, EventBinding const &right_operand) const;
     };
 
-    typedef std::multiset<EventBinding, OrderEventBindingsByEventTime> TimeOrderedEventBindingSet;
+    typedef std::vector<EventBinding> EventBindingVector;
+
+    // the events occurring during one tick of the timing wheel
+    struct Slot
+    {
+        EventBindingVector m_binding;
+        // true iff m_binding is ordered by OrderEventBindingsByEventTime
+        bool m_is_sorted;
+
+        Slot () : m_is_sorted(true) { }
+    }; // end of struct EventQueue::Slot
+
+    // the number of ticks the timing wheel covers (must be a power of 2)
+    enum { SLOT_COUNT = 1024 };
+
+    // matching functors for ScheduleMatchingEventBindingsForDeletion
+    struct MatchEvent
+    {
+        bool (*m_function)(Event const &);
+        bool operator () (Event const &event) const { return m_function(event); }
+    }; // end of struct EventQueue::MatchEvent
+    template <typename ParameterType>
+    struct MatchEvent1
+    {
+        bool (*m_function)(Event const &, ParameterType);
+        ParameterType m_parameter;
+        bool operator () (Event const &event) const { return m_function(event, m_parameter); }
+    }; // end of struct EventQueue::MatchEvent1
+    template <typename Parameter1Type, typename Parameter2Type>
+    struct MatchEvent2
+    {
+        bool (*m_function)(Event const &, Parameter1Type, Parameter2Type);
+        Parameter1Type m_parameter1;
+        Parameter2Type m_parameter2;
+        bool operator () (Event const &event) const { return m_function(event, m_parameter1, m_parameter2); }
+    }; // end of struct EventQueue::MatchEvent2
+
+    // returns the timing wheel tick that the given time falls in
+    static Uint32 Tick (Time time);
+
+    // stick the buffered events into the timing wheel (or overflow)
+    void EnqueueBufferedEvents ();
+    // when m_current_event_id is about to overflow, renumber the pending events
+    void CompactEventIDs ();
+    // puts the binding in the slot for its tick, or in m_overflow if its
+    // tick is too far in the future.
+    void InsertIntoWheel (EventBinding const &binding);
+    // moves the timing wheel forward to the given tick, moving the overflow
+    // events which now fit into the wheel.
+    void AdvanceCurrentTick (Uint32 tick);
+    // calls ScheduleForDeletion on each pending event (i.e. in the wheel, the
+    // overflow, the buffered events, and those being processed by
+    // HandleFrame) for which matching returns true.
+    template <typename Matching>
+    void ScheduleMatchingEventBindingsForDeletion (Matching const &matching);
+    template <typename Matching>
+    static void ScheduleMatchingEventBindingsForDeletion (EventBindingVector &binding_vector, Matching const &matching);
+    // calls ScheduleForDeletion on each of the given EventHandler's pending
+    // events for which matching returns true.
+    template <typename Matching>
+    static void ScheduleMatchingHandlerEventsForDeletion (EventHandler &event_handler, Matching const &matching);
+
+    // slot n holds the events whose tick is congruent to n mod SLOT_COUNT (and
+    // is within SLOT_COUNT of m_current_tick).  events from before the
+    // current tick go in the current tick's slot.
+    Slot m_slot[SLOT_COUNT];
+    // the tick that HandleFrame has processed up to (but not necessarily past)
+    Uint32 m_current_tick;
+    // the total number of events in m_slot
+    Uint32 m_wheel_event_count;
+    // the events that are too far in the future for the wheel, in no particular order
+    EventBindingVector m_overflow;
+    // events are put here (in no particular order) by EnqueueEvent, and are
+    // put in the wheel before HandleFrame does any processing.
+    EventBindingVector m_buffered;
+    // the events (in order) which HandleFrame is currently processing
+    EventBindingVector m_due;
 
-    // the time-ordered queue of events (ordered by time and then ID)
-    TimeOrderedEventBindingSet m_time_ordered_event_queue;
-    // secondary time-ordered event queue, which event bindings are inserted
-    // into before being added to the main event queue.  they will be inserted
-    // into the main event queue before ProcessQueue actually does any
-    // processing.
-    TimeOrderedEventBindingSet m_buffered_time_ordered_event_queue;
-    
     // the next available Event ID.  the event IDs are used to give a unique
     // ordering to the event queue.  the event queue is ordered primarily by
     // event time, but then secondarily by the ID (so that events with the same
     // time will be sorted in the order they were issued).
     Uint32 m_current_event_id;
 
+    // the number of timing wheel ticks per second of event time
+    static Float const ms_ticks_per_second;
+
 }; // end of class EventQueue
 
 template <typename ParameterType>
@@ -132,39 +229,81 @@ void EventQueue::ScheduleMatchingEventsForDeletion (
     bool (*EventMatchingFunction)(Event const &, ParameterType),
     ParameterType parameter)
 {
-    // check all enqueued events against the given event-matching function.
-    for (TimeOrderedEventBindingSet::iterator it = m_time_ordered_event_queue.begin(), it_end = m_time_ordered_event_queue.end();
-         it != it_end;
-         ++it)
-    {
-        ASSERT1(it->GetEvent() != NULL);
-        Event const &event = *it->GetEvent();
-        // only check events that aren't already scheduled for deletion
-        if (!event.IsScheduledForDeletion())
-            // if the function indicates a match, schedule the event for deletion
-            if (EventMatchingFunction(event, parameter))
-                event.ScheduleForDeletion();
-    }
+    MatchEvent1<ParameterType> matching = { EventMatchingFunction, parameter };
+    ScheduleMatchingEventBindingsForDeletion(matching);
+}
+
+template <typename Parameter1Type, typename Parameter2Type>
+void EventQueue::ScheduleMatchingEventsForDeletion (
+    bool (*EventMatchingFunction)(Event const &, Parameter1Type, Parameter2Type),
+    Parameter1Type parameter1,
+    Parameter2Type parameter2)
+{
+    MatchEvent2<Parameter1Type, Parameter2Type> matching = { EventMatchingFunction, parameter1, parameter2 };
+    ScheduleMatchingEventBindingsForDeletion(matching);
+}
+
+template <typename ParameterType>
+void EventQueue::ScheduleMatchingEventsForDeletion (
+    EventHandler &event_handler,
+    bool (*EventMatchingFunction)(Event const &, ParameterType),
+    ParameterType parameter)
+{
+    MatchEvent1<ParameterType> matching = { EventMatchingFunction, parameter };
+    ScheduleMatchingHandlerEventsForDeletion(event_handler, matching);
 }
 
 template <typename Parameter1Type, typename Parameter2Type>
 void EventQueue::ScheduleMatchingEventsForDeletion (
+    EventHandler &event_handler,
     bool (*EventMatchingFunction)(Event const &, Parameter1Type, Parameter2Type),
     Parameter1Type parameter1,
     Parameter2Type parameter2)
 {
-    // check all enqueued events against the given event-matching function.
-    for (TimeOrderedEventBindingSet::iterator it = m_time_ordered_event_queue.begin(), it_end = m_time_ordered_event_queue.end();
+    MatchEvent2<Parameter1Type, Parameter2Type> matching = { EventMatchingFunction, parameter1, parameter2 };
+    ScheduleMatchingHandlerEventsForDeletion(event_handler, matching);
+}
+
+template <typename Matching>
+void EventQueue::ScheduleMatchingEventBindingsForDeletion (Matching const &matching)
+{
+    // check all pending events against the given matching functor.
+    for (Uint32 i = 0; i < SLOT_COUNT; ++i)
+        ScheduleMatchingEventBindingsForDeletion(m_slot[i].m_binding, matching);
+    ScheduleMatchingEventBindingsForDeletion(m_overflow, matching);
+    ScheduleMatchingEventBindingsForDeletion(m_buffered, matching);
+    ScheduleMatchingEventBindingsForDeletion(m_due, matching);
+}
+
+template <typename Matching>
+void EventQueue::ScheduleMatchingEventBindingsForDeletion (EventBindingVector &binding_vector, Matching const &matching)
+{
+    for (EventBindingVector::iterator it = binding_vector.begin(), it_end = binding_vector.end();
          it != it_end;
          ++it)
     {
         ASSERT1(it->GetEvent() != NULL);
-        Event const &event = *it->GetEvent();
         // only check events that aren't already scheduled for deletion
-        if (!event.IsScheduledForDeletion())
-            // if the function indicates a match, schedule the event for deletion
-            if (EventMatchingFunction(event, parameter1, parameter2))
-                event.ScheduleForDeletion();
+        if (!it->GetEvent()->IsScheduledForDeletion())
+            // if the functor indicates a match, schedule the event for deletion
+            if (matching(*it->GetEvent()))
+                it->GetEvent()->ScheduleForDeletion();
+    }
+}
+
+template <typename Matching>
+void EventQueue::ScheduleMatchingHandlerEventsForDeletion (EventHandler &event_handler, Matching const &matching)
+{
+    // the events in the list are exactly those which are pending and not
+    // scheduled for deletion (scheduling one for deletion unlinks it).
+    Event const *event = event_handler.m_first_pending_event;
+    while (event != NULL)
+    {
+        Event const *next = event->m_handler_link.m_next;
+        ASSERT1(!event->IsScheduledForDeletion());
+        if (matching(*event))
+            event->ScheduleForDeletion();
+        event = next;
     }
 }
 
@@ -57,6 +57,14 @@ namespace Xrb {
 /// Again, it is recommended to specify the template type when using
 /// ReadAggregate and WriteAggregate, as above with Read and Write.
 ///
+/// ReadArray and WriteArray (and ReadSizeAndAllocatedArray and
+/// WriteSizeAndArray) transfer the whole array as a single block of words.
+/// Aggregates which are serialized as just their words, in memory order
+/// (e.g. Vector<T,dimension>), can also be used as their array element type
+/// by defining a partial template specialization of the ArrayElement struct
+/// (see @ref xrb_vector.hpp ), so that an array of them is a single block
+/// instead of a ReadAggregate/WriteAggregate call per element.
+///
 /// Instances of the @ref Exception class will be thrown to indicate error.
 class Serializer
 {
@@ -165,12 +173,14 @@ public:
 
     /// @brief Reads an array of the specified length from the Serializer.
     /// @details The length of the array is known to the program and is not read from the Serializer -- compare with @c ReadSizeAndAllocateArray.
+    /// The array is read using a single call to ReadRawWords (see @c ArrayElement ).
     /// @param dest Must point to an array holding at least @c length elements.
     /// @param length Specifies the number of words to read into the array pointed to by @c dest.
     template <typename WordType> void ReadArray (WordType *dest, Uint32 length);
     // source must point to an array holding at least sizeof(WordType)*length bytes.
     /// @brief Writes an array of the specified length to the Serializer.
     /// @details The length of the array is known to the program and is not written to the Serializer -- compare with @c WriteSizeAndArray.
+    /// The array is written using a single call to WriteRawWords (see @c ArrayElement ).
     /// @param source Must point to an array holding at least @c length elements.
     /// @param length Specifies the number of words to write from the array pointed to by @c source.
     template <typename WordType> void WriteArray (WordType const *source, Uint32 length);
@@ -210,6 +220,16 @@ struct Aggregate
     static void Write (Serializer &serializer, T const &source);
 };
 
+/// @brief Helper for Serializer::ReadArray and Serializer::WriteArray, giving the words each array element is made of.
+/// @details Each element is @c WORD_COUNT words of type @c WordType, which must be exactly the memory layout
+/// of the element (this is checked at compile time).  By default, the element is itself a word.
+template <typename T>
+struct ArrayElement
+{
+    typedef T WordType;
+    enum { WORD_COUNT = 1 };
+};
+
 // ///////////////////////////////////////////////////////////////////////////
 // template function definitions
 // ///////////////////////////////////////////////////////////////////////////
@@ -251,14 +271,18 @@ void Serializer::WriteSizeAndArray (WordType const *source, Uint32 length, Uint3
 template <typename WordType>
 void Serializer::ReadArray (WordType *dest, Uint32 length)
 {
+    typedef ArrayElement<WordType> Element;
+    CODE_SCOPE_COMPILE_TIME_ASSERT(sizeof(WordType) == Element::WORD_COUNT*sizeof(typename Element::WordType))
     ASSERT1(dest != NULL);
-    ReadRawWords(reinterpret_cast<Uint8 *>(dest), sizeof(WordType), length);
+    ReadRawWords(reinterpret_cast<Uint8 *>(dest), sizeof(typename Element::WordType), Element::WORD_COUNT*length);
 }
 template <typename WordType>
 void Serializer::WriteArray (WordType const *source, Uint32 length)
 {
+    typedef ArrayElement<WordType> Element;
+    CODE_SCOPE_COMPILE_TIME_ASSERT(sizeof(WordType) == Element::WORD_COUNT*sizeof(typename Element::WordType))
     ASSERT1(source != NULL);
-    WriteRawWords(reinterpret_cast<Uint8 const *>(source), sizeof(WordType), length);
+    WriteRawWords(reinterpret_cast<Uint8 const *>(source), sizeof(typename Element::WordType), Element::WORD_COUNT*length);
 }
 
 template <typename ScalarType>
@@ -0,0 +1,155 @@
+// ///////////////////////////////////////////////////////////////////////////
+// xrb_endian.cpp by agent, created 2026/10/17
+// ///////////////////////////////////////////////////////////////////////////
+// Unless a different license was explicitly granted in writing by the
+// copyright holder (Victor Dods), this software is freely distributable under
+// the terms of the GNU General Public License, version 2.  Any works deriving
+// from this work must also be released under the GNU GPL.  See the included
+// file LICENSE for details.
+// ///////////////////////////////////////////////////////////////////////////
+
+#include "xrb_endian.hpp"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Xrb {
+
+namespace {
+
+// the plain versions, used for whatever the vector versions below don't
+// cover.  the words are loaded and stored with memcpy since the array
+// needn't be aligned, and the shifts are recognized by the compiler as
+// byte-swap instructions.
+template <Uint32 word_size>
+void SwitchByteOrderOfArray_Scalar (Uint8 *array, Uint32 word_count);
+
+inline Uint32 SwitchedUint32 (Uint32 word)
+{
+    return (word >> 24) | ((word >> 8) & 0x0000FF00) | ((word << 8) & 0x00FF0000) | (word << 24);
+}
+
+template <>
+void SwitchByteOrderOfArray_Scalar<2> (Uint8 *array, Uint32 word_count)
+{
+    for (Uint32 i = 0; i < word_count; ++i, array += 2)
+    {
+        Uint16 word;
+        memcpy(&word, array, 2);
+        word = Uint16((word >> 8) | (word << 8));
+        memcpy(array, &word, 2);
+    }
+}
+
+template <>
+void SwitchByteOrderOfArray_Scalar<4> (Uint8 *array, Uint32 word_count)
+{
+    for (Uint32 i = 0; i < word_count; ++i, array += 4)
+    {
+        Uint32 word;
+        memcpy(&word, array, 4);
+        word = SwitchedUint32(word);
+        memcpy(array, &word, 4);
+    }
+}
+
+// there's no guaranteed 64-bit integer type, so the halves are switched
+// and then exchanged.
+template <>
+void SwitchByteOrderOfArray_Scalar<8> (Uint8 *array, Uint32 word_count)
+{
+    for (Uint32 i = 0; i < word_count; ++i, array += 8)
+    {
+        Uint32 half[2];
+        memcpy(half, array, 8);
+        Uint32 temp = SwitchedUint32(half[0]);
+        half[0] = SwitchedUint32(half[1]);
+        half[1] = temp;
+        memcpy(array, half, 8);
+    }
+}
+
+#if defined(__SSE2__)
+// reverses the bytes of each word_size-byte word in the vector.  SSE2 has
+// no byte shuffle, so the bytes of each 16-bit lane are exchanged with
+// shifts, and then the 16-bit lanes of each word are reversed.
+template <Uint32 word_size>
+__m128i SwitchedWords_Sse2 (__m128i words);
+
+template <>
+inline __m128i SwitchedWords_Sse2<2> (__m128i words)
+{
+    return _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8));
+}
+
+template <>
+inline __m128i SwitchedWords_Sse2<4> (__m128i words)
+{
+    words = SwitchedWords_Sse2<2>(words);
+    words = _mm_shufflelo_epi16(words, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_shufflehi_epi16(words, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+template <>
+inline __m128i SwitchedWords_Sse2<8> (__m128i words)
+{
+    words = SwitchedWords_Sse2<2>(words);
+    words = _mm_shufflelo_epi16(words, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shufflehi_epi16(words, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+// 32 bytes per iteration.  returns the number of words switched.
+template <Uint32 word_size>
+Uint32 SwitchByteOrderOfArray_Sse2 (Uint8 *array, Uint32 word_count)
+{
+    Uint32 const words_per_iteration = 32 / word_size;
+    Uint32 i = 0;
+    for ( ; i + words_per_iteration <= word_count; i += words_per_iteration, array += 32)
+    {
+        __m128i words0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(array));
+        __m128i words1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(array + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(array), SwitchedWords_Sse2<word_size>(words0));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(array + 16), SwitchedWords_Sse2<word_size>(words1));
+    }
+    return i;
+}
+#endif // defined(__SSE2__)
+
+template <Uint32 word_size>
+void SwitchByteOrderOfArray (Uint8 *array, Uint32 word_count)
+{
+    Uint32 i = 0;
+#if defined(__SSE2__)
+    i = SwitchByteOrderOfArray_Sse2<word_size>(array, word_count);
+#endif
+    SwitchByteOrderOfArray_Scalar<word_size>(array + i*word_size, word_count - i);
+}
+
+} // end of anonymous namespace
+
+void SwitchByteOrder (Uint8 *array, Uint32 word_size, Uint32 word_count)
+{
+    ASSERT1(array != NULL);
+    ASSERT1(word_size > 0);
+
+    if (word_size == 1)
+        return; // no-op
+
+    ASSERT1(word_size % 2 == 0);
+
+    switch (word_size)
+    {
+        case 2:  SwitchByteOrderOfArray<2>(array, word_count); break;
+        case 4:  SwitchByteOrderOfArray<4>(array, word_count); break;
+        case 8:  SwitchByteOrderOfArray<8>(array, word_count); break;
+        default:
+            for (Uint32 i = 0; i < word_count; ++i)
+                SwitchByteOrder(array + i*word_size, word_size);
+            break;
+    }
+}
+
+} // end of namespace Xrb
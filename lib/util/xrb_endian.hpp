@@ -32,6 +32,12 @@ enum Value
 
 } // end of namespace Endianness
 
+/// @brief Type-unsafe function for switching the byte-order of each word of a given size in an array.
+/// @details Words of size 2, 4 and 8 are done a vector register's worth at a time where the
+/// target supports it (see @ref xrb_endian.cpp ), since this is what switches whole arrays read
+/// by Serializer implementations from files of the other endianness.
+void SwitchByteOrder (Uint8 *array, Uint32 word_size, Uint32 word_count);
+
 /// Type-unsafe template functions for byte-order switching.  Use @c Word<T> instead.
 template <Uint32 word_size>
 struct WordOfSize
@@ -59,9 +65,7 @@ struct WordOfSize
     /// @param word_count The number of words to byte-order switch.
     static void SwitchByteOrder (Uint8 *array, Uint32 word_count)
     {
-        ASSERT1(array != NULL);
-        for (Uint32 i = 0; i < word_count; ++i)
-            SwitchByteOrder(&array[i*word_size]);
+        Xrb::SwitchByteOrder(array, word_size, word_count);
     }
 }; // end of struct WordOfSize<T>
 
@@ -114,21 +118,6 @@ inline void SwitchByteOrder (Uint8 *word, Uint32 word_size)
     }
 }
 
-/// Type-unsafe function for switching the byte-order of each word of a given size in an array.
-inline void SwitchByteOrder (Uint8 *array, Uint32 word_size, Uint32 word_count)
-{
-    ASSERT1(array != NULL);
-    ASSERT1(word_size > 0);
-    
-    if (word_size == 1)
-        return; // no-op
-
-    ASSERT1(word_size % 2 == 0);
-
-    for (Uint32 i = 0; i < word_count; ++i)
-        SwitchByteOrder(array+i*word_size, word_size);
-}
-
 } // end of namespace Xrb
 
 #endif // !defined(_XRB_ENDIAN_HPP_)